@@ -29,8 +29,14 @@
 typedef struct {
 	SDL_Window *window;
 	SDL_GLContext *context;
+	StateCache *stateCache;
+	PipelineState *pipelineState;
 	Program *program;
 
+	struct {
+		UniformHandle projectionMatrix, viewMatrix, modelMatrix, normalMatrix, view;
+	} uniforms;
+
 	Model *model;
 	VertexArray *vertexArray;
 	Buffer *elementsBuffer;
@@ -68,6 +74,11 @@ static void initialize(ident data) {
 	in->context = SDL_GL_CreateContext(in->window);
 	gladLoadGLLoader(SDL_GL_GetProcAddress);
 
+	$($$(Validator, sharedInstance), setEnabled, true);
+
+	in->stateCache = $(alloc(StateCache), init);
+	$(in->stateCache, makeCurrent);
+
 	in->model = $((Model *) alloc(WavefrontModel), initWithResourceName, "armor.obj");
 
 	in->view = glms_vec3_scale(glms_vec3_add(in->model->mins, in->model->maxs), .5f);
@@ -81,6 +92,12 @@ static void initialize(ident data) {
 	in->program = $(alloc(Program), initWithDescriptor, &descriptor);
 	FreeProgramDescriptor(&descriptor);
 
+	in->uniforms.projectionMatrix = $(in->program, uniformHandleForName, "projectionMatrix");
+	in->uniforms.viewMatrix = $(in->program, uniformHandleForName, "viewMatrix");
+	in->uniforms.modelMatrix = $(in->program, uniformHandleForName, "modelMatrix");
+	in->uniforms.normalMatrix = $(in->program, uniformHandleForName, "normalMatrix");
+	in->uniforms.view = $(in->program, uniformHandleForName, "view");
+
 	$(in->program, use);
 
 	$(in->program, setUniformForName, "light.position", &(vec3s) { 0, 20, 0 });
@@ -96,7 +113,10 @@ static void initialize(ident data) {
 	in->vertexArray = $(in->model, vertexArray, attributes);
 	in->elementsBuffer = $(in->model, elementsBuffer);
 
-	glEnable(GL_DEPTH_TEST);
+	PipelineDescriptor pipeline = MakePipelineDescriptor(in->program, in->vertexArray);
+	pipeline.depth.test = true;
+
+	in->pipelineState = $$(PipelineState, pipelineStateWithDescriptor, &pipeline);
 }
 
 /**
@@ -106,7 +126,7 @@ static void drawScene(ident data) {
 
 	View *in = data;
 
-	$(in->program, use);
+	$(in->pipelineState, apply);
 
 	int w, h;
 	SDL_GetWindowSize(in->window, &w, &h);
@@ -118,13 +138,12 @@ static void drawScene(ident data) {
 	const mat4s model = glms_euler_xyz(in->angles);
 	const mat3s normal = glms_mat4_pick3(glms_mat4_transpose(glms_mat4_inv(model)));
 
-	$(in->program, setUniformForName, "projectionMatrix", &projection);
-	$(in->program, setUniformForName, "viewMatrix", &view);
-	$(in->program, setUniformForName, "modelMatrix", &model);
-	$(in->program, setUniformForName, "normalMatrix", &normal);
-	$(in->program, setUniformForName, "view", &in->view);
+	$(in->program, setUniformForHandle, in->uniforms.projectionMatrix, &projection);
+	$(in->program, setUniformForHandle, in->uniforms.viewMatrix, &view);
+	$(in->program, setUniformForHandle, in->uniforms.modelMatrix, &model);
+	$(in->program, setUniformForHandle, in->uniforms.normalMatrix, &normal);
+	$(in->program, setUniformForHandle, in->uniforms.view, &in->view);
 
-	$(in->vertexArray, bind);
 	$(in->vertexArray, enableAttribute, 0);
 	$(in->vertexArray, enableAttribute, 1);
 
@@ -134,7 +153,7 @@ static void drawScene(ident data) {
 
 	glDrawElements(GL_TRIANGLES, (GLsizei) in->model->elements->count, GL_UNSIGNED_INT, 0);
 
-	assert(glGetError() == GL_NO_ERROR);
+	$($$(Validator, sharedInstance), endFrame);
 
 	SDL_GL_SwapWindow(in->window);
 }
@@ -146,10 +165,14 @@ static void destroy(ident data) {
 
 	View *in = data;
 
+	release(in->pipelineState);
 	release(in->model);
 	release(in->program);
 	release(in->vertexArray);
 	release(in->elementsBuffer);
+	release(in->stateCache);
+
+	$($$(Validator, sharedInstance), setEnabled, false);
 
 	SDL_GL_DeleteContext(in->context);
 }
@@ -172,14 +195,14 @@ int main(int argc, char *argv[]) {
 		)
 	};
 
-	CommandQueue *queue = $(alloc(CommandQueue), init);
+	CommandQueue *queue = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyBlock, 64);
 
 	$(queue, enqueue, initialize, &in);
 	$(queue, start);
 
-	while (true) {
+	$(queue, waitUntilEmpty);
 
-		$(queue, waitUntilEmpty);
+	while (true) {
 
 		SDL_Event event;
 		while (SDL_PollEvent(&event)) {
@@ -197,11 +220,15 @@ int main(int argc, char *argv[]) {
 		}
 
 		if (event.type == SDL_QUIT) {
+			$(queue, waitForFrames);
 			$(queue, enqueue, destroy, &in);
+			$(queue, waitUntilEmpty);
 			break;
 		}
 
-		$(queue, enqueue, drawScene, &in);
+		CommandList *frame = $(queue, beginFrame);
+		$(frame, appendData, drawScene, &in, sizeof(in));
+		$(queue, endFrame);
 	}
 
 	$(queue, stop);
@@ -29,8 +29,14 @@
 typedef struct {
 	SDL_Window *window;
 	SDL_GLContext *context;
+	StateCache *stateCache;
+	PipelineState *pipelineState;
 	Program *program;
 
+	struct {
+		UniformHandle projection, view, model, viewPos, lightPos;
+	} uniforms;
+
 	Model *model;
 	VertexArray *vertexArray;
 	Buffer *elementsBuffer;
@@ -67,6 +73,11 @@ static void initialize(ident data) {
 	in->context = SDL_GL_CreateContext(in->window);
 	gladLoadGLLoader(SDL_GL_GetProcAddress);
 
+	$($$(Validator, sharedInstance), setEnabled, true);
+
+	in->stateCache = $(alloc(StateCache), init);
+	$(in->stateCache, makeCurrent);
+
 	in->model = $((Model *) alloc(WavefrontModel), initWithResourceName, "armor.obj");
 
 	in->view = glms_vec3_scale(glms_vec3_add(in->model->mins, in->model->maxs), .5f);
@@ -80,6 +91,12 @@ static void initialize(ident data) {
 	in->program = $(alloc(Program), initWithDescriptor, &descriptor);
 	FreeProgramDescriptor(&descriptor);
 
+	in->uniforms.projection = $(in->program, uniformHandleForName, "projection");
+	in->uniforms.view = $(in->program, uniformHandleForName, "view");
+	in->uniforms.model = $(in->program, uniformHandleForName, "model");
+	in->uniforms.viewPos = $(in->program, uniformHandleForName, "viewPos");
+	in->uniforms.lightPos = $(in->program, uniformHandleForName, "lightPos");
+
 	const Attribute attributes[] = MakeAttributes(
 		MakeVertexAttributeVec3f(TagPosition, 0, Vertex, aPos),
 		MakeVertexAttributeVec3f(TagNormal, 1, Vertex, aNormal),
@@ -91,7 +108,10 @@ static void initialize(ident data) {
 	in->vertexArray = $(in->model, vertexArray, attributes);
 	in->elementsBuffer = $(in->model, elementsBuffer);
 
-	glEnable(GL_DEPTH_TEST);
+	PipelineDescriptor pipeline = MakePipelineDescriptor(in->program, in->vertexArray);
+	pipeline.depth.test = true;
+
+	in->pipelineState = $$(PipelineState, pipelineStateWithDescriptor, &pipeline);
 }
 
 /**
@@ -101,7 +121,7 @@ static void drawScene(ident data) {
 
 	View *in = data;
 
-	$(in->program, use);
+	$(in->pipelineState, apply);
 
 	int w, h;
 	SDL_GetWindowSize(in->window, &w, &h);
@@ -112,13 +132,12 @@ static void drawScene(ident data) {
 	const mat4s view = glms_lookat(in->view, GLMS_VEC3_ZERO, GLMS_YUP);
 	const mat4s model = glms_euler_xyz(in->angles);
 
-	$(in->program, setUniformForName, "projection", &projection);
-	$(in->program, setUniformForName, "view", &view);
-	$(in->program, setUniformForName, "model", &model);
-	$(in->program, setUniformForName, "viewPos", &in->view);
-	$(in->program, setUniformForName, "lightPos", &in->light);
+	$(in->program, setUniformForHandle, in->uniforms.projection, &projection);
+	$(in->program, setUniformForHandle, in->uniforms.view, &view);
+	$(in->program, setUniformForHandle, in->uniforms.model, &model);
+	$(in->program, setUniformForHandle, in->uniforms.viewPos, &in->view);
+	$(in->program, setUniformForHandle, in->uniforms.lightPos, &in->light);
 
-	$(in->vertexArray, bind);
 	$(in->vertexArray, enableAttribute, 0);
 	$(in->vertexArray, enableAttribute, 1);
 	$(in->vertexArray, enableAttribute, 2);
@@ -131,8 +150,7 @@ static void drawScene(ident data) {
 
 	glDrawElements(GL_TRIANGLES, (GLsizei) in->model->elements->count, GL_UNSIGNED_INT, 0);
 
-	printf("%d\n", glGetError());
-	assert(glGetError() == GL_NO_ERROR);
+	$($$(Validator, sharedInstance), endFrame);
 
 	SDL_GL_SwapWindow(in->window);
 }
@@ -144,10 +162,14 @@ static void destroy(ident data) {
 
 	View *in = data;
 
+	release(in->pipelineState);
 	release(in->model);
 	release(in->program);
 	release(in->vertexArray);
 	release(in->elementsBuffer);
+	release(in->stateCache);
+
+	$($$(Validator, sharedInstance), setEnabled, false);
 
 	SDL_GL_DeleteContext(in->context);
 }
@@ -170,14 +192,14 @@ int main(int argc, char *argv[]) {
 		)
 	};
 
-	CommandQueue *queue = $(alloc(CommandQueue), init);
+	CommandQueue *queue = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyBlock, 64);
 
 	$(queue, enqueue, initialize, &in);
 	$(queue, start);
 
-	while (true) {
+	$(queue, waitUntilEmpty);
 
-		$(queue, waitUntilEmpty);
+	while (true) {
 
 		SDL_Event event;
 		while (SDL_PollEvent(&event)) {
@@ -195,11 +217,15 @@ int main(int argc, char *argv[]) {
 		}
 
 		if (event.type == SDL_QUIT) {
+			$(queue, waitForFrames);
 			$(queue, enqueue, destroy, &in);
+			$(queue, waitUntilEmpty);
 			break;
 		}
 
-		$(queue, enqueue, drawScene, &in);
+		CommandList *frame = $(queue, beginFrame);
+		$(frame, appendData, drawScene, &in, sizeof(in));
+		$(queue, endFrame);
 	}
 
 	$(queue, stop);
@@ -25,13 +25,31 @@
 
 #include <ObjectivelyGL/Attribute.h>
 #include <ObjectivelyGL/Buffer.h>
+#include <ObjectivelyGL/Command.h>
+#include <ObjectivelyGL/CommandList.h>
+#include <ObjectivelyGL/CommandProfiler.h>
 #include <ObjectivelyGL/CommandQueue.h>
+#include <ObjectivelyGL/CommandTrace.h>
+#include <ObjectivelyGL/DrawList.h>
+#include <ObjectivelyGL/Framebuffer.h>
+#include <ObjectivelyGL/FrameGraph.h>
+#include <ObjectivelyGL/JobSystem.h>
+#include <ObjectivelyGL/MemoryTracker.h>
 #include <ObjectivelyGL/Model.h>
 #include <ObjectivelyGL/OpenGL.h>
+#include <ObjectivelyGL/PipelineState.h>
 #include <ObjectivelyGL/Program.h>
+#include <ObjectivelyGL/Readback.h>
+#include <ObjectivelyGL/Renderbuffer.h>
+#include <ObjectivelyGL/RenderTargetPool.h>
 #include <ObjectivelyGL/Shader.h>
+#include <ObjectivelyGL/StateCache.h>
+#include <ObjectivelyGL/StreamBuffer.h>
 #include <ObjectivelyGL/Texture.h>
 #include <ObjectivelyGL/Types.h>
 #include <ObjectivelyGL/UniformBuffer.h>
+#include <ObjectivelyGL/Upload.h>
+#include <ObjectivelyGL/UploadQueue.h>
+#include <ObjectivelyGL/Validator.h>
 #include <ObjectivelyGL/VertexArray.h>
 #include <ObjectivelyGL/WavefrontModel.h>
@@ -22,11 +22,59 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "Buffer.h"
+#include "StateCache.h"
 
 #define _Class _Buffer
 
+/**
+ * @return The MemoryCategory of Buffers allocated with the given target.
+ */
+static MemoryCategory _category(GLenum target) {
+
+	switch (target) {
+		case GL_ARRAY_BUFFER:
+			return MemoryCategoryVertex;
+		case GL_ELEMENT_ARRAY_BUFFER:
+			return MemoryCategoryIndex;
+		case GL_UNIFORM_BUFFER:
+			return MemoryCategoryUniform;
+		case GL_PIXEL_PACK_BUFFER:
+		case GL_PIXEL_UNPACK_BUFFER:
+			return MemoryCategoryPixel;
+		default:
+			return MemoryCategoryBuffer;
+	}
+}
+
+/**
+ * @return The size of all generations of the given Buffer, in bytes.
+ */
+static GLsizeiptr _bytes(const Buffer *self) {
+	return self->names ? self->size * (GLsizeiptr) self->generations : self->size;
+}
+
+/**
+ * @brief Accounts for the data store of the given Buffer with the shared MemoryTracker.
+ */
+static void _track(Buffer *self) {
+	if (self->size) {
+		$($$(MemoryTracker, sharedInstance), allocate, self->category, GL_NONE, _bytes(self));
+	}
+}
+
+/**
+ * @brief Removes the data store of the given Buffer from the shared MemoryTracker.
+ */
+static void _untrack(Buffer *self) {
+	if (self->size) {
+		$($$(MemoryTracker, sharedInstance), deallocate, self->category, GL_NONE, _bytes(self));
+	}
+}
+
 #pragma mark - Object
 
 /**
@@ -36,19 +84,235 @@ static void dealloc(Object *self) {
 
 	Buffer *this = (Buffer *) self;
 
-	glDeleteBuffers(1, &this->name);
+	_untrack(this);
+
+	if (this->names) {
+		for (size_t i = 0; i < this->generations; i++) {
+			if (this->fences[i]) {
+				glDeleteSync(this->fences[i]);
+			}
+		}
+
+		$$(StateCache, currentDeleteBuffers, (GLsizei) this->generations, this->names);
+
+		free(this->fences);
+		free(this->names);
+	} else {
+		$$(StateCache, currentDeleteBuffers, 1, &this->name);
+	}
+
+	free(this->shadow);
+
+	release(this->dirty);
 
 	super(Object, self, dealloc);
 }
 
 #pragma mark - Buffer
 
+/**
+ * @brief Waits for the GPU to release the given generation.
+ */
+static void _waitForGeneration(Buffer *self, size_t generation) {
+
+	GLsync fence = self->fences[generation];
+	if (fence) {
+
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED) {
+			self->stalls++;
+
+			do {
+				status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (status == GL_TIMEOUT_EXPIRED);
+		}
+
+		assert(status != GL_WAIT_FAILED);
+
+		glDeleteSync(fence);
+		self->fences[generation] = NULL;
+	}
+}
+
+/**
+ * @brief Advances to and binds the next generation, carrying forward the contents outside of the
+ * range about to be written, and then fences the current generation.
+ */
+static void _advanceGeneration(Buffer *self, const BufferSubData *data) {
+
+	const size_t prev = self->generation;
+	const size_t next = (prev + 1) % self->generations;
+
+	_waitForGeneration(self, next);
+
+	const GLsizeiptr end = data->offset + data->size;
+
+	if (HasDirectStateAccess()) {
+
+		if (data->offset > 0) {
+			glCopyNamedBufferSubData(self->names[prev], self->names[next], 0, 0, data->offset);
+		}
+
+		if (end < self->size) {
+			glCopyNamedBufferSubData(self->names[prev], self->names[next], end, end, self->size - end);
+		}
+
+	} else if (data->offset > 0 || end < self->size) {
+
+		$$(StateCache, currentBindBuffer, GL_COPY_READ_BUFFER, self->names[prev]);
+		$$(StateCache, currentBindBuffer, GL_COPY_WRITE_BUFFER, self->names[next]);
+
+		if (data->offset > 0) {
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, data->offset);
+		}
+
+		if (end < self->size) {
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, end, end, self->size - end);
+		}
+
+		$$(StateCache, currentBindBuffer, GL_COPY_READ_BUFFER, 0);
+		$$(StateCache, currentBindBuffer, GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	// the fence must follow the copies, which read the current generation
+
+	assert(self->fences[prev] == NULL);
+	self->fences[prev] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	self->generation = next;
+	self->name = self->names[next];
+
+	$(self, bind, data->target);
+}
+
+/**
+ * @brief Marks the given range of the shadow copy dirty, merging it with any overlapping or
+ * adjacent dirty ranges.
+ */
+static void _markDirty(Buffer *self, GLintptr offset, GLsizeiptr size) {
+
+	GLintptr start = offset, end = offset + size;
+
+	size_t i = 0, j = self->dirty->count;
+	while (i < j) {
+		const size_t k = (i + j) / 2;
+		const BufferRange *range = VectorElement(self->dirty, BufferRange, k);
+		if (range->offset + range->size < start) {
+			i = k + 1;
+		} else {
+			j = k;
+		}
+	}
+
+	for (j = i; j < self->dirty->count; j++) {
+		const BufferRange *range = VectorElement(self->dirty, BufferRange, j);
+		if (range->offset > end) {
+			break;
+		}
+
+		start = min(start, range->offset);
+		end = max(end, range->offset + range->size);
+	}
+
+	const BufferRange range = { .offset = start, .size = end - start };
+
+	if (i == j) {
+		$(self->dirty, insertElementAtIndex, (const ident) &range, i);
+	} else {
+		*VectorElement(self->dirty, BufferRange, i) = range;
+		while (--j > i) {
+			$(self->dirty, removeElementAtIndex, j);
+		}
+	}
+}
+
 /**
  * @fn void Buffer::bind(const Buffer *self, GLenum target)
  * @memberof Buffer
  */
 static void bind(const Buffer *self, GLenum target) {
-	glBindBuffer(target, self->name);
+	$$(StateCache, currentBindBuffer, target, self->name);
+}
+
+/**
+ * @fn size_t Buffer::commit(Buffer *self, GLenum target)
+ * @memberof Buffer
+ */
+static size_t commit(Buffer *self, GLenum target) {
+
+	assert(self->shadow);
+
+	if (self->dirty->count == 0) {
+		return 0;
+	}
+
+	size_t count = 1;
+	GLsizeiptr bytes = 0;
+
+	BufferRange *ranges = (BufferRange *) self->dirty->elements;
+	for (size_t i = 1; i < self->dirty->count; i++) {
+
+		BufferRange *prev = &ranges[count - 1];
+		const BufferRange *range = &ranges[i];
+
+		if (range->offset - (prev->offset + prev->size) < BUFFER_UPLOAD_COST) {
+			prev->size = range->offset + range->size - prev->offset;
+		} else {
+			bytes += prev->size;
+			ranges[count++] = *range;
+		}
+	}
+
+	bytes += ranges[count - 1].size;
+
+	if (bytes + (GLsizeiptr) count * BUFFER_UPLOAD_COST >= self->size + BUFFER_UPLOAD_COST) {
+		ranges[0] = (BufferRange) { .offset = 0, .size = self->size };
+		count = 1;
+	}
+
+	switch (self->strategy) {
+		case BufferUpdateSubData:
+			break;
+
+		// orphaning discards the data store, so the entire shadow copy is uploaded at once
+		case BufferUpdateOrphan:
+			ranges[0] = (BufferRange) { .offset = 0, .size = self->size };
+			count = 1;
+			break;
+
+		// each write advances a generation, so the dirty ranges are spanned by a single write
+		case BufferUpdateRoundRobin:
+		case BufferUpdateUnsynchronized:
+			ranges[0].size = ranges[count - 1].offset + ranges[count - 1].size - ranges[0].offset;
+			count = 1;
+			break;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		$(self, writeSubData, &(const BufferSubData) {
+			.target = target,
+			.offset = ranges[i].offset,
+			.size = ranges[i].size,
+			.data = self->shadow + ranges[i].offset
+		});
+	}
+
+	$(self->dirty, removeAllElements);
+
+	return count;
+}
+
+/**
+ * @fn void Buffer::flushMappedRange(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length)
+ * @memberof Buffer
+ */
+static void flushMappedRange(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length) {
+
+	if (HasDirectStateAccess()) {
+		glFlushMappedNamedBufferRange(self->name, offset, length);
+	} else {
+		glFlushMappedBufferRange(target, offset, length);
+	}
 }
 
 /**
@@ -59,7 +323,13 @@ static Buffer *init(Buffer *self) {
 
 	self = (Buffer *) super(Object, self, init);
 	if (self) {
-		glGenBuffers(1, &self->name);
+
+		if (HasDirectStateAccess()) {
+			glCreateBuffers(1, &self->name);
+		} else {
+			glGenBuffers(1, &self->name);
+		}
+
 		if (self->name) {
 
 		} else {
@@ -78,19 +348,177 @@ static Buffer *initWithData(Buffer *self, const BufferData *data) {
 
 	self = $(self, init);
 	if (self) {
-		$(self, bind, data->target);
+
+		if (HasDirectStateAccess() == false) {
+			$(self, bind, data->target);
+		}
+
 		$(self, writeData, data);
 	}
 
 	return self;
 }
 
+/**
+ * @fn Buffer *Buffer::initWithShadow(Buffer *self, const BufferData *data)
+ * @memberof Buffer
+ */
+static Buffer *initWithShadow(Buffer *self, const BufferData *data) {
+
+	self = $(self, init);
+	if (self) {
+		self->dirty = $(alloc(Vector), initWithSize, sizeof(BufferRange));
+		assert(self->dirty);
+
+		self->shadow = calloc(1, max(data->size, 1));
+		assert(self->shadow);
+
+		if (HasDirectStateAccess() == false) {
+			$(self, bind, data->target);
+		}
+
+		$(self, writeData, data);
+	}
+
+	return self;
+}
+
+/**
+ * @fn Buffer *Buffer::initWithStorage(Buffer *self, const BufferStorage *storage)
+ * @memberof Buffer
+ */
+static Buffer *initWithStorage(Buffer *self, const BufferStorage *storage) {
+
+	self = $(self, init);
+	if (self) {
+
+		if (glBufferStorage == NULL) {
+			return release(self);
+		}
+
+		if (HasDirectStateAccess()) {
+			glNamedBufferStorage(self->name, storage->size, storage->data, storage->flags);
+		} else {
+			$(self, bind, storage->target);
+			glBufferStorage(storage->target, storage->size, storage->data, storage->flags);
+		}
+
+		self->size = storage->size;
+		self->usage = GL_NONE;
+		self->flags = storage->flags;
+		self->category = _category(storage->target);
+
+		_track(self);
+	}
+
+	return self;
+}
+
+/**
+ * @fn ident Buffer::mapRange(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+ * @memberof Buffer
+ */
+static ident mapRange(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+
+	assert(offset + length <= self->size);
+
+	if (HasDirectStateAccess()) {
+		return glMapNamedBufferRange(self->name, offset, length, access);
+	}
+
+	return glMapBufferRange(target, offset, length, access);
+}
+
+/**
+ * @fn void Buffer::setUpdateStrategy(Buffer *self, GLenum target, BufferUpdateStrategy strategy, size_t generations)
+ * @memberof Buffer
+ */
+static void setUpdateStrategy(Buffer *self, GLenum target, BufferUpdateStrategy strategy, size_t generations) {
+
+	assert(self->flags == 0 && self->usage != GL_NONE);
+
+	_untrack(self);
+
+	if (self->names) {
+		for (size_t i = 0; i < self->generations; i++) {
+			if (self->fences[i]) {
+				glDeleteSync(self->fences[i]);
+			}
+			if (i != self->generation) {
+				$$(StateCache, currentDeleteBuffers, 1, &self->names[i]);
+			}
+		}
+
+		free(self->fences);
+		free(self->names);
+
+		self->fences = NULL;
+		self->names = NULL;
+	}
+
+	self->strategy = strategy;
+	self->generations = 1;
+	self->generation = 0;
+
+	switch (strategy) {
+		case BufferUpdateRoundRobin:
+		case BufferUpdateUnsynchronized:
+			assert(generations > 1);
+
+			self->generations = generations;
+
+			self->names = calloc(generations, sizeof(GLuint));
+			assert(self->names);
+
+			self->fences = calloc(generations, sizeof(GLsync));
+			assert(self->fences);
+
+			self->names[0] = self->name;
+
+			if (HasDirectStateAccess()) {
+				glCreateBuffers((GLsizei) generations - 1, self->names + 1);
+
+				for (size_t i = 1; i < generations; i++) {
+					glNamedBufferData(self->names[i], self->size, NULL, self->usage);
+				}
+			} else {
+				glGenBuffers((GLsizei) generations - 1, self->names + 1);
+
+				for (size_t i = 1; i < generations; i++) {
+					$$(StateCache, currentBindBuffer, target, self->names[i]);
+					glBufferData(target, self->size, NULL, self->usage);
+				}
+
+				$(self, bind, target);
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	_track(self);
+}
+
 /**
  * @fn void Buffer::unbind(Buffer *self, GLenum target)
  * @memberof Buffer
  */
 static void unbind(const Buffer *self, GLenum target) {
-	glBindBuffer(target, 0);
+	$$(StateCache, currentBindBuffer, target, 0);
+}
+
+/**
+ * @fn _Bool Buffer::unmap(const Buffer *self, GLenum target)
+ * @memberof Buffer
+ */
+static _Bool unmap(const Buffer *self, GLenum target) {
+
+	if (HasDirectStateAccess()) {
+		return glUnmapNamedBuffer(self->name) == GL_TRUE;
+	}
+
+	return glUnmapBuffer(target) == GL_TRUE;
 }
 
 /**
@@ -99,10 +527,72 @@ static void unbind(const Buffer *self, GLenum target) {
  */
 static void writeData(Buffer *self, const BufferData *data) {
 
-	glBufferData(data->target, data->size, data->data, data->usage);
+	assert(self->flags == 0 && (self->usage != GL_NONE || self->size == 0));
+
+	_untrack(self);
+
+	if (self->names) {
+		for (size_t i = 0; i < self->generations; i++) {
+			if (self->fences[i]) {
+				glDeleteSync(self->fences[i]);
+				self->fences[i] = NULL;
+			}
+			if (i != self->generation) {
+				if (HasDirectStateAccess()) {
+					glNamedBufferData(self->names[i], data->size, NULL, data->usage);
+				} else {
+					$$(StateCache, currentBindBuffer, data->target, self->names[i]);
+					glBufferData(data->target, data->size, NULL, data->usage);
+				}
+			}
+		}
+
+		if (HasDirectStateAccess() == false) {
+			$(self, bind, data->target);
+		}
+	}
+
+	if (HasDirectStateAccess()) {
+		glNamedBufferData(self->name, data->size, data->data, data->usage);
+	} else {
+		glBufferData(data->target, data->size, data->data, data->usage);
+	}
+
+	if (self->shadow) {
+		if (data->size != self->size) {
+			self->shadow = realloc(self->shadow, max(data->size, 1));
+			assert(self->shadow);
+		}
+
+		if (data->data) {
+			memcpy(self->shadow, data->data, data->size);
+		} else {
+			memset(self->shadow, 0, data->size);
+		}
+
+		$(self->dirty, removeAllElements);
+	}
 
 	self->size = data->size;
 	self->usage = data->usage;
+	self->category = _category(data->target);
+
+	_track(self);
+}
+
+/**
+ * @fn void Buffer::writeShadow(Buffer *self, GLintptr offset, GLsizeiptr size, const GLvoid *data)
+ * @memberof Buffer
+ */
+static void writeShadow(Buffer *self, GLintptr offset, GLsizeiptr size, const GLvoid *data) {
+
+	assert(self->shadow);
+	assert(offset + size <= self->size);
+
+	if (size > 0) {
+		memcpy(self->shadow + offset, data, size);
+		_markDirty(self, offset, size);
+	}
 }
 
 /**
@@ -110,7 +600,50 @@ static void writeData(Buffer *self, const BufferData *data) {
  * @memberof Buffer
  */
 static void writeSubData(Buffer *self, const BufferSubData *data) {
-	glBufferSubData(data->target, data->offset, data->size, data->data);
+
+	assert(data->offset + data->size <= self->size);
+
+	if (self->shadow && self->shadow + data->offset != data->data) {
+		memcpy(self->shadow + data->offset, data->data, data->size);
+	}
+
+	switch (self->strategy) {
+		case BufferUpdateSubData:
+			break;
+
+		case BufferUpdateOrphan:
+			if (HasDirectStateAccess()) {
+				glNamedBufferData(self->name, self->size, NULL, self->usage);
+			} else {
+				glBufferData(data->target, self->size, NULL, self->usage);
+			}
+			break;
+
+		case BufferUpdateRoundRobin:
+			_advanceGeneration(self, data);
+			break;
+
+		case BufferUpdateUnsynchronized: {
+			_advanceGeneration(self, data);
+
+			const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+
+			ident mapping = $(self, mapRange, data->target, data->offset, data->size, access);
+			if (mapping) {
+				memcpy(mapping, data->data, data->size);
+				if ($(self, unmap, data->target)) {
+					return;
+				}
+			}
+		}
+			break;
+	}
+
+	if (HasDirectStateAccess()) {
+		glNamedBufferSubData(self->name, data->offset, data->size, data->data);
+	} else {
+		glBufferSubData(data->target, data->offset, data->size, data->data);
+	}
 }
 
 #pragma mark - Class lifecycle
@@ -123,10 +656,18 @@ static void initialize(Class *clazz) {
 	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
 
 	((BufferInterface *) clazz->interface)->bind = bind;
+	((BufferInterface *) clazz->interface)->commit = commit;
+	((BufferInterface *) clazz->interface)->flushMappedRange = flushMappedRange;
 	((BufferInterface *) clazz->interface)->init = init;
 	((BufferInterface *) clazz->interface)->initWithData = initWithData;
+	((BufferInterface *) clazz->interface)->initWithShadow = initWithShadow;
+	((BufferInterface *) clazz->interface)->initWithStorage = initWithStorage;
+	((BufferInterface *) clazz->interface)->mapRange = mapRange;
+	((BufferInterface *) clazz->interface)->setUpdateStrategy = setUpdateStrategy;
 	((BufferInterface *) clazz->interface)->unbind = unbind;
+	((BufferInterface *) clazz->interface)->unmap = unmap;
 	((BufferInterface *) clazz->interface)->writeData = writeData;
+	((BufferInterface *) clazz->interface)->writeShadow = writeShadow;
 	((BufferInterface *) clazz->interface)->writeSubData = writeSubData;
 }
 
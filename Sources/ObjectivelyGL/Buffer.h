@@ -24,7 +24,9 @@
 #pragma once
 
 #include <Objectively/Object.h>
+#include <Objectively/Vector.h>
 
+#include <ObjectivelyGL/MemoryTracker.h>
 #include <ObjectivelyGL/Types.h>
 
 /**
@@ -36,6 +38,66 @@
 typedef struct Buffer Buffer;
 typedef struct BufferInterface BufferInterface;
 
+/**
+ * @brief The default count of generations for generational BufferUpdateStrategies.
+ */
+#define BUFFER_DEFAULT_GENERATIONS 3
+
+/**
+ * @brief The estimated fixed cost of an upload, in bytes.
+ * @details When committing a shadowed Buffer, dirty ranges separated by fewer bytes than this are
+ * uploaded together, and the whole Buffer is uploaded at once if that costs less than uploading
+ * each dirty range.
+ */
+#define BUFFER_UPLOAD_COST 1024
+
+/**
+ * @brief A range of a Buffer's data store.
+ */
+typedef struct {
+
+	/**
+	 * @brief The offset of the range, in bytes.
+	 */
+	GLintptr offset;
+
+	/**
+	 * @brief The size of the range, in bytes.
+	 */
+	GLsizeiptr size;
+
+} BufferRange;
+
+/**
+ * @brief Strategies for Buffer::writeSubData.
+ */
+typedef enum {
+
+	/**
+	 * @brief Write with `glBufferSubData`, letting the driver synchronize with the GPU.
+	 */
+	BufferUpdateSubData,
+
+	/**
+	 * @brief Orphan the data store with `glBufferData` before each write.
+	 * @remarks The contents outside of the written range are undefined after each write, so this
+	 * suits Buffers that are rewritten in their entirety.
+	 */
+	BufferUpdateOrphan,
+
+	/**
+	 * @brief Cycle over generations of the data store, each with its own name, writing the next
+	 * generation with `glBufferSubData` once its fence has signaled.
+	 */
+	BufferUpdateRoundRobin,
+
+	/**
+	 * @brief As BufferUpdateRoundRobin, but write through an unsynchronized mapping.
+	 */
+	BufferUpdateUnsynchronized,
+
+} BufferUpdateStrategy;
+
 /**
  * @brief BufferData is used to initialize or alter the storage and data of a Buffer.
  */
@@ -69,6 +131,40 @@ typedef struct {
 #define MakeBufferData(target, size, data, usage) \
 	(BufferData) { (target), (size), (const GLvoid *) (data), (usage) }
 
+/**
+ * @brief BufferStorage is used to initialize a Buffer with immutable storage.
+ * @see glBufferStorage
+ */
+typedef struct {
+
+	/**
+	 * @brief The target.
+	 */
+	GLenum target;
+
+	/**
+	 * @brief The size of the Buffer's data store, in bytes.
+	 */
+	GLsizeiptr size;
+
+	/**
+	 * @brief The initial data, or `NULL`.
+	 */
+	const GLvoid *data;
+
+	/**
+	 * @brief The storage flags, e.g. `GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT`.
+	 */
+	GLbitfield flags;
+
+} BufferStorage;
+
+/**
+ * @brief Creates a BufferStorage with the specified parameters.
+ */
+#define MakeBufferStorage(target, size, data, flags) \
+	(BufferStorage) { (target), (size), (const GLvoid *) (data), (flags) }
+
 /**
  * @brief BufferSubData is used to modify the data of a Buffer.
  */
@@ -120,7 +216,8 @@ struct Buffer {
 	BufferInterface *interface;
 
 	/**
-	 * @brief The Buffer name.
+	 * @brief The Buffer name, which is that of the current generation for generational
+	 * BufferUpdateStrategies.
 	 */
 	GLuint name;
 
@@ -130,9 +227,56 @@ struct Buffer {
 	GLsizeiptr size;
 
 	/**
-	 * @brief The usage hint.
+	 * @brief The usage hint, or `GL_NONE` if the Buffer's data store is immutable.
 	 */
 	GLenum usage;
+
+	/**
+	 * @brief The MemoryCategory, derived from the target the data store was allocated with.
+	 */
+	MemoryCategory category;
+
+	/**
+	 * @brief The storage flags, if the Buffer's data store is immutable.
+	 */
+	GLbitfield flags;
+
+	/**
+	 * @brief The BufferUpdateStrategy.
+	 */
+	BufferUpdateStrategy strategy;
+
+	/**
+	 * @brief The count of generations, and the index of the current generation.
+	 */
+	size_t generations, generation;
+
+	/**
+	 * @brief The names of each generation.
+	 * @private
+	 */
+	GLuint *names;
+
+	/**
+	 * @brief The fences guarding each generation.
+	 * @private
+	 */
+	GLsync *fences;
+
+	/**
+	 * @brief The count of writes that waited for the GPU to release a generation.
+	 */
+	size_t stalls;
+
+	/**
+	 * @brief The CPU shadow copy of the data store, if any.
+	 */
+	GLubyte *shadow;
+
+	/**
+	 * @brief The dirty ranges of the shadow copy, sorted and disjoint.
+	 */
+	Vector *dirty;
 };
 
 /**
@@ -154,6 +298,32 @@ struct BufferInterface {
 	 */
 	void (*bind)(const Buffer *self, GLenum target);
 
+	/**
+	 * @fn size_t Buffer::commit(Buffer *self, GLenum target)
+	 * @brief Uploads the dirty ranges of this Buffer's shadow copy.
+	 * @param self The Buffer, which must be bound to `target`.
+	 * @param target The target.
+	 * @return The count of uploads made.
+	 * @remarks Uploads are made with _writeSubData_, and so follow the BufferUpdateStrategy. Only
+	 * BufferUpdateSubData makes an upload per dirty range: BufferUpdateOrphan uploads the entire
+	 * shadow copy, and generational strategies upload a single range spanning all dirty ranges.
+	 * @see BUFFER_UPLOAD_COST
+	 * @memberof Buffer
+	 */
+	size_t (*commit)(Buffer *self, GLenum target);
+
+	/**
+	 * @fn void Buffer::flushMappedRange(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length)
+	 * @brief Flushes modifications to a range of this Buffer's mapping.
+	 * @param self The Buffer.
+	 * @param target The target this Buffer is bound to.
+	 * @param offset The offset of the modified range, relative to the start of the mapping.
+	 * @param length The length of the modified range, in bytes.
+	 * @remarks The mapping must have been created with `GL_MAP_FLUSH_EXPLICIT_BIT`.
+	 * @memberof Buffer
+	 */
+	void (*flushMappedRange)(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length);
+
 	/**
 	 * @fn Buffer *Buffer::init(Buffer *self)
 	 * @brief Initializes this Buffer.
@@ -169,10 +339,65 @@ struct BufferInterface {
 	 * @param self The Buffer.
 	 * @param data The BufferData.
 	 * @return The initialized Buffer, or `NULL` on error.
+	 * @remarks Where Direct State Access is available, the Buffer is written without binding it.
+	 * Otherwise, it is left bound to the data's target.
 	 * @memberof Buffer
 	 */
 	Buffer *(*initWithData)(Buffer *self, const BufferData *data);
 
+	/**
+	 * @fn Buffer *Buffer::initWithShadow(Buffer *self, const BufferData *data)
+	 * @brief Initializes this Buffer with a CPU shadow copy of its data store.
+	 * @param self The Buffer.
+	 * @param data The BufferData.
+	 * @return The initialized Buffer, or `NULL` on error.
+	 * @remarks Writes made with _writeShadow_ are batched in the shadow copy until _commit_.
+	 * @memberof Buffer
+	 */
+	Buffer *(*initWithShadow)(Buffer *self, const BufferData *data);
+
+	/**
+	 * @fn Buffer *Buffer::initWithStorage(Buffer *self, const BufferStorage *storage)
+	 * @brief Initializes this Buffer with immutable storage.
+	 * @param self The Buffer.
+	 * @param storage The BufferStorage.
+	 * @return The initialized Buffer, or `NULL` on error.
+	 * @remarks Immutable storage may not be reallocated with _writeData_, but may be mapped
+	 * persistently. This requires `glBufferStorage`, from OpenGL 4.4 or `ARB_buffer_storage`.
+	 * @memberof Buffer
+	 */
+	Buffer *(*initWithStorage)(Buffer *self, const BufferStorage *storage);
+
+	/**
+	 * @fn ident Buffer::mapRange(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+	 * @brief Maps a range of this Buffer's data store into client memory.
+	 * @param self The Buffer.
+	 * @param target The target this Buffer is bound to.
+	 * @param offset The offset of the range, in bytes.
+	 * @param length The length of the range, in bytes.
+	 * @param access The access flags, e.g. `GL_MAP_WRITE_BIT`. Add `GL_MAP_INVALIDATE_RANGE_BIT` or
+	 * `GL_MAP_INVALIDATE_BUFFER_BIT` to discard the previous contents, and
+	 * `GL_MAP_UNSYNCHRONIZED_BIT` to skip waiting for pending GPU reads of the range.
+	 * @return The mapped range, or `NULL` on error.
+	 * @memberof Buffer
+	 */
+	ident (*mapRange)(const Buffer *self, GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+
+	/**
+	 * @fn void Buffer::setUpdateStrategy(Buffer *self, GLenum target, BufferUpdateStrategy strategy, size_t generations)
+	 * @brief Sets the strategy used by _writeSubData_.
+	 * @param self The Buffer, which must be bound to `target`.
+	 * @param target The target.
+	 * @param strategy The BufferUpdateStrategy.
+	 * @param generations The count of generations for generational strategies, e.g.
+	 * `BUFFER_DEFAULT_GENERATIONS`.
+	 * @remarks The Buffer's data store must be mutable. VertexArrays capture the Buffer name
+	 * when they are initialized, so generational strategies suit Buffers that are bound each time
+	 * they are used, such as UniformBuffers.
+	 * @memberof Buffer
+	 */
+	void (*setUpdateStrategy)(Buffer *self, GLenum target, BufferUpdateStrategy strategy, size_t generations);
+
 	/**
 	 * @fn void Buffer::unbind(const Buffer *self, GLenum target)
 	 * @brief Unbinds this Buffer from the specified target.
@@ -182,6 +407,17 @@ struct BufferInterface {
 	 */
 	void (*unbind)(const Buffer *self, GLenum target);
 
+	/**
+	 * @fn _Bool Buffer::unmap(const Buffer *self, GLenum target)
+	 * @brief Unmaps this Buffer's data store.
+	 * @param self The Buffer.
+	 * @param target The target this Buffer is bound to.
+	 * @return True on success, false if the data store was corrupted while mapped, in which case
+	 * its contents are undefined and must be rewritten.
+	 * @memberof Buffer
+	 */
+	_Bool (*unmap)(const Buffer *self, GLenum target);
+
 	/**
 	 * @fn void Buffer::writeData(const Buffer *self, const BufferData *data)
 	 * @brief Writes data to this Buffer's data store, (re) allocating storage.
@@ -192,10 +428,23 @@ struct BufferInterface {
 	 */
 	void (*writeData)(Buffer *self, const BufferData *data);
 
+	/**
+	 * @fn void Buffer::writeShadow(Buffer *self, GLintptr offset, GLsizeiptr size, const GLvoid *data)
+	 * @brief Writes data to this Buffer's shadow copy, marking the range dirty.
+	 * @param self The Buffer.
+	 * @param offset The offset, in bytes.
+	 * @param size The size of the data, in bytes.
+	 * @param data The data.
+	 * @memberof Buffer
+	 */
+	void (*writeShadow)(Buffer *self, GLintptr offset, GLsizeiptr size, const GLvoid *data);
+
 	/**
 	 * @fn void Buffer::writeSubData(const Buffer *self, const BufferData *data)
 	 * @brief Writes sub-data to this Buffer's data store.
-	 * @details The specified data must fit within this Buffer.
+	 * @details The specified data must fit within this Buffer. The write is made according to the
+	 * Buffer's BufferUpdateStrategy. Generational strategies advance to, and bind, the next
+	 * generation, carrying forward the contents outside of the written range.
 	 * @param self The Buffer.
 	 * @param data The BufferSubData.
 	 * @memberof Buffer
@@ -0,0 +1,55 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <ObjectivelyGL/Types.h>
+
+/**
+ * @file
+ * @brief Commands are units of work executed by CommandQueues and CommandLists.
+ */
+
+/**
+ * @brief A Command is a Consumer and its user data.
+ */
+typedef struct Command {
+
+	/**
+	 * @brief The Consumer.
+	 */
+	Consumer consumer;
+
+	/**
+	 * @brief The user data.
+	 */
+	ident data;
+
+} Command;
+
+/**
+ * @return The current time of the monotonic clock, in nanoseconds.
+ * @remarks This is the clock used to timestamp Commands.
+ */
+OBJECTIVELYGL_EXPORT uint64_t CommandTime(void);
@@ -0,0 +1,215 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CommandList.h"
+
+#define _Class _CommandList
+
+/**
+ * @brief Copied Command data is aligned to this boundary within the CommandList's storage.
+ */
+#define COMMAND_LIST_DATA_ALIGNMENT 16
+
+/**
+ * @brief A recorded Command and the offset of its copied data, or `-1`.
+ */
+typedef struct {
+	Command command;
+	ssize_t offset;
+} CommandListEntry;
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	CommandList *this = (CommandList *) self;
+
+	release(this->commands);
+	release(this->storage);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - CommandList
+
+/**
+ * @fn void CommandList::append(CommandList *self, Consumer consumer, ident data)
+ * @memberof CommandList
+ */
+static void append(CommandList *self, Consumer consumer, ident data) {
+
+	assert(consumer);
+
+	CommandListEntry entry = {
+		.command = {
+			.consumer = consumer,
+			.data = data
+		},
+		.offset = -1
+	};
+
+	$(self->commands, addElement, &entry);
+}
+
+/**
+ * @fn void CommandList::appendData(CommandList *self, Consumer consumer, const ident data, size_t size)
+ * @memberof CommandList
+ */
+static void appendData(CommandList *self, Consumer consumer, const ident data, size_t size) {
+
+	assert(consumer);
+
+	Data *storage = (Data *) self->storage;
+
+	const size_t offset = (storage->length + COMMAND_LIST_DATA_ALIGNMENT - 1) & ~(COMMAND_LIST_DATA_ALIGNMENT - 1);
+
+	$(self->storage, setLength, offset);
+	$(self->storage, appendBytes, data, size);
+
+	CommandListEntry entry = {
+		.command = {
+			.consumer = consumer,
+		},
+		.offset = (ssize_t) offset
+	};
+
+	$(self->commands, addElement, &entry);
+}
+
+/**
+ * @fn size_t CommandList::count(const CommandList *self)
+ * @memberof CommandList
+ */
+static size_t count(const CommandList *self) {
+	return self->commands->count;
+}
+
+/**
+ * @fn void CommandList::execute(CommandList *self)
+ * @memberof CommandList
+ */
+static void execute(CommandList *self) {
+
+	self->started = CommandTime();
+
+	if (self->trace) {
+		$(self->trace, recordFrame, self->frame);
+	}
+
+	uint8_t *storage = ((Data *) self->storage)->bytes;
+
+	const CommandListEntry *entry = self->commands->elements;
+	for (size_t i = 0; i < self->commands->count; i++, entry++) {
+
+		ident data = entry->offset == -1 ? entry->command.data : storage + entry->offset;
+
+		if (self->trace) {
+			$(self->trace, record, entry->command.consumer, data);
+		}
+
+		entry->command.consumer(data);
+	}
+
+	self->trace = NULL;
+	self->finished = CommandTime();
+}
+
+/**
+ * @fn CommandList *CommandList::init(CommandList *self)
+ * @memberof CommandList
+ */
+static CommandList *init(CommandList *self) {
+
+	self = (CommandList *) super(Object, self, init);
+	if (self) {
+		self->commands = $(alloc(Vector), initWithSize, sizeof(CommandListEntry));
+		assert(self->commands);
+
+		self->storage = $(alloc(MutableData), init);
+		assert(self->storage);
+	}
+
+	return self;
+}
+
+/**
+ * @fn void CommandList::reset(CommandList *self)
+ * @memberof CommandList
+ */
+static void reset(CommandList *self) {
+
+	$(self->commands, removeAllElements);
+	$(self->storage, setLength, 0);
+
+	self->submitted = self->started = self->finished = 0;
+	self->trace = NULL;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((CommandListInterface *) clazz->interface)->append = append;
+	((CommandListInterface *) clazz->interface)->appendData = appendData;
+	((CommandListInterface *) clazz->interface)->count = count;
+	((CommandListInterface *) clazz->interface)->execute = execute;
+	((CommandListInterface *) clazz->interface)->init = init;
+	((CommandListInterface *) clazz->interface)->reset = reset;
+}
+
+/**
+ * @fn Class *CommandList::_CommandList(void)
+ * @memberof CommandList
+ */
+Class *_CommandList(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "CommandList",
+			.superclass = _Object(),
+			.instanceSize = sizeof(CommandList),
+			.interfaceOffset = offsetof(CommandList, interface),
+			.interfaceSize = sizeof(CommandListInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
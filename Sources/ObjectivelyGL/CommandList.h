@@ -0,0 +1,169 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/MutableData.h>
+#include <Objectively/Vector.h>
+
+#include <ObjectivelyGL/CommandTrace.h>
+
+/**
+ * @file
+ * @brief CommandLists record Commands on one thread for execution on another.
+ * @details CommandLists are not thread safe. Typically, a producer thread records a frame's
+ * Commands into a CommandList, and submits it to a CommandQueue for execution.
+ * @see CommandQueue::beginFrame(CommandQueue *)
+ */
+
+typedef struct CommandList CommandList;
+typedef struct CommandListInterface CommandListInterface;
+
+/**
+ * @brief The CommandList type.
+ * @extends Object
+ */
+struct CommandList {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	CommandListInterface *interface;
+
+	/**
+	 * @brief The recorded Commands.
+	 * @private
+	 */
+	Vector *commands;
+
+	/**
+	 * @brief Storage for Command data copied with `appendData`.
+	 * @private
+	 */
+	MutableData *storage;
+
+	/**
+	 * @brief The frame number, if this CommandList was acquired with `CommandQueue::beginFrame`.
+	 */
+	uint64_t frame;
+
+	/**
+	 * @brief The times at which this CommandList was submitted, started and finished executing.
+	 * @see CommandTime()
+	 */
+	uint64_t submitted, started, finished;
+
+	/**
+	 * @brief The CommandQueue this CommandList was acquired from, if any.
+	 * @private
+	 */
+	ident queue;
+
+	/**
+	 * @brief The CommandTrace to record the next execution to, if any.
+	 * @private
+	 */
+	CommandTrace *trace;
+};
+
+/**
+ * @brief The CommandList interface.
+ */
+struct CommandListInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn void CommandList::append(CommandList *self, Consumer consumer, ident data)
+	 * @brief Appends a Command with the given Consumer and data to this CommandList.
+	 * @param self The CommandList.
+	 * @param consumer The Consumer.
+	 * @param data User data, which must remain valid until this CommandList is executed.
+	 * @memberof CommandList
+	 */
+	void (*append)(CommandList *self, Consumer consumer, ident data);
+
+	/**
+	 * @fn void CommandList::appendData(CommandList *self, Consumer consumer, const ident data, size_t size)
+	 * @brief Appends a Command with the given Consumer and a copy of the given data.
+	 * @details The copy is owned by this CommandList, and is valid until it is reset. This allows
+	 * the producer to modify its own state while this CommandList is executing.
+	 * @param self The CommandList.
+	 * @param consumer The Consumer.
+	 * @param data The data to copy.
+	 * @param size The size of data, in bytes.
+	 * @memberof CommandList
+	 */
+	void (*appendData)(CommandList *self, Consumer consumer, const ident data, size_t size);
+
+	/**
+	 * @fn size_t CommandList::count(const CommandList *self)
+	 * @param self The CommandList.
+	 * @return The count of Commands recorded in this CommandList.
+	 * @memberof CommandList
+	 */
+	size_t (*count)(const CommandList *self);
+
+	/**
+	 * @fn void CommandList::execute(CommandList *self)
+	 * @brief Executes the Commands recorded in this CommandList, in order, on the calling thread.
+	 * @param self The CommandList.
+	 * @memberof CommandList
+	 */
+	void (*execute)(CommandList *self);
+
+	/**
+	 * @fn CommandList *CommandList::init(CommandList *self)
+	 * @brief Initializes this CommandList.
+	 * @param self The CommandList.
+	 * @return The initialized CommandList, or `NULL` on error.
+	 * @memberof CommandList
+	 */
+	CommandList *(*init)(CommandList *self);
+
+	/**
+	 * @fn void CommandList::reset(CommandList *self)
+	 * @brief Removes all Commands and copied data from this CommandList, retaining its storage.
+	 * @param self The CommandList.
+	 * @memberof CommandList
+	 */
+	void (*reset)(CommandList *self);
+};
+
+/**
+ * @fn Class *CommandList::_CommandList(void)
+ * @brief The CommandList archetype.
+ * @return The CommandList Class.
+ * @memberof CommandList
+ */
+OBJECTIVELYGL_EXPORT Class *_CommandList(void);
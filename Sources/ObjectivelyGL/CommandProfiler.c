@@ -0,0 +1,560 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CommandProfiler.h"
+
+#define _Class _CommandProfiler
+
+/**
+ * @brief Histograms are log-linear: each power of two is divided into this many buckets, for a
+ * precision of roughly six percent.
+ */
+#define COMMAND_HISTOGRAM_SUB_BUCKETS 16
+
+/**
+ * @brief The count of histogram buckets required to cover all `uint64_t` values.
+ */
+#define COMMAND_HISTOGRAM_BUCKETS ((64 - 4) * COMMAND_HISTOGRAM_SUB_BUCKETS + COMMAND_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * @brief The index of the profile for all Commands.
+ */
+#define COMMAND_PROFILE_ALL 0
+
+/**
+ * @brief The index of the profile for unlabeled Commands.
+ */
+#define COMMAND_PROFILE_UNLABELED 1
+
+/**
+ * @brief A log-linear histogram of times.
+ */
+typedef struct {
+	uint64_t buckets[COMMAND_HISTOGRAM_BUCKETS];
+	size_t count;
+	uint64_t max;
+} CommandHistogram;
+
+/**
+ * @brief The accumulated times of the Commands of a label.
+ */
+typedef struct {
+	char *name;
+	CommandHistogram wait, execute;
+	uint64_t executeTime;
+	uint64_t first, last;
+} CommandProfile;
+
+/**
+ * @brief Maps a Consumer to its CommandProfile.
+ */
+typedef struct {
+	Consumer consumer;
+	size_t profile;
+} CommandLabel;
+
+/**
+ * @brief A retained sample.
+ */
+typedef struct {
+	const char *name;
+	CommandSample sample;
+	size_t thread;
+} CommandEvent;
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	CommandProfiler *this = (CommandProfiler *) self;
+
+	CommandProfile *profile = this->profiles->elements;
+	for (size_t i = 0; i < this->profiles->count; i++, profile++) {
+		free(profile->name);
+	}
+
+	release(this->labels);
+	release(this->lock);
+	release(this->profiles);
+	release(this->samples);
+	release(this->threads);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - CommandHistogram
+
+/**
+ * @return The bucket index for the given value.
+ */
+static size_t _bucket(uint64_t value) {
+
+	if (value < COMMAND_HISTOGRAM_SUB_BUCKETS) {
+		return (size_t) value;
+	}
+
+	const int msb = 63 - __builtin_clzll(value);
+	const size_t sub = (value >> (msb - 4)) & (COMMAND_HISTOGRAM_SUB_BUCKETS - 1);
+
+	return (msb - 3) * COMMAND_HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+/**
+ * @return The largest value that falls in the given bucket.
+ */
+static uint64_t _bucketValue(size_t bucket) {
+
+	if (bucket < COMMAND_HISTOGRAM_SUB_BUCKETS) {
+		return bucket;
+	}
+
+	const int msb = (int) (bucket / COMMAND_HISTOGRAM_SUB_BUCKETS) + 3;
+	const uint64_t sub = bucket % COMMAND_HISTOGRAM_SUB_BUCKETS;
+
+	return ((COMMAND_HISTOGRAM_SUB_BUCKETS + sub + 1) << (msb - 4)) - 1;
+}
+
+/**
+ * @brief Adds the given value to the histogram.
+ */
+static void _histogramAdd(CommandHistogram *histogram, uint64_t value) {
+
+	histogram->buckets[_bucket(value)]++;
+	histogram->count++;
+	histogram->max = max(histogram->max, value);
+}
+
+/**
+ * @return The value at the given percentile of the histogram.
+ */
+static uint64_t _histogramPercentile(const CommandHistogram *histogram, double percentile) {
+
+	if (histogram->count == 0) {
+		return 0;
+	}
+
+	size_t rank = (size_t) (percentile / 100.0 * histogram->count + 0.5);
+	rank = max(rank, (size_t) 1);
+
+	size_t count = 0;
+	for (size_t i = 0; i < COMMAND_HISTOGRAM_BUCKETS; i++) {
+		count += histogram->buckets[i];
+		if (count >= rank) {
+			return min(_bucketValue(i), histogram->max);
+		}
+	}
+
+	return histogram->max;
+}
+
+#pragma mark - CommandProfiler
+
+/**
+ * @return The index of the profile with the given name, or `-1`.
+ * @remarks The caller must hold the Lock.
+ */
+static ssize_t _profileForName(const CommandProfiler *self, const char *name) {
+
+	const CommandProfile *profile = self->profiles->elements;
+	for (size_t i = 0; i < self->profiles->count; i++, profile++) {
+		if (profile->name && strcmp(profile->name, name) == 0) {
+			return (ssize_t) i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @return The index of a new profile with the given name.
+ * @remarks The caller must hold the Lock.
+ */
+static size_t _addProfile(CommandProfiler *self, const char *name) {
+
+	CommandProfile *profile = calloc(1, sizeof(CommandProfile));
+	assert(profile);
+
+	if (name) {
+		profile->name = strdup(name);
+		assert(profile->name);
+	}
+
+	$(self->profiles, addElement, profile);
+	free(profile);
+
+	return self->profiles->count - 1;
+}
+
+/**
+ * @return The index of the profile for the given Consumer.
+ * @remarks The caller must hold the Lock.
+ */
+static size_t _profileForConsumer(const CommandProfiler *self, Consumer consumer) {
+
+	const CommandLabel *label = self->labels->elements;
+	for (size_t i = 0; i < self->labels->count; i++, label++) {
+		if (label->consumer == consumer) {
+			return label->profile;
+		}
+	}
+
+	return COMMAND_PROFILE_UNLABELED;
+}
+
+/**
+ * @brief Accumulates the given sample into the given profile.
+ */
+static void _profileAdd(CommandProfile *profile, const CommandSample *sample) {
+
+	if (profile->execute.count == 0) {
+		profile->first = sample->started;
+	}
+
+	profile->first = min(profile->first, sample->started);
+	profile->last = max(profile->last, sample->finished);
+
+	const uint64_t execute = sample->finished - sample->started;
+
+	_histogramAdd(&profile->wait, sample->dequeued - sample->enqueued);
+	_histogramAdd(&profile->execute, execute);
+
+	profile->executeTime += execute;
+}
+
+/**
+ * @return The index of the calling thread.
+ * @remarks The caller must hold the Lock.
+ */
+static size_t _thread(CommandProfiler *self) {
+
+	const pthread_t thread = pthread_self();
+
+	const pthread_t *threads = self->threads->elements;
+	for (size_t i = 0; i < self->threads->count; i++) {
+		if (pthread_equal(threads[i], thread)) {
+			return i;
+		}
+	}
+
+	$(self->threads, addElement, (ident) &thread);
+	return self->threads->count - 1;
+}
+
+/**
+ * @return The retained event at the given index, oldest first.
+ * @remarks The caller must hold the Lock.
+ */
+static const CommandEvent *_event(const CommandProfiler *self, size_t index) {
+	return VectorElement(self->samples, CommandEvent, (self->sample + index) % self->samples->count);
+}
+
+/**
+ * @brief Writes the given string to the given file as a JSON string.
+ */
+static void _writeString(FILE *file, const char *string) {
+
+	fputc('"', file);
+
+	for (const char *c = string; *c; c++) {
+		switch (*c) {
+			case '"':
+			case '\\':
+				fputc('\\', file);
+				fputc(*c, file);
+				break;
+			default:
+				if ((unsigned char) *c < 0x20) {
+					fprintf(file, "\\u%04x", *c);
+				} else {
+					fputc(*c, file);
+				}
+				break;
+		}
+	}
+
+	fputc('"', file);
+}
+
+/**
+ * @fn size_t CommandProfiler::depthSeries(const CommandProfiler *self, CommandDepthSample *samples, size_t count)
+ * @memberof CommandProfiler
+ */
+static size_t depthSeries(const CommandProfiler *self, CommandDepthSample *samples, size_t count) {
+
+	size_t copied = 0;
+
+	synchronized(self->lock, {
+
+		copied = min(count, self->samples->count);
+
+		const size_t offset = self->samples->count - copied;
+		for (size_t i = 0; i < copied; i++) {
+			const CommandEvent *event = _event(self, offset + i);
+
+			samples[i].time = event->sample.dequeued;
+			samples[i].depth = event->sample.depth;
+		}
+	});
+
+	return copied;
+}
+
+/**
+ * @fn CommandProfiler *CommandProfiler::init(CommandProfiler *self)
+ * @memberof CommandProfiler
+ */
+static CommandProfiler *init(CommandProfiler *self) {
+	return $(self, initWithCapacity, COMMAND_PROFILER_DEFAULT_CAPACITY);
+}
+
+/**
+ * @fn CommandProfiler *CommandProfiler::initWithCapacity(CommandProfiler *self, size_t capacity)
+ * @memberof CommandProfiler
+ */
+static CommandProfiler *initWithCapacity(CommandProfiler *self, size_t capacity) {
+
+	self = (CommandProfiler *) super(Object, self, init);
+	if (self) {
+
+		self->capacity = capacity;
+		assert(self->capacity);
+
+		self->labels = $(alloc(Vector), initWithSize, sizeof(CommandLabel));
+		assert(self->labels);
+
+		self->lock = $(alloc(Lock), init);
+		assert(self->lock);
+
+		self->profiles = $(alloc(Vector), initWithSize, sizeof(CommandProfile));
+		assert(self->profiles);
+
+		self->samples = $(alloc(Vector), initWithSize, sizeof(CommandEvent));
+		assert(self->samples);
+
+		self->threads = $(alloc(Vector), initWithSize, sizeof(pthread_t));
+		assert(self->threads);
+
+		_addProfile(self, NULL);
+		_addProfile(self, "unlabeled");
+	}
+
+	return self;
+}
+
+/**
+ * @fn void CommandProfiler::label(CommandProfiler *self, Consumer consumer, const char *label)
+ * @memberof CommandProfiler
+ */
+static void label(CommandProfiler *self, Consumer consumer, const char *label) {
+
+	assert(consumer);
+	assert(label);
+
+	synchronized(self->lock, {
+
+		ssize_t profile = _profileForName(self, label);
+		if (profile == -1) {
+			profile = (ssize_t) _addProfile(self, label);
+		}
+
+		CommandLabel *existing = NULL;
+
+		CommandLabel *l = self->labels->elements;
+		for (size_t i = 0; i < self->labels->count; i++, l++) {
+			if (l->consumer == consumer) {
+				existing = l;
+				break;
+			}
+		}
+
+		if (existing) {
+			existing->profile = (size_t) profile;
+		} else {
+			CommandLabel mapping;
+			mapping.consumer = consumer;
+			mapping.profile = (size_t) profile;
+
+			$(self->labels, addElement, (ident) &mapping);
+		}
+	});
+}
+
+/**
+ * @fn void CommandProfiler::record(CommandProfiler *self, Consumer consumer, const CommandSample *sample)
+ * @memberof CommandProfiler
+ */
+static void record(CommandProfiler *self, Consumer consumer, const CommandSample *sample) {
+
+	synchronized(self->lock, {
+
+		const size_t index = _profileForConsumer(self, consumer);
+
+		CommandProfile *profile = VectorElement(self->profiles, CommandProfile, index);
+		_profileAdd(profile, sample);
+
+		_profileAdd(VectorElement(self->profiles, CommandProfile, COMMAND_PROFILE_ALL), sample);
+
+		CommandEvent event;
+		event.name = profile->name;
+		event.sample = *sample;
+		event.thread = _thread(self);
+
+		if (self->samples->count < self->capacity) {
+			$(self->samples, addElement, (ident) &event);
+		} else {
+			*VectorElement(self->samples, CommandEvent, self->sample) = event;
+			self->sample = (self->sample + 1) % self->samples->count;
+		}
+	});
+}
+
+/**
+ * @fn CommandProfileStats CommandProfiler::stats(const CommandProfiler *self, const char *label)
+ * @memberof CommandProfiler
+ */
+static CommandProfileStats stats(const CommandProfiler *self, const char *label) {
+
+	CommandProfileStats stats;
+	memset(&stats, 0, sizeof(stats));
+
+	synchronized(self->lock, {
+
+		const ssize_t index = label ? _profileForName(self, label) : COMMAND_PROFILE_ALL;
+		if (index != -1) {
+
+			const CommandProfile *profile = VectorElement(self->profiles, CommandProfile, index);
+
+			stats.count = profile->execute.count;
+
+			stats.waitP50 = _histogramPercentile(&profile->wait, 50.0);
+			stats.waitP95 = _histogramPercentile(&profile->wait, 95.0);
+			stats.waitP99 = _histogramPercentile(&profile->wait, 99.0);
+			stats.waitMax = profile->wait.max;
+
+			stats.executeP50 = _histogramPercentile(&profile->execute, 50.0);
+			stats.executeP95 = _histogramPercentile(&profile->execute, 95.0);
+			stats.executeP99 = _histogramPercentile(&profile->execute, 99.0);
+			stats.executeMax = profile->execute.max;
+
+			stats.executeTime = profile->executeTime;
+
+			if (profile->last > profile->first) {
+				stats.throughput = stats.count * 1e9 / (profile->last - profile->first);
+			}
+		}
+	});
+
+	return stats;
+}
+
+/**
+ * @fn _Bool CommandProfiler::writeChromeTrace(const CommandProfiler *self, const char *path)
+ * @memberof CommandProfiler
+ */
+static _Bool writeChromeTrace(const CommandProfiler *self, const char *path) {
+
+	FILE *file = fopen(path, "w");
+	if (file == NULL) {
+		return false;
+	}
+
+	synchronized(self->lock, {
+
+		fputs("{\"traceEvents\":[\n", file);
+
+		for (size_t i = 0; i < self->samples->count; i++) {
+			const CommandEvent *event = _event(self, i);
+			const CommandSample *sample = &event->sample;
+
+			fputs(i ? ",\n{\"name\":" : "{\"name\":", file);
+			_writeString(file, event->name);
+
+			fprintf(file, ",\"cat\":\"command\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,"
+					"\"args\":{\"wait\":%.3f}},\n",
+					event->thread,
+					sample->started / 1000.0,
+					(sample->finished - sample->started) / 1000.0,
+					(sample->dequeued - sample->enqueued) / 1000.0);
+
+			fprintf(file, "{\"name\":\"depth\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"depth\":%zu}}",
+					sample->dequeued / 1000.0,
+					sample->depth);
+		}
+
+		fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+	});
+
+	return fclose(file) == 0;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((CommandProfilerInterface *) clazz->interface)->depthSeries = depthSeries;
+	((CommandProfilerInterface *) clazz->interface)->init = init;
+	((CommandProfilerInterface *) clazz->interface)->initWithCapacity = initWithCapacity;
+	((CommandProfilerInterface *) clazz->interface)->label = label;
+	((CommandProfilerInterface *) clazz->interface)->record = record;
+	((CommandProfilerInterface *) clazz->interface)->stats = stats;
+	((CommandProfilerInterface *) clazz->interface)->writeChromeTrace = writeChromeTrace;
+}
+
+/**
+ * @fn Class *CommandProfiler::_CommandProfiler(void)
+ * @memberof CommandProfiler
+ */
+Class *_CommandProfiler(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "CommandProfiler",
+			.superclass = _Object(),
+			.instanceSize = sizeof(CommandProfiler),
+			.interfaceOffset = offsetof(CommandProfiler, interface),
+			.interfaceSize = sizeof(CommandProfilerInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
@@ -0,0 +1,274 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Lock.h>
+#include <Objectively/Vector.h>
+
+#include <ObjectivelyGL/Command.h>
+
+/**
+ * @file
+ * @brief CommandProfilers measure the queue latency and execution time of Commands.
+ * @details Commands are grouped by the labels given to their Consumers with _label_. For each
+ * label, wait and execution times are accumulated into histograms, from which percentiles are
+ * reported. The most recent samples are also retained, for queue depth series and for export in
+ * the Chrome trace event format, which may be viewed with `chrome://tracing` or Perfetto.
+ *
+ * Profiling is enabled at runtime by attaching a CommandProfiler to a CommandQueue. When no
+ * CommandProfiler is attached, Commands are not timed.
+ * @see CommandQueue::profile(CommandQueue *, CommandProfiler *)
+ */
+
+/**
+ * @brief The default count of samples retained by a CommandProfiler.
+ */
+#define COMMAND_PROFILER_DEFAULT_CAPACITY 0x10000
+
+/**
+ * @brief The times of a single Command, in nanoseconds.
+ * @see CommandTime()
+ */
+typedef struct {
+
+	/**
+	 * @brief The times at which the Command was enqueued and dequeued.
+	 */
+	uint64_t enqueued, dequeued;
+
+	/**
+	 * @brief The times at which the Command started and finished executing.
+	 */
+	uint64_t started, finished;
+
+	/**
+	 * @brief The count of Commands pending when the Command was dequeued.
+	 */
+	size_t depth;
+
+} CommandSample;
+
+/**
+ * @brief A queue depth sample.
+ */
+typedef struct {
+
+	/**
+	 * @brief The time of the sample, in nanoseconds.
+	 */
+	uint64_t time;
+
+	/**
+	 * @brief The count of pending Commands.
+	 */
+	size_t depth;
+
+} CommandDepthSample;
+
+/**
+ * @brief CommandProfiler statistics for a label, with all times in nanoseconds.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of Commands executed.
+	 */
+	size_t count;
+
+	/**
+	 * @brief Wait time percentiles, from enqueue to dequeue.
+	 */
+	uint64_t waitP50, waitP95, waitP99, waitMax;
+
+	/**
+	 * @brief Execution time percentiles.
+	 */
+	uint64_t executeP50, executeP95, executeP99, executeMax;
+
+	/**
+	 * @brief The total execution time.
+	 */
+	uint64_t executeTime;
+
+	/**
+	 * @brief The count of Commands executed per second, from the first to the last.
+	 */
+	double throughput;
+
+} CommandProfileStats;
+
+typedef struct CommandProfiler CommandProfiler;
+typedef struct CommandProfilerInterface CommandProfilerInterface;
+
+/**
+ * @brief The CommandProfiler type.
+ * @extends Object
+ */
+struct CommandProfiler {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	CommandProfilerInterface *interface;
+
+	/**
+	 * @brief The labels, mapping Consumers to profiles.
+	 * @private
+	 */
+	Vector *labels;
+
+	/**
+	 * @brief The profiles, one per label, and one for all Commands.
+	 * @private
+	 */
+	Vector *profiles;
+
+	/**
+	 * @brief The most recent samples.
+	 * @private
+	 */
+	Vector *samples;
+
+	/**
+	 * @brief The index of the oldest sample, once `samples` is full.
+	 * @private
+	 */
+	size_t sample;
+
+	/**
+	 * @brief The maximum count of samples to retain.
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief The threads on which samples were recorded.
+	 * @private
+	 */
+	Vector *threads;
+
+	/**
+	 * @private
+	 */
+	Lock *lock;
+};
+
+/**
+ * @brief The CommandProfiler interface.
+ */
+struct CommandProfilerInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn size_t CommandProfiler::depthSeries(const CommandProfiler *self, CommandDepthSample *samples, size_t count)
+	 * @brief Copies the most recent queue depth samples, oldest first.
+	 * @param self The CommandProfiler.
+	 * @param samples The samples to populate.
+	 * @param count The maximum count of samples to copy.
+	 * @return The count of samples copied.
+	 * @memberof CommandProfiler
+	 */
+	size_t (*depthSeries)(const CommandProfiler *self, CommandDepthSample *samples, size_t count);
+
+	/**
+	 * @fn CommandProfiler *CommandProfiler::init(CommandProfiler *self)
+	 * @brief Initializes this CommandProfiler with the default capacity.
+	 * @param self The CommandProfiler.
+	 * @return The initialized CommandProfiler, or `NULL` on error.
+	 * @memberof CommandProfiler
+	 */
+	CommandProfiler *(*init)(CommandProfiler *self);
+
+	/**
+	 * @fn CommandProfiler *CommandProfiler::initWithCapacity(CommandProfiler *self, size_t capacity)
+	 * @brief Initializes this CommandProfiler with the specified capacity.
+	 * @param self The CommandProfiler.
+	 * @param capacity The maximum count of samples to retain.
+	 * @return The initialized CommandProfiler, or `NULL` on error.
+	 * @remarks Designated initializer.
+	 * @memberof CommandProfiler
+	 */
+	CommandProfiler *(*initWithCapacity)(CommandProfiler *self, size_t capacity);
+
+	/**
+	 * @fn void CommandProfiler::label(CommandProfiler *self, Consumer consumer, const char *label)
+	 * @brief Labels the given Consumer, grouping its Commands under the given label.
+	 * @details Consumers which are not labeled are grouped under `"unlabeled"`.
+	 * @param self The CommandProfiler.
+	 * @param consumer The Consumer.
+	 * @param label The label, which may be shared by several Consumers.
+	 * @memberof CommandProfiler
+	 */
+	void (*label)(CommandProfiler *self, Consumer consumer, const char *label);
+
+	/**
+	 * @fn void CommandProfiler::record(CommandProfiler *self, Consumer consumer, const CommandSample *sample)
+	 * @brief Records a sample for a Command with the given Consumer.
+	 * @param self The CommandProfiler.
+	 * @param consumer The Consumer.
+	 * @param sample The CommandSample.
+	 * @remarks This method is thread safe.
+	 * @memberof CommandProfiler
+	 */
+	void (*record)(CommandProfiler *self, Consumer consumer, const CommandSample *sample);
+
+	/**
+	 * @fn CommandProfileStats CommandProfiler::stats(const CommandProfiler *self, const char *label)
+	 * @param self The CommandProfiler.
+	 * @param label The label, or `NULL` for all Commands.
+	 * @return The statistics for the given label.
+	 * @memberof CommandProfiler
+	 */
+	CommandProfileStats (*stats)(const CommandProfiler *self, const char *label);
+
+	/**
+	 * @fn _Bool CommandProfiler::writeChromeTrace(const CommandProfiler *self, const char *path)
+	 * @brief Writes the retained samples to the specified file in the Chrome trace event format.
+	 * @details Each Command is written as a complete event named by its label, with its wait time
+	 * as an argument. The queue depth is written as a counter.
+	 * @param self The CommandProfiler.
+	 * @param path The file path.
+	 * @return True on success, false on error.
+	 * @memberof CommandProfiler
+	 */
+	_Bool (*writeChromeTrace)(const CommandProfiler *self, const char *path);
+};
+
+/**
+ * @fn Class *CommandProfiler::_CommandProfiler(void)
+ * @brief The CommandProfiler archetype.
+ * @return The CommandProfiler Class.
+ * @memberof CommandProfiler
+ */
+OBJECTIVELYGL_EXPORT Class *_CommandProfiler(void);
@@ -22,6 +22,7 @@
  */
 
 #include <assert.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -30,6 +31,15 @@
 #define _Class _CommandQueue
 
 #define COMMAND_QUEUE_DEFAULT_CAPACITY 64
+#define COMMAND_QUEUE_BATCH_SIZE 256
+
+/**
+ * @brief A Command to execute when a CommandFence completes.
+ */
+typedef struct {
+	CommandFence fence;
+	Command command;
+} CommandNotification;
 
 #pragma mark - Object
 
@@ -40,9 +50,19 @@ static void dealloc(Object *self) {
 
 	CommandQueue *this = (CommandQueue *) self;
 
-	free(this->commands);
+	for (size_t i = 0; i < lengthof(this->lanes); i++) {
+		free(this->lanes[i].commands);
+		free(this->lanes[i].times);
+	}
+
+	for (size_t i = 0; i < lengthof(this->frames); i++) {
+		release(this->frames[i]);
+	}
 
 	release(this->condition);
+	release(this->notifications);
+	release(this->profiler);
+	release(this->trace);
 	release(this->thread);
 
 	super(Object, self, dealloc);
@@ -50,6 +70,217 @@ static void dealloc(Object *self) {
 
 #pragma mark - CommandQueue
 
+/**
+ * @brief Removes the first notification whose CommandFence has completed.
+ * @return True if a notification was removed, false otherwise.
+ */
+static _Bool _takeNotification(CommandQueue *self, Command *command) {
+
+	_Bool taken = false;
+
+	synchronized(self->condition, {
+		const CommandNotification *notification = self->notifications->elements;
+		for (size_t i = 0; i < self->notifications->count; i++, notification++) {
+			if ($(self, isFenceComplete, notification->fence)) {
+				*command = notification->command;
+				$(self->notifications, removeElementAtIndex, i);
+				taken = true;
+				break;
+			}
+		}
+	});
+
+	return taken;
+}
+
+/**
+ * @brief Marks the Command with the given priority and sequence number as completed.
+ * @details Fence waiters are woken, and notifications for the CommandFence are executed.
+ */
+static void _complete(CommandQueue *self, CommandPriority priority, uint64_t sequence) {
+
+	__atomic_store_n(&self->lanes[priority].completed, sequence, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&self->fenceWaiters, __ATOMIC_SEQ_CST)) {
+		synchronized(self->condition, $(self->condition, broadcast));
+	}
+
+	if (__atomic_load_n(&self->notifications->count, __ATOMIC_SEQ_CST)) {
+		Command command;
+		while (_takeNotification(self, &command)) {
+			command.consumer(command.data);
+		}
+	}
+}
+
+/**
+ * @brief Consumer for CommandLists submitted with `endFrame`.
+ */
+static void _executeFrame(ident data) {
+
+	CommandList *list = data;
+	CommandQueue *self = list->queue;
+
+	$(list, execute);
+
+	synchronized(self->condition, {
+
+		const uint64_t latency = list->finished - list->submitted;
+
+		self->stats.frames++;
+		self->stats.frameLatency = latency;
+		self->stats.frameLatencyMax = max(self->stats.frameLatencyMax, latency);
+		self->stats.frameTime = list->finished - list->started;
+
+		self->framesInFlight--;
+
+		$(self->condition, broadcast);
+	});
+}
+
+/**
+ * @brief Executes the given Command, recording it to the given CommandTrace and CommandProfiler.
+ */
+static void _execute(CommandTrace *trace, CommandProfiler *profiler, const Command *command, CommandSample *sample) {
+
+	if (trace) {
+		if (command->consumer == _executeFrame) {
+			((CommandList *) command->data)->trace = trace;
+		} else {
+			$(trace, record, command->consumer, command->data);
+		}
+	}
+
+	if (profiler) {
+		sample->started = CommandTime();
+		command->consumer(command->data);
+		sample->finished = CommandTime();
+
+		$(profiler, record, command->consumer, sample);
+	} else {
+		command->consumer(command->data);
+	}
+}
+
+/**
+ * @brief Resizes each lane to the specified capacity, preserving pending Commands.
+ * @remarks The caller must hold the Condition.
+ */
+static void _resize(CommandQueue *self, size_t capacity) {
+
+	CommandLane *lane = self->lanes;
+	for (size_t i = 0; i < lengthof(self->lanes); i++, lane++) {
+
+		Command *commands = calloc(capacity, sizeof(Command));
+		assert(commands);
+
+		uint64_t *times = calloc(capacity, sizeof(uint64_t));
+		assert(times);
+
+		for (size_t j = 0; j < lane->count; j++) {
+			const uintptr_t k = (lane->pending + j) % self->capacity;
+			*(commands + j) = *(lane->commands + k);
+			*(times + j) = *(lane->times + k);
+		}
+
+		free(lane->commands);
+		free(lane->times);
+
+		lane->commands = commands;
+		lane->times = times;
+		lane->pending = 0;
+		lane->free = lane->count % capacity;
+	}
+
+	self->capacity = capacity;
+}
+
+/**
+ * @return The highest priority lane with pending Commands, or `NULL`.
+ * @remarks The caller must hold the Condition.
+ */
+static CommandLane *_nextLane(CommandQueue *self) {
+
+	for (size_t i = 0; i < lengthof(self->lanes); i++) {
+		if (self->lanes[i].count) {
+			return self->lanes + i;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Removes the next `count` Commands from the given lane into `commands`.
+ * @details If `samples` is not `NULL`, it receives the enqueue and dequeue times of each Command.
+ * @return The sequence number of the first Command removed.
+ * @remarks The caller must hold the Condition.
+ */
+static uint64_t _take(CommandQueue *self, CommandLane *lane, Command *commands, CommandSample *samples, size_t count) {
+
+	const uint64_t now = CommandTime();
+	const uint64_t sequence = lane->sequence - lane->count + 1;
+
+	for (size_t i = 0; i < count; i++) {
+		Command *cmd = lane->commands + lane->pending;
+
+		commands[i] = *cmd;
+
+		cmd->consumer = NULL;
+		cmd->data = NULL;
+
+		const uint64_t wait = now - lane->times[lane->pending];
+		lane->stats.waitTime += wait;
+		lane->stats.waitTimeMax = max(lane->stats.waitTimeMax, wait);
+
+		if (samples) {
+			samples[i].enqueued = lane->times[lane->pending];
+			samples[i].dequeued = now;
+			samples[i].depth = self->count - i;
+		}
+
+		lane->pending = (lane->pending + 1) % self->capacity;
+	}
+
+	lane->count -= count;
+	lane->stats.dequeued += count;
+
+	self->count -= count;
+	self->executing += count;
+	self->stats.dequeued += count;
+
+	return sequence;
+}
+
+/**
+ * @fn CommandList *CommandQueue::beginFrame(CommandQueue *self)
+ * @memberof CommandQueue
+ */
+static CommandList *beginFrame(CommandQueue *self) {
+
+	assert(self->frameDepth > 0);
+	assert(self->frameDepth <= COMMAND_QUEUE_MAX_FRAME_DEPTH);
+
+	synchronized(self->condition, {
+		while (self->framesInFlight >= self->frameDepth) {
+			$(self->condition, wait);
+		}
+	});
+
+	CommandList **list = self->frames + self->frame % self->frameDepth;
+	if (*list == NULL) {
+		*list = $(alloc(CommandList), init);
+		assert(*list);
+	}
+
+	$(*list, reset);
+
+	(*list)->frame = self->frame;
+	(*list)->queue = self;
+
+	return *list;
+}
+
 /**
  * @fn _Bool CommandQueue::dequeue(CommandQueue *self)
  * @memberof CommandQueue
@@ -58,52 +289,209 @@ static _Bool dequeue(CommandQueue *self) {
 	_Bool dequeued = false;
 
 	Command copy = { .consumer = NULL, .data = NULL };
+	CommandPriority priority = CommandPriorityNormal;
+	CommandTrace *trace = NULL;
+	CommandProfiler *profiler = NULL;
+	CommandSample sample;
+	uint64_t sequence = 0;
 
 	synchronized(self->condition, {
-		Command *cmd = self->commands + self->pending;
-		if (cmd->consumer) {
-			copy = *cmd;
-			cmd->consumer = NULL;
-			cmd->data = NULL;
-
-			self->pending = (self->pending + 1) % self->capacity;
-			self->count--;
+		CommandLane *lane = _nextLane(self);
+		if (lane) {
+			priority = (CommandPriority) (lane - self->lanes);
+			sequence = _take(self, lane, &copy, self->profiler ? &sample : NULL, 1);
+			$(self->condition, broadcast);
+
+			trace = self->trace ? retain(self->trace) : NULL;
+			profiler = self->profiler ? retain(self->profiler) : NULL;
 			dequeued = true;
 		}
 	});
 
 	if (copy.consumer) {
-		copy.consumer(copy.data);
-		synchronized(self->condition, $(self->condition, signal));
+		_execute(trace, profiler, &copy, &sample);
+		_complete(self, priority, sequence);
+
+		release(trace);
+		release(profiler);
+
+		synchronized(self->condition, {
+			self->executing--;
+			$(self->condition, broadcast);
+		});
 	}
 
 	return dequeued;
 }
 
+/**
+ * @fn size_t CommandQueue::dequeueBatch(CommandQueue *self, size_t count)
+ * @memberof CommandQueue
+ */
+static size_t dequeueBatch(CommandQueue *self, size_t count) {
+
+	Command batch[COMMAND_QUEUE_BATCH_SIZE];
+	CommandSample samples[COMMAND_QUEUE_BATCH_SIZE];
+
+	size_t dequeued = 0, executed = 0;
+	CommandPriority priority = CommandPriorityNormal;
+	CommandTrace *trace = NULL;
+	CommandProfiler *profiler = NULL;
+	uint64_t sequence = 0;
+
+	do {
+		synchronized(self->condition, {
+
+			if (executed) {
+				self->executing -= executed;
+				$(self->condition, broadcast);
+			}
+
+			executed = 0;
+
+			CommandLane *lane = _nextLane(self);
+			if (lane && dequeued < count) {
+				priority = (CommandPriority) (lane - self->lanes);
+
+				executed = min(min(count - dequeued, lane->count), COMMAND_QUEUE_BATCH_SIZE);
+				if (priority > CommandPriorityHigh) {
+					executed = min(executed, max(self->budget, 1));
+				}
+
+				sequence = _take(self, lane, batch, self->profiler ? samples : NULL, executed);
+
+				// wake producers blocked on the lane before executing the batch
+				$(self->condition, broadcast);
+
+				trace = self->trace ? retain(self->trace) : NULL;
+				profiler = self->profiler ? retain(self->profiler) : NULL;
+			}
+		});
+
+		for (size_t i = 0; i < executed; i++) {
+			_execute(trace, profiler, batch + i, samples + i);
+			_complete(self, priority, sequence + i);
+		}
+
+		trace = release(trace);
+		profiler = release(profiler);
+
+		dequeued += executed;
+
+	} while (executed);
+
+	return dequeued;
+}
+
+/**
+ * @fn _Bool CommandQueue::endFrame(CommandQueue *self)
+ * @memberof CommandQueue
+ */
+static _Bool endFrame(CommandQueue *self) {
+
+	CommandList *list = self->frames[self->frame % self->frameDepth];
+	assert(list);
+	assert(list->frame == self->frame);
+
+	list->submitted = CommandTime();
+
+	synchronized(self->condition, {
+		self->framesInFlight++;
+	});
+
+	if ($(self, enqueue, _executeFrame, list)) {
+		self->frame++;
+		return true;
+	}
+
+	synchronized(self->condition, {
+		self->framesInFlight--;
+	});
+
+	return false;
+}
+
 /**
  * @fn _Bool CommandQueue::enqueue(CommandQueue *self, Consumer consumer, ident data)
  * @memberof CommandQueue
  */
 static _Bool enqueue(CommandQueue *self, Consumer consumer, ident data) {
+	return $(self, enqueueWithFence, consumer, data, NULL);
+}
+
+/**
+ * @fn _Bool CommandQueue::enqueueWithFence(CommandQueue *self, Consumer consumer, ident data, CommandFence *fence)
+ * @memberof CommandQueue
+ */
+static _Bool enqueueWithFence(CommandQueue *self, Consumer consumer, ident data, CommandFence *fence) {
+	return $(self, enqueueWithPriority, CommandPriorityNormal, consumer, data, fence);
+}
+
+/**
+ * @fn _Bool CommandQueue::enqueueWithPriority(CommandQueue *self, CommandPriority priority, Consumer consumer, ident data, CommandFence *fence)
+ * @memberof CommandQueue
+ */
+static _Bool enqueueWithPriority(CommandQueue *self, CommandPriority priority, Consumer consumer, ident data, CommandFence *fence) {
 
 	assert(consumer);
+	assert(priority < CommandPriorityCount);
+
+	CommandLane *lane = self->lanes + priority;
 
 	_Bool enqueued = false;
+	uint64_t sequence = 0;
 
 	synchronized(self->condition, {
-		Command *cmd = self->commands + self->free;
+
+		if (lane->count == self->capacity) {
+			switch (self->policy) {
+				case CommandQueuePolicyFail:
+					break;
+				case CommandQueuePolicyBlock:
+					self->stats.blocked++;
+					while (lane->count == self->capacity) {
+						$(self->condition, wait);
+					}
+					break;
+				case CommandQueuePolicyGrow:
+					self->stats.grown++;
+					_resize(self, self->capacity * 2);
+					break;
+			}
+		}
+
+		Command *cmd = lane->commands + lane->free;
 		if (cmd->consumer == NULL) {
 			cmd->consumer = consumer;
 			cmd->data = data;
 
-			self->free = (self->free + 1) % self->capacity;
+			lane->times[lane->free] = CommandTime();
+			lane->free = (lane->free + 1) % self->capacity;
+			lane->count++;
+
+			sequence = ++lane->sequence;
+
+			lane->stats.enqueued++;
+			lane->stats.highWaterMark = max(lane->stats.highWaterMark, lane->count);
+
 			self->count++;
+
+			self->stats.enqueued++;
+			self->stats.highWaterMark = max(self->stats.highWaterMark, self->count);
+
 			enqueued = true;
 
-			$(self->condition, signal);
+			$(self->condition, broadcast);
+		} else {
+			self->stats.rejected++;
 		}
 	});
 
+	if (fence) {
+		fence->priority = priority;
+		fence->value = sequence;
+	}
+
 	return enqueued;
 }
 
@@ -112,10 +500,7 @@ static _Bool enqueue(CommandQueue *self, Consumer consumer, ident data) {
  * @memberof CommandQueue
  */
 static void flush(CommandQueue *self) {
-
-	while ($(self, dequeue)) {
-
-	}
+	$(self, dequeueBatch, SIZE_MAX);
 }
 
 /**
@@ -126,6 +511,63 @@ static CommandQueue *init(CommandQueue *self) {
 	return $(self, initWithCapacity, COMMAND_QUEUE_DEFAULT_CAPACITY);
 }
 
+/**
+ * @brief Hints to the processor that the calling thread is spinning.
+ */
+static inline void _pause(void) {
+#if defined(__i386__) || defined(__x86_64__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief Records a wakeup of the worker Thread.
+ * @remarks The caller must hold the Condition.
+ */
+static void _wakeup(CommandQueue *self, size_t *wakeups) {
+
+	const CommandLane *lane = _nextLane(self);
+	if (lane) {
+		const uint64_t latency = CommandTime() - lane->times[lane->pending];
+
+		self->stats.wakeupLatency += latency;
+		self->stats.wakeupLatencyMax = max(self->stats.wakeupLatencyMax, latency);
+
+		(*wakeups)++;
+	}
+}
+
+/**
+ * @brief Waits for Commands to be enqueued, spinning, then yielding, then parking.
+ */
+static void _wait(CommandQueue *self, const Thread *thread) {
+
+	for (size_t i = 0; i < self->spinCount; i++) {
+		if (__atomic_load_n(&self->count, __ATOMIC_ACQUIRE) || thread->isCancelled) {
+			synchronized(self->condition, _wakeup(self, &self->stats.spinWakeups));
+			return;
+		}
+		_pause();
+	}
+
+	for (size_t i = 0; i < self->yieldCount; i++) {
+		if (__atomic_load_n(&self->count, __ATOMIC_ACQUIRE) || thread->isCancelled) {
+			synchronized(self->condition, _wakeup(self, &self->stats.yieldWakeups));
+			return;
+		}
+		sched_yield();
+	}
+
+	synchronized(self->condition, {
+		while (self->count == 0 && !thread->isCancelled) {
+			$(self->condition, wait);
+		}
+		_wakeup(self, &self->stats.parkWakeups);
+	});
+}
+
 /**
  * @brief ThreadFunction.
  */
@@ -137,31 +579,45 @@ static ident _thread(Thread *thread) {
 
 		$(self, flush);
 
-		synchronized(self->condition, $(self->condition, wait));
+		_wait(self, thread);
 	}
 
 	return NULL;
 }
 
 /**
- * @fn CommandQueue *CommandQueue::init(CommandQueue *self, ident context)
+ * @fn CommandQueue *CommandQueue::initWithCapacity(CommandQueue *self, size_t capacity)
  * @memberof CommandQueue
  */
 static CommandQueue *initWithCapacity(CommandQueue *self, size_t capacity) {
+	return $(self, initWithPolicy, CommandQueuePolicyFail, capacity);
+}
+
+/**
+ * @fn CommandQueue *CommandQueue::initWithPolicy(CommandQueue *self, CommandQueuePolicy policy, size_t capacity)
+ * @memberof CommandQueue
+ */
+static CommandQueue *initWithPolicy(CommandQueue *self, CommandQueuePolicy policy, size_t capacity) {
 
 	self = (CommandQueue *) super(Object, self, init);
 	if (self) {
-		self->capacity = capacity;
-		assert(self->capacity);
+		self->policy = policy;
+		self->budget = COMMAND_QUEUE_DEFAULT_BUDGET;
+		self->spinCount = COMMAND_QUEUE_DEFAULT_SPIN_COUNT;
+		self->yieldCount = COMMAND_QUEUE_DEFAULT_YIELD_COUNT;
+		self->frameDepth = 2;
 
-		self->commands = calloc(self->capacity, sizeof(Command));
-		assert(self->commands);
+		assert(capacity);
+		_resize(self, capacity);
 
 		self->condition = $(alloc(Condition), init);
 		assert(self->condition);
 
 		self->thread = $(alloc(Thread), initWithFunction, _thread, self);
 		assert(self->thread);
+
+		self->notifications = $(alloc(Vector), initWithSize, sizeof(CommandNotification));
+		assert(self->notifications);
 	}
 
 	return self;
@@ -176,26 +632,84 @@ static _Bool isEmpty(const CommandQueue *self) {
 }
 
 /**
- * @fn void CommandQueue::resize(CommandQueue *self, size_t capacity)
+ * @fn _Bool CommandQueue::isFenceComplete(const CommandQueue *self, CommandFence fence)
  * @memberof CommandQueue
  */
-static void resize(CommandQueue *self, size_t capacity) {
+static _Bool isFenceComplete(const CommandQueue *self, CommandFence fence) {
+	assert(fence.priority < CommandPriorityCount);
+
+	return __atomic_load_n(&self->lanes[fence.priority].completed, __ATOMIC_SEQ_CST) >= fence.value;
+}
+
+/**
+ * @fn void CommandQueue::notify(CommandQueue *self, CommandFence fence, Consumer consumer, ident data)
+ * @memberof CommandQueue
+ */
+static void notify(CommandQueue *self, CommandFence fence, Consumer consumer, ident data) {
+
+	assert(consumer);
+
+	const CommandNotification notification = {
+		.fence = fence,
+		.command = {
+			.consumer = consumer,
+			.data = data
+		}
+	};
 
 	synchronized(self->condition, {
+		$(self->notifications, addElement, (ident) &notification);
+	});
 
-		Command *commands = calloc(capacity, sizeof(Command));
-		assert(commands);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
 
-		for (size_t i = 0; i < self->count; i++) {
-			*(commands + i) = *(self->commands + (self->pending + i) % self->capacity);
+	if ($(self, isFenceComplete, fence)) {
+		Command command;
+		while (_takeNotification(self, &command)) {
+			$(self, enqueueWithPriority, fence.priority, command.consumer, command.data, NULL);
 		}
+	}
+}
 
-		free(self->commands);
+/**
+ * @fn void CommandQueue::profile(CommandQueue *self, CommandProfiler *profiler)
+ * @memberof CommandQueue
+ */
+static void profile(CommandQueue *self, CommandProfiler *profiler) {
 
-		self->commands = commands;
-		self->capacity = capacity;
-		self->pending = 0;
-		self->free = self->count;
+	if (profiler) {
+		$(profiler, label, _executeFrame, "frame");
+	}
+
+	synchronized(self->condition, {
+		release(self->profiler);
+		self->profiler = profiler ? retain(profiler) : NULL;
+	});
+}
+
+/**
+ * @fn void CommandQueue::record(CommandQueue *self, CommandTrace *trace)
+ * @memberof CommandQueue
+ */
+static void record(CommandQueue *self, CommandTrace *trace) {
+
+	synchronized(self->condition, {
+		release(self->trace);
+		self->trace = trace ? retain(trace) : NULL;
+	});
+}
+
+/**
+ * @fn void CommandQueue::resize(CommandQueue *self, size_t capacity)
+ * @memberof CommandQueue
+ */
+static void resize(CommandQueue *self, size_t capacity) {
+
+	assert(capacity);
+
+	synchronized(self->condition, {
+		_resize(self, max(capacity, self->count));
+		$(self->condition, broadcast);
 	});
 }
 
@@ -208,6 +722,25 @@ static void start(CommandQueue *self) {
 	$(self->thread, start);
 }
 
+/**
+ * @fn CommandQueueStats CommandQueue::stats(const CommandQueue *self)
+ * @memberof CommandQueue
+ */
+static CommandQueueStats stats(const CommandQueue *self) {
+
+	CommandQueueStats stats;
+
+	synchronized(self->condition, {
+		stats = self->stats;
+		for (size_t i = 0; i < lengthof(self->lanes); i++) {
+			stats.lanes[i] = self->lanes[i].stats;
+			stats.lanes[i].depth = self->lanes[i].count;
+		}
+	});
+
+	return stats;
+}
+
 /**
  * @fn void *CommandQueue::start(CommandQueue *self)
  * @memberof CommandQueue
@@ -216,11 +749,41 @@ static void stop(CommandQueue *self) {
 
 	$(self->thread, cancel);
 
-	synchronized(self->condition, $(self->condition, signal));
+	synchronized(self->condition, $(self->condition, broadcast));
 
 	$(self->thread, join, NULL);
 }
 
+/**
+ * @fn void CommandQueue::waitForFence(const CommandQueue *self, CommandFence fence)
+ * @memberof CommandQueue
+ */
+static void waitForFence(const CommandQueue *self, CommandFence fence) {
+
+	CommandQueue *this = (CommandQueue *) self;
+
+	synchronized(self->condition, {
+		__atomic_add_fetch(&this->fenceWaiters, 1, __ATOMIC_SEQ_CST);
+		while (!$(self, isFenceComplete, fence)) {
+			$(self->condition, wait);
+		}
+		__atomic_sub_fetch(&this->fenceWaiters, 1, __ATOMIC_SEQ_CST);
+	});
+}
+
+/**
+ * @fn void CommandQueue::waitForFrames(const CommandQueue *self)
+ * @memberof CommandQueue
+ */
+static void waitForFrames(const CommandQueue *self) {
+
+	synchronized(self->condition, {
+		while (self->framesInFlight) {
+			$(self->condition, wait);
+		}
+	});
+}
+
 /**
  * @fn void CommandQueue::waitUntilEmpty(const CommandQueue *self)
  * @memberof CommandQueue
@@ -228,7 +791,7 @@ static void stop(CommandQueue *self) {
 static void waitUntilEmpty(const CommandQueue *self) {
 
 	synchronized(self->condition, {
-		while (self->count) {
+		while (self->count || self->executing) {
 			$(self->condition, wait);
 		}
 	});
@@ -243,15 +806,28 @@ static void initialize(Class *clazz) {
 
 	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
 
+	((CommandQueueInterface *) clazz->interface)->beginFrame = beginFrame;
 	((CommandQueueInterface *) clazz->interface)->dequeue = dequeue;
+	((CommandQueueInterface *) clazz->interface)->dequeueBatch = dequeueBatch;
+	((CommandQueueInterface *) clazz->interface)->endFrame = endFrame;
 	((CommandQueueInterface *) clazz->interface)->enqueue = enqueue;
+	((CommandQueueInterface *) clazz->interface)->enqueueWithFence = enqueueWithFence;
+	((CommandQueueInterface *) clazz->interface)->enqueueWithPriority = enqueueWithPriority;
 	((CommandQueueInterface *) clazz->interface)->flush = flush;
 	((CommandQueueInterface *) clazz->interface)->init = init;
 	((CommandQueueInterface *) clazz->interface)->initWithCapacity = initWithCapacity;
+	((CommandQueueInterface *) clazz->interface)->initWithPolicy = initWithPolicy;
 	((CommandQueueInterface *) clazz->interface)->isEmpty = isEmpty;
+	((CommandQueueInterface *) clazz->interface)->isFenceComplete = isFenceComplete;
+	((CommandQueueInterface *) clazz->interface)->notify = notify;
+	((CommandQueueInterface *) clazz->interface)->profile = profile;
+	((CommandQueueInterface *) clazz->interface)->record = record;
 	((CommandQueueInterface *) clazz->interface)->resize = resize;
 	((CommandQueueInterface *) clazz->interface)->start = start;
+	((CommandQueueInterface *) clazz->interface)->stats = stats;
 	((CommandQueueInterface *) clazz->interface)->stop = stop;
+	((CommandQueueInterface *) clazz->interface)->waitForFence = waitForFence;
+	((CommandQueueInterface *) clazz->interface)->waitForFrames = waitForFrames;
 	((CommandQueueInterface *) clazz->interface)->waitUntilEmpty = waitUntilEmpty;
 }
 
@@ -25,23 +25,300 @@
 
 #include <Objectively/Condition.h>
 #include <Objectively/Thread.h>
+#include <Objectively/Vector.h>
 
-#include <ObjectivelyGL/Types.h>
+#include <ObjectivelyGL/CommandList.h>
+#include <ObjectivelyGL/CommandProfiler.h>
 
 /**
  * @file
  * @brief CommandQueues allow asynchronous rendering via a dedicatd thread.
  * @details To process Commands on a dedicated background thread, use _start_ and _stop_.
  * To process Commands on the calling thread, use _dequeue_ or _flush_.
+ *
+ * To pipeline frames, record each frame's Commands into the CommandList returned by
+ * _beginFrame_, and submit it with _endFrame_. Up to _frameDepth_ frames may be in flight, so
+ * that the producer records frame N+1 while the consumer executes frame N.
+ *
+ * Commands are enqueued to one of several priority lanes. Pending Commands in higher priority
+ * lanes are always dequeued first, so that latency sensitive work, such as frame submission, need
+ * not wait behind bulk work, such as resource uploads. The _budget_ bounds the count of lower
+ * priority Commands that may execute in succession before the higher priority lanes are checked
+ * again.
+ *
+ * When idle, the worker Thread spins for _spinCount_ iterations, then yields for _yieldCount_
+ * iterations, and only then parks on the Condition. This avoids a full operating system wakeup
+ * when Commands are enqueued shortly after the CommandQueue drains, at the cost of CPU time.
+ *
+ * To capture the Commands executed by a CommandQueue for offline analysis, use _record_. To
+ * measure their queue latency and execution time, use _profile_.
+ */
+
+/**
+ * @brief The maximum frame pipeline depth.
+ */
+#define COMMAND_QUEUE_MAX_FRAME_DEPTH 3
+
+/**
+ * @brief The default count of lower priority Commands that may execute in succession.
  */
+#define COMMAND_QUEUE_DEFAULT_BUDGET 16
+
+/**
+ * @brief The default count of iterations the idle worker Thread spins before yielding.
+ */
+#define COMMAND_QUEUE_DEFAULT_SPIN_COUNT 1000
+
+/**
+ * @brief The default count of iterations the idle worker Thread yields before parking.
+ */
+#define COMMAND_QUEUE_DEFAULT_YIELD_COUNT 10
 
 typedef struct CommandQueue CommandQueue;
 typedef struct CommandQueueInterface CommandQueueInterface;
 
-typedef struct Command {
-	Consumer consumer;
-	ident data;
-} Command;
+/**
+ * @brief Command priorities, each of which is serviced by its own lane.
+ */
+typedef enum {
+
+	/**
+	 * @brief Latency sensitive Commands, such as frame submission.
+	 */
+	CommandPriorityHigh,
+
+	/**
+	 * @brief The default priority.
+	 */
+	CommandPriorityNormal,
+
+	/**
+	 * @brief Bulk Commands, such as resource uploads.
+	 */
+	CommandPriorityLow,
+
+	/**
+	 * @brief The count of priorities.
+	 */
+	CommandPriorityCount
+
+} CommandPriority;
+
+/**
+ * @brief CommandFences are lightweight completion tokens for enqueued Commands.
+ * @details Commands complete in the order in which they were enqueued to their lane, so a
+ * CommandFence also guarantees the completion of all Commands enqueued to the same lane before it.
+ * This ordering holds when the CommandQueue is consumed by a single thread.
+ * @see CommandQueue::enqueueWithFence(CommandQueue *, Consumer, ident, CommandFence *)
+ */
+typedef struct {
+
+	/**
+	 * @brief The priority lane of the Command.
+	 */
+	CommandPriority priority;
+
+	/**
+	 * @brief The sequence number of the Command, or `0` if the Command was not enqueued.
+	 */
+	uint64_t value;
+
+} CommandFence;
+
+/**
+ * @brief Backpressure policies, applied when enqueueing to a full CommandQueue.
+ */
+typedef enum {
+
+	/**
+	 * @brief `enqueue` fails, returning false. This is the default.
+	 */
+	CommandQueuePolicyFail,
+
+	/**
+	 * @brief `enqueue` blocks the calling thread until space is available.
+	 * @remarks The CommandQueue must be consumed on another thread, or this will deadlock.
+	 */
+	CommandQueuePolicyBlock,
+
+	/**
+	 * @brief `enqueue` doubles the capacity of the CommandQueue.
+	 */
+	CommandQueuePolicyGrow,
+
+} CommandQueuePolicy;
+
+/**
+ * @brief Per-lane CommandQueue statistics.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of pending Commands.
+	 */
+	size_t depth;
+
+	/**
+	 * @brief The maximum count of pending Commands.
+	 */
+	size_t highWaterMark;
+
+	/**
+	 * @brief The count of Commands enqueued.
+	 */
+	size_t enqueued;
+
+	/**
+	 * @brief The count of Commands dequeued.
+	 */
+	size_t dequeued;
+
+	/**
+	 * @brief The total time dequeued Commands spent waiting in the lane, in nanoseconds.
+	 * @remarks Divide by `dequeued` for the mean wait time.
+	 */
+	uint64_t waitTime;
+
+	/**
+	 * @brief The maximum time a dequeued Command spent waiting in the lane, in nanoseconds.
+	 */
+	uint64_t waitTimeMax;
+
+} CommandLaneStats;
+
+/**
+ * @brief CommandQueue statistics, useful for sizing queues.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of Commands enqueued.
+	 */
+	size_t enqueued;
+
+	/**
+	 * @brief The count of Commands dequeued.
+	 */
+	size_t dequeued;
+
+	/**
+	 * @brief The count of Commands rejected because the CommandQueue was full.
+	 */
+	size_t rejected;
+
+	/**
+	 * @brief The count of enqueues that blocked because the CommandQueue was full.
+	 */
+	size_t blocked;
+
+	/**
+	 * @brief The count of times the CommandQueue has grown because it was full.
+	 */
+	size_t grown;
+
+	/**
+	 * @brief The maximum count of pending Commands.
+	 */
+	size_t highWaterMark;
+
+	/**
+	 * @brief The count of frames executed.
+	 */
+	uint64_t frames;
+
+	/**
+	 * @brief The latency of the most recent frame, from submission to completion, in nanoseconds.
+	 */
+	uint64_t frameLatency;
+
+	/**
+	 * @brief The maximum frame latency, in nanoseconds.
+	 */
+	uint64_t frameLatencyMax;
+
+	/**
+	 * @brief The execution time of the most recent frame, in nanoseconds.
+	 */
+	uint64_t frameTime;
+
+	/**
+	 * @brief The per-lane statistics, indexed by CommandPriority.
+	 */
+	CommandLaneStats lanes[CommandPriorityCount];
+
+	/**
+	 * @brief The count of times the worker Thread found Commands while spinning.
+	 */
+	size_t spinWakeups;
+
+	/**
+	 * @brief The count of times the worker Thread found Commands while yielding.
+	 */
+	size_t yieldWakeups;
+
+	/**
+	 * @brief The count of times the worker Thread was woken from the Condition.
+	 */
+	size_t parkWakeups;
+
+	/**
+	 * @brief The total latency of worker Thread wakeups, from the enqueue of the first Command to
+	 * the wakeup, in nanoseconds.
+	 * @remarks Divide by the sum of wakeups for the mean wakeup latency.
+	 */
+	uint64_t wakeupLatency;
+
+	/**
+	 * @brief The maximum wakeup latency, in nanoseconds.
+	 */
+	uint64_t wakeupLatencyMax;
+
+} CommandQueueStats;
+
+/**
+ * @brief A ring of pending Commands of a single priority.
+ */
+typedef struct {
+
+	/**
+	 * @private
+	 */
+	Command *commands;
+
+	/**
+	 * @brief The enqueue times of the pending Commands, in nanoseconds.
+	 * @private
+	 */
+	uint64_t *times;
+
+	/**
+	 * @brief The count of pending Commands.
+	 */
+	size_t count;
+
+	/**
+	 * @private
+	 */
+	uintptr_t free, pending;
+
+	/**
+	 * @brief The sequence number of the most recently enqueued Command.
+	 * @private
+	 */
+	uint64_t sequence;
+
+	/**
+	 * @brief The sequence number of the most recently completed Command.
+	 * @private
+	 */
+	uint64_t completed;
+
+	/**
+	 * @private
+	 */
+	CommandLaneStats stats;
+
+} CommandLane;
 
 /**
  * @brief The CommandQueue type.
@@ -61,24 +338,55 @@ struct CommandQueue {
 	CommandQueueInterface *interface;
 
 	/**
-	 * @private
+	 * @brief The priority lanes, indexed by CommandPriority.
 	 */
-	Command *commands;
+	CommandLane lanes[CommandPriorityCount];
 
 	/**
-	 * @brief The capacity.
+	 * @brief The capacity of each lane.
 	 */
 	size_t capacity;
 
 	/**
-	 * @brief The count of pending Commands.
+	 * @brief The count of pending Commands, in all lanes.
 	 */
 	size_t count;
 
+	/**
+	 * @brief The maximum count of lower priority Commands to execute in succession before higher
+	 * priority lanes are checked again.
+	 * @details The default is `COMMAND_QUEUE_DEFAULT_BUDGET`.
+	 */
+	size_t budget;
+
+	/**
+	 * @brief The backpressure policy.
+	 */
+	CommandQueuePolicy policy;
+
 	/**
 	 * @private
 	 */
-	uintptr_t free, pending;
+	CommandQueueStats stats;
+
+	/**
+	 * @brief The count of iterations the idle worker Thread spins before yielding.
+	 * @details The default is `COMMAND_QUEUE_DEFAULT_SPIN_COUNT`.
+	 */
+	size_t spinCount;
+
+	/**
+	 * @brief The count of iterations the idle worker Thread yields before parking.
+	 * @details The default is `COMMAND_QUEUE_DEFAULT_YIELD_COUNT`. Set both this and `spinCount`
+	 * to `0` to park immediately.
+	 */
+	size_t yieldCount;
+
+	/**
+	 * @brief The count of dequeued Commands that are currently executing.
+	 * @private
+	 */
+	size_t executing;
 
 	/**
 	 * @private
@@ -89,6 +397,53 @@ struct CommandQueue {
 	 * @private
 	 */
 	Thread *thread;
+
+	/**
+	 * @brief The frame pipeline depth, between `1` and `COMMAND_QUEUE_MAX_FRAME_DEPTH`.
+	 * @details The default is `2`, which double buffers frames.
+	 */
+	size_t frameDepth;
+
+	/**
+	 * @brief The frame number of the next frame to be recorded.
+	 */
+	uint64_t frame;
+
+	/**
+	 * @brief The count of frames submitted but not yet executed.
+	 * @private
+	 */
+	size_t framesInFlight;
+
+	/**
+	 * @brief The pooled CommandLists, one per frame in the pipeline.
+	 * @private
+	 */
+	CommandList *frames[COMMAND_QUEUE_MAX_FRAME_DEPTH];
+
+	/**
+	 * @brief The count of threads waiting on CommandFences.
+	 * @private
+	 */
+	unsigned int fenceWaiters;
+
+	/**
+	 * @brief Consumers to execute when their CommandFences complete.
+	 * @private
+	 */
+	Vector *notifications;
+
+	/**
+	 * @brief The CommandTrace to record executed Commands to, if any.
+	 * @private
+	 */
+	CommandTrace *trace;
+
+	/**
+	 * @brief The CommandProfiler to record Command times to, if any.
+	 * @private
+	 */
+	CommandProfiler *profiler;
 };
 
 /**
@@ -101,6 +456,16 @@ struct CommandQueueInterface {
 	 */
 	ObjectInterface objectInterface;
 
+	/**
+	 * @fn CommandList *CommandQueue::beginFrame(CommandQueue *self)
+	 * @brief Begins recording the next frame.
+	 * @details Blocks the calling thread while `frameDepth` frames are in flight.
+	 * @param self The CommandQueue.
+	 * @return The CommandList in which to record the frame's Commands.
+	 * @memberof CommandQueue
+	 */
+	CommandList *(*beginFrame)(CommandQueue *self);
+
 	/**
 	 * @fn _Bool CommandQueue::dequeue(CommandQueue *self)
 	 * @brief Dequeues and executes the next pending command on the calling thread.
@@ -110,9 +475,32 @@ struct CommandQueueInterface {
 	 */
 	_Bool (*dequeue)(CommandQueue *self);
 
+	/**
+	 * @fn size_t CommandQueue::dequeueBatch(CommandQueue *self, size_t count)
+	 * @brief Dequeues and executes up to `count` pending Commands on the calling thread.
+	 * @details Commands are dequeued in batches, so that synchronization is paid once per batch
+	 * rather than once per Command.
+	 * @param self The CommandQueue.
+	 * @param count The maximum count of Commands to dequeue.
+	 * @return The count of Commands dequeued.
+	 * @memberof CommandQueue
+	 */
+	size_t (*dequeueBatch)(CommandQueue *self, size_t count);
+
+	/**
+	 * @fn _Bool CommandQueue::endFrame(CommandQueue *self)
+	 * @brief Submits the frame begun with `beginFrame` for execution.
+	 * @param self The CommandQueue.
+	 * @return True if the frame was successfully enqueued, false otherwise.
+	 * @memberof CommandQueue
+	 */
+	_Bool (*endFrame)(CommandQueue *self);
+
 	/**
 	 * @fn _Bool CommandQueue::enqueue(CommandQueue *self, Consumer consumer, ident data)
-	 * @brief Enqueues a new Command with the given Consumer and data.
+	 * @brief Enqueues a new Command with the given Consumer and data, at normal priority.
+	 * @details If the lane is full, its policy determines whether this method fails,
+	 * blocks, or grows the queue.
 	 * @param self The CommandQueue.
 	 * @param consumer The Consumer.
 	 * @param data User data.
@@ -121,6 +509,31 @@ struct CommandQueueInterface {
 	 */
 	_Bool (*enqueue)(CommandQueue *self, Consumer consumer, ident data);
 
+	/**
+	 * @fn _Bool CommandQueue::enqueueWithFence(CommandQueue *self, Consumer consumer, ident data, CommandFence *fence)
+	 * @brief Enqueues a new Command with the given Consumer and data, returning its CommandFence.
+	 * @param self The CommandQueue.
+	 * @param consumer The Consumer.
+	 * @param data User data.
+	 * @param fence If not `NULL`, receives the CommandFence for the Command.
+	 * @return True if the Command was successfully enqueued, false otherwise.
+	 * @memberof CommandQueue
+	 */
+	_Bool (*enqueueWithFence)(CommandQueue *self, Consumer consumer, ident data, CommandFence *fence);
+
+	/**
+	 * @fn _Bool CommandQueue::enqueueWithPriority(CommandQueue *self, CommandPriority priority, Consumer consumer, ident data, CommandFence *fence)
+	 * @brief Enqueues a new Command with the given Consumer and data to the lane for `priority`.
+	 * @param self The CommandQueue.
+	 * @param priority The CommandPriority.
+	 * @param consumer The Consumer.
+	 * @param data User data.
+	 * @param fence If not `NULL`, receives the CommandFence for the Command.
+	 * @return True if the Command was successfully enqueued, false otherwise.
+	 * @memberof CommandQueue
+	 */
+	_Bool (*enqueueWithPriority)(CommandQueue *self, CommandPriority priority, Consumer consumer, ident data, CommandFence *fence);
+
 	/**
 	 * @fn void CommandQueue::flush(CommandQueue *self)
 	 * @brief Dequeues and executes all pending Commands on the calling thread.
@@ -148,6 +561,18 @@ struct CommandQueueInterface {
 	 */
 	CommandQueue *(*initWithCapacity)(CommandQueue *self, size_t capacity);
 
+	/**
+	 * @fn CommandQueue *CommandQueue::initWithPolicy(CommandQueue *self, CommandQueuePolicy policy, size_t capacity)
+	 * @brief Initializes this CommandQueue with the specified policy and capacity.
+	 * @param self The CommandQueue.
+	 * @param policy The backpressure policy.
+	 * @param capacity The capacity of each lane.
+	 * @return The initialized CommandQueue, or `NULL` on error.
+	 * @remarks Designated initializer.
+	 * @memberof CommandQueue
+	 */
+	CommandQueue *(*initWithPolicy)(CommandQueue *self, CommandQueuePolicy policy, size_t capacity);
+
 	/**
 	 * @fn _Bool CommandQueue::isEmpty(const CommandQueue *self)
 	 * @param self The CommandQueue.
@@ -156,9 +581,56 @@ struct CommandQueueInterface {
 	 */
 	_Bool (*isEmpty)(const CommandQueue *self);
 
+	/**
+	 * @fn _Bool CommandQueue::isFenceComplete(const CommandQueue *self, CommandFence fence)
+	 * @param self The CommandQueue.
+	 * @param fence The CommandFence.
+	 * @return True if the Command for the given CommandFence has completed, false otherwise.
+	 * @remarks This method does not block, and is suitable for polling.
+	 * @memberof CommandQueue
+	 */
+	_Bool (*isFenceComplete)(const CommandQueue *self, CommandFence fence);
+
+	/**
+	 * @fn void CommandQueue::notify(CommandQueue *self, CommandFence fence, Consumer consumer, ident data)
+	 * @brief Executes the given Consumer once the given CommandFence completes.
+	 * @details The Consumer executes on the consuming thread, immediately after the Command for
+	 * the CommandFence. If the CommandFence has already completed, the Consumer is enqueued. The
+	 * Consumer may itself enqueue Commands, so that dependent work can be chained.
+	 * @param self The CommandQueue.
+	 * @param fence The CommandFence.
+	 * @param consumer The Consumer.
+	 * @param data User data.
+	 * @memberof CommandQueue
+	 */
+	void (*notify)(CommandQueue *self, CommandFence fence, Consumer consumer, ident data);
+
+	/**
+	 * @fn void CommandQueue::profile(CommandQueue *self, CommandProfiler *profiler)
+	 * @brief Records the times of Commands executed by this CommandQueue to the given
+	 * CommandProfiler.
+	 * @details Frames submitted with `endFrame` are labeled `"frame"`. Notifications are not
+	 * profiled.
+	 * @param self The CommandQueue.
+	 * @param profiler The CommandProfiler, or `NULL` to stop profiling.
+	 * @memberof CommandQueue
+	 */
+	void (*profile)(CommandQueue *self, CommandProfiler *profiler);
+
+	/**
+	 * @fn void CommandQueue::record(CommandQueue *self, CommandTrace *trace)
+	 * @brief Records Commands executed by this CommandQueue to the given CommandTrace.
+	 * @details Commands of frames submitted with `endFrame` are recorded individually, following
+	 * a frame record. Notifications are not recorded.
+	 * @param self The CommandQueue.
+	 * @param trace The CommandTrace, or `NULL` to stop recording.
+	 * @memberof CommandQueue
+	 */
+	void (*record)(CommandQueue *self, CommandTrace *trace);
+
 	/**
 	 * @fn void CommandQueue::resize(CommandQueue *self, size_t capacity)
-	 * @brief Resizes this CommandQueue to the specified capacity.
+	 * @brief Resizes each lane of this CommandQueue to the specified capacity.
 	 * @param self The CommandQueue.
 	 * @param capacity The desired capacity.
 	 * @memberof CommandQueue
@@ -173,6 +645,14 @@ struct CommandQueueInterface {
 	 */
 	void (*start)(CommandQueue *self);
 
+	/**
+	 * @fn CommandQueueStats CommandQueue::stats(const CommandQueue *self)
+	 * @param self The CommandQueue.
+	 * @return A snapshot of the statistics of this CommandQueue.
+	 * @memberof CommandQueue
+	 */
+	CommandQueueStats (*stats)(const CommandQueue *self);
+
 	/**
 	 * @fn void *CommandQueue::start(CommandQueue *self)
 	 * @brief Stops the worker Thread.
@@ -181,9 +661,27 @@ struct CommandQueueInterface {
 	 */
 	void (*stop)(CommandQueue *self);
 
+	/**
+	 * @fn void CommandQueue::waitForFence(const CommandQueue *self, CommandFence fence)
+	 * @brief Blocks the calling thread until the given CommandFence completes.
+	 * @param self The CommandQueue.
+	 * @param fence The CommandFence.
+	 * @memberof CommandQueue
+	 */
+	void (*waitForFence)(const CommandQueue *self, CommandFence fence);
+
+	/**
+	 * @fn void CommandQueue::waitForFrames(const CommandQueue *self)
+	 * @brief Blocks the calling thread until all submitted frames have executed.
+	 * @param self The CommandQueue.
+	 * @memberof CommandQueue
+	 */
+	void (*waitForFrames)(const CommandQueue *self);
+
 	/**
 	 * @fn void CommandQueue::waitUntilEmpty(const CommandQueue *self)
 	 * @brief Blocks the calling thread until this CommandQueue is empty.
+	 * @details Dequeued Commands that are still executing are waited for as well.
 	 * @param self The CommandQueueue.
 	 * @memberof CommandQueue
 	 */
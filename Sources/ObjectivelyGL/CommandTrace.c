@@ -0,0 +1,403 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CommandTrace.h"
+
+#define _Class _CommandTrace
+
+/**
+ * @brief A Command type, defined with `defineCommand`.
+ */
+typedef struct {
+	char *name;
+	Consumer consumer;
+	size_t size;
+	uint16_t id;
+	_Bool recorded;
+} CommandDefinition;
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	CommandTrace *this = (CommandTrace *) self;
+
+	CommandDefinition *definition = this->definitions->elements;
+	for (size_t i = 0; i < this->definitions->count; i++, definition++) {
+		free(definition->name);
+	}
+
+	release(this->data);
+	release(this->definitions);
+	release(this->lock);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - CommandTrace
+
+/**
+ * @return The CommandDefinition for the given Consumer, or `NULL`.
+ */
+static CommandDefinition *_definitionForConsumer(const CommandTrace *self, Consumer consumer) {
+
+	CommandDefinition *definition = self->definitions->elements;
+	for (size_t i = 0; i < self->definitions->count; i++, definition++) {
+		if (definition->consumer == consumer) {
+			return definition;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @return The CommandDefinition with the given name, or `NULL`.
+ */
+static const CommandDefinition *_definitionForName(const CommandTrace *self, const char *name) {
+
+	const CommandDefinition *definition = self->definitions->elements;
+	for (size_t i = 0; i < self->definitions->count; i++, definition++) {
+		if (strcmp(definition->name, name) == 0) {
+			return definition;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Appends a record and its payload to the trace.
+ * @remarks The caller must hold the Lock.
+ */
+static void _append(CommandTrace *self, CommandTraceRecordType type, uint16_t id, const void *payload, size_t size) {
+
+	const CommandTraceRecord record = {
+		.type = type,
+		.id = id,
+		.size = (uint32_t) size,
+		.time = CommandTime() - self->epoch
+	};
+
+	$(self->data, appendBytes, (const uint8_t *) &record, sizeof(record));
+
+	if (size) {
+		$(self->data, appendBytes, payload, size);
+	}
+}
+
+/**
+ * @fn void CommandTrace::defineCommand(CommandTrace *self, const char *name, Consumer consumer, size_t size)
+ * @memberof CommandTrace
+ */
+static void defineCommand(CommandTrace *self, const char *name, Consumer consumer, size_t size) {
+
+	assert(name);
+	assert(consumer);
+
+	CommandDefinition definition = {
+		.name = strdup(name),
+		.consumer = consumer,
+		.size = size
+	};
+
+	assert(definition.name);
+
+	synchronized(self->lock, {
+
+		assert(_definitionForName(self, name) == NULL);
+		assert(self->definitions->count < UINT16_MAX);
+
+		definition.id = (uint16_t) self->definitions->count;
+
+		$(self->definitions, addElement, &definition);
+	});
+}
+
+/**
+ * @fn CommandTrace *CommandTrace::init(CommandTrace *self)
+ * @memberof CommandTrace
+ */
+static CommandTrace *init(CommandTrace *self) {
+
+	self = (CommandTrace *) super(Object, self, init);
+	if (self) {
+		self->data = $(alloc(MutableData), init);
+		assert(self->data);
+
+		const CommandTraceHeader header = {
+			.magic = COMMAND_TRACE_MAGIC,
+			.version = COMMAND_TRACE_VERSION
+		};
+
+		$(self->data, appendBytes, (const uint8_t *) &header, sizeof(header));
+
+		self->definitions = $(alloc(Vector), initWithSize, sizeof(CommandDefinition));
+		assert(self->definitions);
+
+		self->lock = $(alloc(Lock), init);
+		assert(self->lock);
+
+		self->epoch = CommandTime();
+	}
+
+	return self;
+}
+
+/**
+ * @fn CommandTrace *CommandTrace::initWithData(CommandTrace *self, const Data *data)
+ * @memberof CommandTrace
+ */
+static CommandTrace *initWithData(CommandTrace *self, const Data *data) {
+
+	assert(data);
+
+	self = $(self, init);
+	if (self) {
+
+		if (data->length < sizeof(CommandTraceHeader)) {
+			return release(self);
+		}
+
+		CommandTraceHeader header;
+		memcpy(&header, data->bytes, sizeof(header));
+
+		if (header.magic != COMMAND_TRACE_MAGIC || header.version != COMMAND_TRACE_VERSION) {
+			return release(self);
+		}
+
+		$(self->data, setLength, 0);
+		$(self->data, appendBytes, data->bytes, data->length);
+	}
+
+	return self;
+}
+
+/**
+ * @fn void CommandTrace::record(CommandTrace *self, Consumer consumer, const ident data)
+ * @memberof CommandTrace
+ */
+static void record(CommandTrace *self, Consumer consumer, const ident data) {
+
+	synchronized(self->lock, {
+
+		CommandDefinition *definition = _definitionForConsumer(self, consumer);
+		if (definition) {
+
+			if (definition->recorded == false) {
+				_append(self, CommandTraceRecordDefine, definition->id, definition->name, strlen(definition->name) + 1);
+				definition->recorded = true;
+			}
+
+			assert(data || definition->size == 0);
+
+			_append(self, CommandTraceRecordCommand, definition->id, data, definition->size);
+			self->count++;
+		} else {
+			self->skipped++;
+		}
+	});
+}
+
+/**
+ * @fn void CommandTrace::recordFrame(CommandTrace *self, uint64_t frame)
+ * @memberof CommandTrace
+ */
+static void recordFrame(CommandTrace *self, uint64_t frame) {
+
+	synchronized(self->lock, {
+		_append(self, CommandTraceRecordFrame, 0, &frame, sizeof(frame));
+	});
+}
+
+/**
+ * @return The CommandDefinition in `definitions` with the given identifier, or `NULL`.
+ */
+static CommandDefinition *_definitionForId(const Vector *definitions, uint16_t id) {
+
+	CommandDefinition *definition = definitions->elements;
+	for (size_t i = 0; i < definitions->count; i++, definition++) {
+		if (definition->id == id) {
+			return definition;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn size_t CommandTrace::replay(const CommandTrace *self)
+ * @memberof CommandTrace
+ */
+static size_t replay(const CommandTrace *self) {
+
+	Data *data;
+
+	synchronized(self->lock, {
+		const Data *recorded = (Data *) self->data;
+		data = $(alloc(Data), initWithBytes, recorded->bytes, recorded->length);
+	});
+
+	assert(data);
+
+	const uint8_t *bytes = data->bytes + sizeof(CommandTraceHeader);
+	const uint8_t *end = data->bytes + data->length;
+
+	Vector *definitions = $(alloc(Vector), initWithSize, sizeof(CommandDefinition));
+	assert(definitions);
+
+	size_t count = 0, capacity = 0;
+	void *payload = NULL;
+
+	while (bytes + sizeof(CommandTraceRecord) <= end) {
+
+		CommandTraceRecord record;
+		memcpy(&record, bytes, sizeof(record));
+
+		bytes += sizeof(record);
+		if (bytes + record.size > end) {
+			break;
+		}
+
+		CommandDefinition *definition = _definitionForId(definitions, record.id);
+
+		switch (record.type) {
+			case CommandTraceRecordDefine: {
+
+				// definitions are copied, as they may be redefined while Commands execute
+
+				CommandDefinition defined = { .id = record.id };
+				if (record.size && bytes[record.size - 1] == '\0') {
+					synchronized(self->lock, {
+						const CommandDefinition *named = _definitionForName(self, (const char *) bytes);
+						if (named) {
+							defined.consumer = named->consumer;
+							defined.size = named->size;
+						}
+					});
+				}
+
+				if (definition) {
+					*definition = defined;
+				} else {
+					$(definitions, addElement, &defined);
+				}
+			}
+				break;
+
+			case CommandTraceRecordCommand: {
+				if (definition == NULL || definition->consumer == NULL || definition->size != record.size) {
+					break;
+				}
+
+				if (record.size > capacity) {
+					capacity = record.size;
+					payload = realloc(payload, capacity);
+					assert(payload);
+				}
+
+				memcpy(payload, bytes, record.size);
+
+				definition->consumer(record.size ? payload : NULL);
+				count++;
+			}
+				break;
+
+			default:
+				break;
+		}
+
+		bytes += record.size;
+	}
+
+	free(payload);
+	release(definitions);
+	release(data);
+
+	return count;
+}
+
+/**
+ * @fn _Bool CommandTrace::writeToFile(const CommandTrace *self, const char *path)
+ * @memberof CommandTrace
+ */
+static _Bool writeToFile(const CommandTrace *self, const char *path) {
+
+	_Bool success;
+
+	synchronized(self->lock, {
+		success = $((Data *) self->data, writeToFile, path);
+	});
+
+	return success;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((CommandTraceInterface *) clazz->interface)->defineCommand = defineCommand;
+	((CommandTraceInterface *) clazz->interface)->init = init;
+	((CommandTraceInterface *) clazz->interface)->initWithData = initWithData;
+	((CommandTraceInterface *) clazz->interface)->record = record;
+	((CommandTraceInterface *) clazz->interface)->recordFrame = recordFrame;
+	((CommandTraceInterface *) clazz->interface)->replay = replay;
+	((CommandTraceInterface *) clazz->interface)->writeToFile = writeToFile;
+}
+
+/**
+ * @fn Class *CommandTrace::_CommandTrace(void)
+ * @memberof CommandTrace
+ */
+Class *_CommandTrace(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "CommandTrace",
+			.superclass = _Object(),
+			.instanceSize = sizeof(CommandTrace),
+			.interfaceOffset = offsetof(CommandTrace, interface),
+			.interfaceSize = sizeof(CommandTraceInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
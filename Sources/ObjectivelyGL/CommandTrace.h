@@ -0,0 +1,271 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Lock.h>
+#include <Objectively/MutableData.h>
+#include <Objectively/Vector.h>
+
+#include <ObjectivelyGL/Command.h>
+
+/**
+ * @file
+ * @brief CommandTraces record executed Commands to a compact binary trace, and replay them.
+ * @details Commands are identified by the names given to their Consumers with _defineCommand_,
+ * so that a trace recorded by one process may be replayed by another, such as a headless build
+ * of the same application. Each Command type records a fixed size payload, copied from its data.
+ * Payloads must not contain pointers if the trace is to be replayed by another process.
+ *
+ * The trace begins with a CommandTraceHeader, and is followed by CommandTraceRecords, each
+ * followed by its payload. All values are in host byte order.
+ * @see CommandQueue::record(CommandQueue *, CommandTrace *)
+ */
+
+/**
+ * @brief The magic number identifying CommandTraces.
+ */
+#define COMMAND_TRACE_MAGIC 0x544c474f /* OGLT */
+
+/**
+ * @brief The CommandTrace format version.
+ */
+#define COMMAND_TRACE_VERSION 1
+
+/**
+ * @brief The CommandTrace header.
+ */
+typedef struct {
+
+	/**
+	 * @brief `COMMAND_TRACE_MAGIC`.
+	 */
+	uint32_t magic;
+
+	/**
+	 * @brief `COMMAND_TRACE_VERSION`.
+	 */
+	uint32_t version;
+
+} CommandTraceHeader;
+
+/**
+ * @brief CommandTraceRecord types.
+ */
+typedef enum {
+
+	/**
+	 * @brief Defines a Command type, whose payload is its NULL-terminated name.
+	 */
+	CommandTraceRecordDefine = 1,
+
+	/**
+	 * @brief An executed Command, whose payload is a copy of its data.
+	 */
+	CommandTraceRecordCommand,
+
+	/**
+	 * @brief Marks the beginning of a frame, whose payload is the `uint64_t` frame number.
+	 */
+	CommandTraceRecordFrame,
+
+} CommandTraceRecordType;
+
+/**
+ * @brief A CommandTrace record, followed by `size` bytes of payload.
+ */
+typedef struct {
+
+	/**
+	 * @brief The CommandTraceRecordType.
+	 */
+	uint8_t type;
+
+	/**
+	 * @private
+	 */
+	uint8_t reserved;
+
+	/**
+	 * @brief The Command type identifier.
+	 */
+	uint16_t id;
+
+	/**
+	 * @brief The payload size, in bytes.
+	 */
+	uint32_t size;
+
+	/**
+	 * @brief The time of the record, relative to the beginning of the trace, in nanoseconds.
+	 */
+	uint64_t time;
+
+} CommandTraceRecord;
+
+typedef struct CommandTrace CommandTrace;
+typedef struct CommandTraceInterface CommandTraceInterface;
+
+/**
+ * @brief The CommandTrace type.
+ * @extends Object
+ */
+struct CommandTrace {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	CommandTraceInterface *interface;
+
+	/**
+	 * @brief The binary trace.
+	 */
+	MutableData *data;
+
+	/**
+	 * @brief The Command definitions.
+	 * @private
+	 */
+	Vector *definitions;
+
+	/**
+	 * @private
+	 */
+	Lock *lock;
+
+	/**
+	 * @brief The time at which recording began.
+	 * @private
+	 */
+	uint64_t epoch;
+
+	/**
+	 * @brief The count of Commands recorded.
+	 */
+	size_t count;
+
+	/**
+	 * @brief The count of Commands not recorded, because their Consumers were not defined.
+	 */
+	size_t skipped;
+};
+
+/**
+ * @brief The CommandTrace interface.
+ */
+struct CommandTraceInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn void CommandTrace::defineCommand(CommandTrace *self, const char *name, Consumer consumer, size_t size)
+	 * @brief Defines a Command type, so that its Commands may be recorded and replayed.
+	 * @param self The CommandTrace.
+	 * @param name The unique name of the Command type.
+	 * @param consumer The Consumer.
+	 * @param size The size of the payload to copy from the Command's data, which may be `0`.
+	 * @memberof CommandTrace
+	 */
+	void (*defineCommand)(CommandTrace *self, const char *name, Consumer consumer, size_t size);
+
+	/**
+	 * @fn CommandTrace *CommandTrace::init(CommandTrace *self)
+	 * @brief Initializes this CommandTrace for recording.
+	 * @param self The CommandTrace.
+	 * @return The initialized CommandTrace, or `NULL` on error.
+	 * @memberof CommandTrace
+	 */
+	CommandTrace *(*init)(CommandTrace *self);
+
+	/**
+	 * @fn CommandTrace *CommandTrace::initWithData(CommandTrace *self, const Data *data)
+	 * @brief Initializes this CommandTrace with a previously recorded trace, for replay.
+	 * @param self The CommandTrace.
+	 * @param data The recorded trace.
+	 * @return The initialized CommandTrace, or `NULL` on error.
+	 * @memberof CommandTrace
+	 */
+	CommandTrace *(*initWithData)(CommandTrace *self, const Data *data);
+
+	/**
+	 * @fn void CommandTrace::record(CommandTrace *self, Consumer consumer, const ident data)
+	 * @brief Records the execution of a Command.
+	 * @details Commands whose Consumers are not defined are not recorded.
+	 * @param self The CommandTrace.
+	 * @param consumer The Consumer.
+	 * @param data The Command data, from which the payload is copied.
+	 * @remarks This method is thread safe.
+	 * @memberof CommandTrace
+	 */
+	void (*record)(CommandTrace *self, Consumer consumer, const ident data);
+
+	/**
+	 * @fn void CommandTrace::recordFrame(CommandTrace *self, uint64_t frame)
+	 * @brief Records the beginning of a frame.
+	 * @param self The CommandTrace.
+	 * @param frame The frame number.
+	 * @remarks This method is thread safe.
+	 * @memberof CommandTrace
+	 */
+	void (*recordFrame)(CommandTrace *self, uint64_t frame);
+
+	/**
+	 * @fn size_t CommandTrace::replay(const CommandTrace *self)
+	 * @brief Re-executes the recorded Commands, in order, on the calling thread.
+	 * @details Commands whose names are not defined by this CommandTrace, or whose payload sizes
+	 * do not match their definitions, are skipped. The trace is copied before it is replayed, so
+	 * Commands recorded meanwhile are not replayed.
+	 * @param self The CommandTrace.
+	 * @return The count of Commands executed.
+	 * @memberof CommandTrace
+	 */
+	size_t (*replay)(const CommandTrace *self);
+
+	/**
+	 * @fn _Bool CommandTrace::writeToFile(const CommandTrace *self, const char *path)
+	 * @brief Writes this CommandTrace to the specified file.
+	 * @param self The CommandTrace.
+	 * @param path The file path.
+	 * @return True on success, false on error.
+	 * @memberof CommandTrace
+	 */
+	_Bool (*writeToFile)(const CommandTrace *self, const char *path);
+};
+
+/**
+ * @fn Class *CommandTrace::_CommandTrace(void)
+ * @brief The CommandTrace archetype.
+ * @return The CommandTrace Class.
+ * @memberof CommandTrace
+ */
+OBJECTIVELYGL_EXPORT Class *_CommandTrace(void);
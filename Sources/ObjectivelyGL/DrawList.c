@@ -0,0 +1,338 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DrawList.h"
+#include "StateCache.h"
+
+#define _Class _DrawList
+
+/**
+ * @brief The bit widths and offsets of the fields of DrawItem sort keys.
+ */
+#define DRAW_KEY_DEPTH_BITS 20
+#define DRAW_KEY_VERTEX_ARRAY_BITS 12
+#define DRAW_KEY_MATERIAL_BITS 16
+#define DRAW_KEY_PROGRAM_BITS 12
+
+#define DRAW_KEY_VERTEX_ARRAY_SHIFT (DRAW_KEY_DEPTH_BITS)
+#define DRAW_KEY_MATERIAL_SHIFT (DRAW_KEY_VERTEX_ARRAY_SHIFT + DRAW_KEY_VERTEX_ARRAY_BITS)
+#define DRAW_KEY_PROGRAM_SHIFT (DRAW_KEY_MATERIAL_SHIFT + DRAW_KEY_MATERIAL_BITS)
+#define DRAW_KEY_PASS_SHIFT (DRAW_KEY_PROGRAM_SHIFT + DRAW_KEY_PROGRAM_BITS)
+
+#define DRAW_KEY_MASK(bits) ((1ull << (bits)) - 1)
+
+/**
+ * @brief A sort key and the index of its DrawItem.
+ */
+typedef struct {
+	uint64_t key;
+	size_t index;
+} DrawKey;
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	DrawList *this = (DrawList *) self;
+
+	release(this->items);
+	release(this->sorted);
+
+	free(this->keys);
+	free(this->scratch);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - DrawList
+
+/**
+ * @fn void DrawList::append(DrawList *self, const DrawItem *item)
+ * @memberof DrawList
+ */
+static void append(DrawList *self, const DrawItem *item) {
+
+	assert(item->pass <= DRAW_LIST_MAX_PASS);
+
+	$(self->items, addElement, (const ident) item);
+}
+
+/**
+ * @fn void DrawList::draw(DrawList *self)
+ * @memberof DrawList
+ */
+static void draw(DrawList *self) {
+
+	$(self, sort);
+
+	memset(&self->stats, 0, sizeof(self->stats));
+
+	const Program *program = NULL;
+	const VertexArray *vertexArray = NULL;
+	const Buffer *elementsBuffer = NULL;
+	const Texture *textures[DRAW_LIST_MAX_TEXTURES] = { NULL };
+
+	const DrawItem *item = self->items->elements;
+	for (size_t i = 0; i < self->items->count; i++, item++) {
+
+		if (item->program) {
+			if (item->program != program) {
+				$(item->program, use);
+				program = item->program;
+				self->stats.changes++;
+			} else {
+				self->stats.elided++;
+			}
+		}
+
+		if (item->vertexArray) {
+			if (item->vertexArray != vertexArray) {
+				$(item->vertexArray, bind);
+				vertexArray = item->vertexArray;
+				elementsBuffer = NULL;
+				self->stats.changes++;
+			} else {
+				self->stats.elided++;
+			}
+		}
+
+		if (item->elementsBuffer) {
+			if (item->elementsBuffer != elementsBuffer) {
+				$(item->elementsBuffer, bind, GL_ELEMENT_ARRAY_BUFFER);
+				elementsBuffer = item->elementsBuffer;
+				self->stats.changes++;
+			} else {
+				self->stats.elided++;
+			}
+		}
+
+		for (size_t j = 0; j < DRAW_LIST_MAX_TEXTURES; j++) {
+			if (item->textures[j]) {
+				if (item->textures[j] != textures[j]) {
+					$$(StateCache, currentActiveTexture, GL_TEXTURE0 + (GLenum) j);
+					$(item->textures[j], bind, GL_TEXTURE_2D);
+					textures[j] = item->textures[j];
+					self->stats.changes++;
+				} else {
+					self->stats.elided++;
+				}
+			}
+		}
+
+		if (item->function) {
+			item->function(item);
+		}
+
+		if (item->elementsBuffer) {
+			const GLvoid *offset = (GLvoid *) (item->mesh.elements * sizeof(GLuint));
+			glDrawElements(item->mesh.type, item->mesh.count, GL_UNSIGNED_INT, offset);
+		} else {
+			glDrawArrays(item->mesh.type, (GLint) item->mesh.elements, item->mesh.count);
+		}
+
+		self->stats.draws++;
+	}
+}
+
+/**
+ * @fn DrawList *DrawList::init(DrawList *self)
+ * @memberof DrawList
+ */
+static DrawList *init(DrawList *self) {
+
+	self = (DrawList *) super(Object, self, init);
+	if (self) {
+
+		self->items = $(alloc(Vector), initWithSize, sizeof(DrawItem));
+		assert(self->items);
+
+		self->sorted = $(alloc(Vector), initWithSize, sizeof(DrawItem));
+		assert(self->sorted);
+	}
+
+	return self;
+}
+
+/**
+ * @fn uint64_t DrawList::keyForItem(const DrawItem *item)
+ * @memberof DrawList
+ */
+static uint64_t keyForItem(const DrawItem *item) {
+
+	uint64_t key = (uint64_t) item->pass << DRAW_KEY_PASS_SHIFT;
+
+	if (item->program) {
+		key |= (item->program->name & DRAW_KEY_MASK(DRAW_KEY_PROGRAM_BITS)) << DRAW_KEY_PROGRAM_SHIFT;
+	}
+
+	uint32_t material = 0;
+	for (size_t i = 0; i < DRAW_LIST_MAX_TEXTURES; i++) {
+		if (item->textures[i]) {
+			material = (material ^ item->textures[i]->name) * 16777619u;
+		}
+	}
+
+	material ^= material >> DRAW_KEY_MATERIAL_BITS;
+	key |= (material & DRAW_KEY_MASK(DRAW_KEY_MATERIAL_BITS)) << DRAW_KEY_MATERIAL_SHIFT;
+
+	if (item->vertexArray) {
+		key |= (item->vertexArray->name & DRAW_KEY_MASK(DRAW_KEY_VERTEX_ARRAY_BITS)) << DRAW_KEY_VERTEX_ARRAY_SHIFT;
+	}
+
+	if (item->depth > 0.f) {
+		uint32_t depth;
+		memcpy(&depth, &item->depth, sizeof(depth));
+		key |= depth >> (32 - 1 - DRAW_KEY_DEPTH_BITS);
+	}
+
+	return key;
+}
+
+/**
+ * @fn void DrawList::reset(DrawList *self)
+ * @memberof DrawList
+ */
+static void reset(DrawList *self) {
+
+	$(self->items, removeAllElements);
+
+	memset(&self->stats, 0, sizeof(self->stats));
+}
+
+/**
+ * @fn void DrawList::sort(DrawList *self)
+ * @memberof DrawList
+ */
+static void sort(DrawList *self) {
+
+	const size_t count = self->items->count;
+	if (count < 2) {
+		return;
+	}
+
+	if (count > self->capacity) {
+		self->keys = realloc(self->keys, count * sizeof(DrawKey));
+		assert(self->keys);
+
+		self->scratch = realloc(self->scratch, count * sizeof(DrawKey));
+		assert(self->scratch);
+
+		self->capacity = count;
+	}
+
+	size_t histograms[sizeof(uint64_t)][256];
+	memset(histograms, 0, sizeof(histograms));
+
+	DrawKey *in = self->keys, *out = self->scratch;
+
+	const DrawItem *items = self->items->elements;
+	for (size_t i = 0; i < count; i++) {
+		const uint64_t key = keyForItem(&items[i]);
+		for (size_t j = 0; j < sizeof(uint64_t); j++) {
+			histograms[j][(key >> (j << 3)) & 0xff]++;
+		}
+		in[i] = (DrawKey) { .key = key, .index = i };
+	}
+
+	for (size_t j = 0; j < sizeof(uint64_t); j++) {
+		size_t *histogram = histograms[j];
+
+		const size_t shift = j << 3;
+		if (histogram[(in[0].key >> shift) & 0xff] == count) {
+			continue;
+		}
+
+		for (size_t k = 0, offset = 0; k < 256; k++) {
+			const size_t n = histogram[k];
+			histogram[k] = offset;
+			offset += n;
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			out[histogram[(in[i].key >> shift) & 0xff]++] = in[i];
+		}
+
+		DrawKey *swap = in;
+		in = out;
+		out = swap;
+	}
+
+	$(self->sorted, removeAllElements);
+
+	for (size_t i = 0; i < count; i++) {
+		$(self->sorted, addElement, (const ident) &items[in[i].index]);
+	}
+
+	Vector *swap = self->items;
+	self->items = self->sorted;
+	self->sorted = swap;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((DrawListInterface *) clazz->interface)->append = append;
+	((DrawListInterface *) clazz->interface)->draw = draw;
+	((DrawListInterface *) clazz->interface)->init = init;
+	((DrawListInterface *) clazz->interface)->keyForItem = keyForItem;
+	((DrawListInterface *) clazz->interface)->reset = reset;
+	((DrawListInterface *) clazz->interface)->sort = sort;
+}
+
+/**
+ * @fn Class *DrawList::_DrawList(void)
+ * @memberof DrawList
+ */
+Class *_DrawList(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "DrawList",
+			.superclass = _Object(),
+			.instanceSize = sizeof(DrawList),
+			.interfaceOffset = offsetof(DrawList, interface),
+			.interfaceSize = sizeof(DrawListInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
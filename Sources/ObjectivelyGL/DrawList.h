@@ -0,0 +1,258 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Vector.h>
+
+#include <ObjectivelyGL/Model.h>
+#include <ObjectivelyGL/Program.h>
+#include <ObjectivelyGL/Texture.h>
+
+/**
+ * @file
+ * @brief DrawLists sort draws by state to minimize state changes on submission.
+ * @details Each DrawItem is packed into a 64 bit sort key of pass, Program, material (Textures),
+ * VertexArray and depth, from most to least significant. Keys are radix sorted on the CPU, and
+ * the DrawItems are submitted in key order, binding only the state that differs from the previous
+ * draw.
+ *
+ * DrawLists are not thread safe. Typically, a DrawList is reset, populated and drawn once per frame.
+ */
+
+/**
+ * @brief The maximum count of Textures bound per DrawItem.
+ */
+#define DRAW_LIST_MAX_TEXTURES 4
+
+/**
+ * @brief The maximum pass of a DrawItem.
+ */
+#define DRAW_LIST_MAX_PASS 15
+
+typedef struct DrawItem DrawItem;
+
+/**
+ * @brief The function type for setting per-draw state, such as uniforms, of a DrawItem.
+ * @param item The DrawItem, after its Program, VertexArray and Textures are bound.
+ */
+typedef void (*DrawItemFunction)(const DrawItem *item);
+
+/**
+ * @brief A draw.
+ * @remarks The Program, VertexArray, Buffer and Textures are not retained, and must remain valid
+ * until the DrawList is drawn.
+ */
+struct DrawItem {
+
+	/**
+	 * @brief The pass, from `0` to `DRAW_LIST_MAX_PASS`. Lower passes are drawn first.
+	 */
+	GLuint pass;
+
+	/**
+	 * @brief The Program.
+	 */
+	const Program *program;
+
+	/**
+	 * @brief The VertexArray.
+	 */
+	const VertexArray *vertexArray;
+
+	/**
+	 * @brief The elements Buffer, bound to `GL_ELEMENT_ARRAY_BUFFER`.
+	 */
+	const Buffer *elementsBuffer;
+
+	/**
+	 * @brief The Textures, bound to `GL_TEXTURE_2D` of texture units `0` through
+	 * `DRAW_LIST_MAX_TEXTURES - 1`, or `NULL` to leave a texture unit unchanged.
+	 */
+	const Texture *textures[DRAW_LIST_MAX_TEXTURES];
+
+	/**
+	 * @brief The ModelMesh, describing the range of elements to draw.
+	 */
+	ModelMesh mesh;
+
+	/**
+	 * @brief The view depth. Within a pass, Program, material and VertexArray, nearer draws are
+	 * drawn first.
+	 * @remarks To draw back to front, e.g. for blended passes, use the distance to the far plane.
+	 */
+	float depth;
+
+	/**
+	 * @brief The DrawItemFunction, or `NULL`.
+	 */
+	DrawItemFunction function;
+
+	/**
+	 * @brief The user data.
+	 */
+	ident data;
+};
+
+/**
+ * @brief DrawList statistics for the most recent `draw`.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of draws issued.
+	 */
+	size_t draws;
+
+	/**
+	 * @brief The count of Program, VertexArray, Buffer and Texture binds issued.
+	 */
+	size_t changes;
+
+	/**
+	 * @brief The count of binds avoided because the previous draw shared the state.
+	 */
+	size_t elided;
+
+} DrawListStats;
+
+typedef struct DrawList DrawList;
+typedef struct DrawListInterface DrawListInterface;
+
+/**
+ * @brief The DrawList type.
+ * @extends Object
+ */
+struct DrawList {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	DrawListInterface *interface;
+
+	/**
+	 * @brief The DrawItems, in key order once sorted.
+	 */
+	Vector *items;
+
+	/**
+	 * @brief Storage for the DrawItems while sorting.
+	 * @private
+	 */
+	Vector *sorted;
+
+	/**
+	 * @brief The sort keys and their scratch space.
+	 * @private
+	 */
+	ident keys, scratch;
+
+	/**
+	 * @brief The capacity of the sort keys.
+	 * @private
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief The statistics.
+	 */
+	DrawListStats stats;
+};
+
+/**
+ * @brief The DrawList interface.
+ */
+struct DrawListInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn void DrawList::append(DrawList *self, const DrawItem *item)
+	 * @brief Appends a copy of the given DrawItem to this DrawList.
+	 * @param self The DrawList.
+	 * @param item The DrawItem.
+	 * @memberof DrawList
+	 */
+	void (*append)(DrawList *self, const DrawItem *item);
+
+	/**
+	 * @fn void DrawList::draw(DrawList *self)
+	 * @brief Sorts and draws the DrawItems of this DrawList, on the calling thread.
+	 * @param self The DrawList.
+	 * @remarks The DrawItems remain in this DrawList until it is reset.
+	 * @memberof DrawList
+	 */
+	void (*draw)(DrawList *self);
+
+	/**
+	 * @fn DrawList *DrawList::init(DrawList *self)
+	 * @brief Initializes this DrawList.
+	 * @param self The DrawList.
+	 * @return The initialized DrawList, or `NULL` on error.
+	 * @memberof DrawList
+	 */
+	DrawList *(*init)(DrawList *self);
+
+	/**
+	 * @fn uint64_t DrawList::keyForItem(const DrawItem *item)
+	 * @param item The DrawItem.
+	 * @return The sort key of the given DrawItem.
+	 * @memberof DrawList
+	 */
+	uint64_t (*keyForItem)(const DrawItem *item);
+
+	/**
+	 * @fn void DrawList::reset(DrawList *self)
+	 * @brief Removes all DrawItems from this DrawList, retaining its storage.
+	 * @param self The DrawList.
+	 * @memberof DrawList
+	 */
+	void (*reset)(DrawList *self);
+
+	/**
+	 * @fn void DrawList::sort(DrawList *self)
+	 * @brief Sorts the DrawItems of this DrawList by key.
+	 * @param self The DrawList.
+	 * @remarks The sort is stable, so DrawItems with equal keys are drawn in the order appended.
+	 * @memberof DrawList
+	 */
+	void (*sort)(DrawList *self);
+};
+
+/**
+ * @fn Class *DrawList::_DrawList(void)
+ * @brief The DrawList archetype.
+ * @return The DrawList Class.
+ * @memberof DrawList
+ */
+OBJECTIVELYGL_EXPORT Class *_DrawList(void);
@@ -0,0 +1,961 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FrameGraph.h"
+
+#define _Class _FrameGraph
+
+/**
+ * @brief A pass.
+ */
+typedef struct {
+
+	/**
+	 * @brief The name.
+	 */
+	char *name;
+
+	/**
+	 * @brief The FrameGraphPassFunction.
+	 */
+	FrameGraphPassFunction function;
+
+	/**
+	 * @brief The user data.
+	 */
+	ident data;
+
+	/**
+	 * @brief The FrameGraphPassFlags.
+	 */
+	FrameGraphPassFlags flags;
+
+	/**
+	 * @brief The count of resources written by this pass that are read, while compiling.
+	 */
+	size_t references;
+
+	/**
+	 * @brief True if this pass is never culled.
+	 */
+	_Bool pinned;
+
+	/**
+	 * @brief True if this pass is culled.
+	 */
+	_Bool culled;
+
+} FrameGraphPassEntry;
+
+/**
+ * @brief A resource.
+ */
+typedef struct {
+
+	/**
+	 * @brief The name.
+	 */
+	char *name;
+
+	/**
+	 * @brief The descriptor, if this is a transient Texture.
+	 */
+	FrameGraphTextureDescriptor descriptor;
+
+	/**
+	 * @brief The Texture, if this is an imported Texture or an acquired transient Texture.
+	 */
+	Texture *texture;
+
+	/**
+	 * @brief The Buffer, if this is an imported Buffer.
+	 */
+	Buffer *buffer;
+
+	/**
+	 * @brief True if this resource is imported, and retained.
+	 */
+	_Bool imported;
+
+	/**
+	 * @brief The count of passes reading this resource, while compiling.
+	 */
+	size_t references;
+
+	/**
+	 * @brief The first and last passes using this resource, or `-1`.
+	 */
+	FrameGraphPass first, last;
+
+	/**
+	 * @brief True if this resource was last written with incoherent access.
+	 */
+	_Bool incoherent;
+
+	/**
+	 * @brief The memory barrier bits issued since the last incoherent write.
+	 */
+	GLbitfield barriers;
+
+} FrameGraphResourceEntry;
+
+/**
+ * @brief A resource access.
+ */
+typedef struct {
+	FrameGraphPass pass;
+	FrameGraphResource resource;
+	FrameGraphAccess access;
+	_Bool write;
+} FrameGraphAccessEntry;
+
+#pragma mark - Object
+
+/**
+ * @brief Frees the names and imported resources of the given FrameGraph.
+ */
+static void _freeEntries(FrameGraph *self) {
+
+	FrameGraphPassEntry *pass = self->passes->elements;
+	for (size_t i = 0; i < self->passes->count; i++, pass++) {
+		free(pass->name);
+	}
+
+	FrameGraphResourceEntry *resource = self->resources->elements;
+	for (size_t i = 0; i < self->resources->count; i++, resource++) {
+		free(resource->name);
+		if (resource->imported) {
+			release(resource->texture);
+			release(resource->buffer);
+		}
+	}
+}
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	FrameGraph *this = (FrameGraph *) self;
+
+	_freeEntries(this);
+
+	release(this->passes);
+	release(this->resources);
+	release(this->accesses);
+	release(this->order);
+	release(this->pool);
+	release(this->framebuffer);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - FrameGraph
+
+/**
+ * @fn FrameGraphPass FrameGraph::addPass(FrameGraph *self, const char *name, FrameGraphPassFunction function, ident data, FrameGraphPassFlags flags)
+ * @memberof FrameGraph
+ */
+static FrameGraphPass addPass(FrameGraph *self, const char *name, FrameGraphPassFunction function, ident data, FrameGraphPassFlags flags) {
+
+	assert(function);
+
+	const FrameGraphPassEntry pass = {
+		.name = strdup(name ?: ""),
+		.function = function,
+		.data = data,
+		.flags = flags
+	};
+
+	$(self->passes, addElement, (const ident) &pass);
+
+	return (FrameGraphPass) self->passes->count - 1;
+}
+
+/**
+ * @return The FrameGraphResourceEntry of the given resource.
+ */
+static FrameGraphResourceEntry *_resource(const FrameGraph *self, FrameGraphResource resource) {
+
+	assert(resource >= 0 && (size_t) resource < self->resources->count);
+
+	return VectorElement(self->resources, FrameGraphResourceEntry, resource);
+}
+
+/**
+ * @return The FrameGraphPassEntry of the given pass.
+ */
+static FrameGraphPassEntry *_pass(const FrameGraph *self, FrameGraphPass pass) {
+
+	assert(pass >= 0 && (size_t) pass < self->passes->count);
+
+	return VectorElement(self->passes, FrameGraphPassEntry, pass);
+}
+
+/**
+ * @fn Buffer *FrameGraph::bufferForResource(const FrameGraph *self, FrameGraphResource resource)
+ * @memberof FrameGraph
+ */
+static Buffer *bufferForResource(const FrameGraph *self, FrameGraphResource resource) {
+	return _resource(self, resource)->buffer;
+}
+
+/**
+ * @return True if the given pass writes the given resource.
+ */
+static _Bool _writes(const FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource) {
+
+	const FrameGraphAccessEntry *access = self->accesses->elements;
+	for (size_t i = 0; i < self->accesses->count; i++, access++) {
+		if (access->pass == pass && access->resource == resource && access->write) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @return True if the given pass reads the given resource.
+ */
+static _Bool _reads(const FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource) {
+
+	const FrameGraphAccessEntry *access = self->accesses->elements;
+	for (size_t i = 0; i < self->accesses->count; i++, access++) {
+		if (access->pass == pass && access->resource == resource && access->write == false) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Culls the given pass, releasing its references to the resources it reads.
+ * @param stack The stack of resources no longer read, to which resources are pushed.
+ * @param count The count of resources on the stack.
+ */
+static void _cull(FrameGraph *self, FrameGraphPass pass, FrameGraphResource *stack, size_t *count) {
+
+	_pass(self, pass)->culled = true;
+
+	const FrameGraphAccessEntry *access = self->accesses->elements;
+	for (size_t i = 0; i < self->accesses->count; i++, access++) {
+		if (access->pass == pass && access->write == false) {
+			if (_writes(self, pass, access->resource)) {
+				continue;
+			}
+
+			FrameGraphResourceEntry *resource = _resource(self, access->resource);
+			if (--resource->references == 0 && resource->imported == false) {
+				stack[(*count)++] = access->resource;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Orders the given passes, `from` before `to`, in the given adjacency matrix.
+ */
+static void _depend(_Bool *edges, size_t count, FrameGraphPass from, FrameGraphPass to) {
+
+	if (from != -1 && from != to) {
+		edges[from * count + to] = true;
+	}
+}
+
+/**
+ * @brief Culls the passes that could not be sorted, because they depend on a cycle.
+ * @param sorted The passes that were sorted.
+ */
+static void _cullCycles(FrameGraph *self, const _Bool *sorted) {
+
+	FrameGraphPassEntry *pass = self->passes->elements;
+	for (size_t i = 0; i < self->passes->count; i++, pass++) {
+		if (pass->culled == false && sorted[i] == false) {
+			fprintf(stderr, "FrameGraph: culling pass %s, which depends on a cycle\n", pass->name);
+
+			pass->culled = true;
+
+			self->stats.passes--;
+			self->stats.culled++;
+		}
+	}
+}
+
+/**
+ * @brief Sorts the passes that are not culled into execution order.
+ * @details Dependencies between passes are derived from their accesses of each resource in
+ * declaration order, and the passes are then sorted topologically, preferring the pass declared
+ * first among those that are ready.
+ */
+static void _sort(FrameGraph *self) {
+
+	const FrameGraphPassEntry *passes = self->passes->elements;
+	const FrameGraphResourceEntry *resources = self->resources->elements;
+
+	const size_t count = self->passes->count;
+
+	_Bool *edges = calloc(count * count + 1, sizeof(_Bool));
+	assert(edges);
+
+	FrameGraphPass *readers = calloc(count + 1, sizeof(FrameGraphPass));
+	assert(readers);
+
+	FrameGraphPass *early = calloc(count + 1, sizeof(FrameGraphPass));
+	assert(early);
+
+	for (size_t i = 0; i < self->resources->count; i++) {
+		const FrameGraphResource resource = (FrameGraphResource) i;
+
+		FrameGraphPass writer = -1;
+		size_t numReaders = 0, numEarly = 0;
+
+		for (size_t j = 0; j < count; j++) {
+			const FrameGraphPass pass = (FrameGraphPass) j;
+			if (passes[j].culled) {
+				continue;
+			}
+
+			const _Bool writes = _writes(self, pass, resource);
+
+			if (_reads(self, pass, resource)) {
+				if (writer == -1 && resources[i].imported == false) {
+					if (writes == false) {
+						early[numEarly++] = pass;
+					}
+				} else {
+					_depend(edges, count, writer, pass);
+					readers[numReaders++] = pass;
+				}
+			}
+
+			if (writes) {
+				_depend(edges, count, writer, pass);
+				for (size_t k = 0; k < numReaders; k++) {
+					_depend(edges, count, readers[k], pass);
+				}
+				numReaders = 0;
+				writer = pass;
+			}
+		}
+
+		// transient reads declared before any write read the final write
+
+		for (size_t k = 0; k < numEarly; k++) {
+			_depend(edges, count, writer, early[k]);
+		}
+	}
+
+	free(early);
+	free(readers);
+
+	size_t *dependencies = calloc(count + 1, sizeof(size_t));
+	assert(dependencies);
+
+	for (size_t i = 0; i < count; i++) {
+		for (size_t j = 0; j < count; j++) {
+			if (edges[i * count + j]) {
+				dependencies[j]++;
+			}
+		}
+	}
+
+	_Bool *sorted = calloc(count + 1, sizeof(_Bool));
+	assert(sorted);
+
+	$(self->order, removeAllElements);
+
+	for (size_t n = 0; n < self->stats.passes; n++) {
+
+		size_t i;
+		for (i = 0; i < count; i++) {
+			if (passes[i].culled == false && sorted[i] == false && dependencies[i] == 0) {
+				break;
+			}
+		}
+
+		if (i == count) {
+			_cullCycles(self, sorted);
+			break;
+		}
+
+		const FrameGraphPass pass = (FrameGraphPass) i;
+		$(self->order, addElement, (const ident) &pass);
+		sorted[i] = true;
+
+		for (size_t j = 0; j < count; j++) {
+			if (edges[i * count + j]) {
+				dependencies[j]--;
+			}
+		}
+	}
+
+	free(sorted);
+	free(dependencies);
+	free(edges);
+}
+
+/**
+ * @fn void FrameGraph::compile(FrameGraph *self)
+ * @memberof FrameGraph
+ */
+static void compile(FrameGraph *self) {
+
+	FrameGraphPassEntry *passes = self->passes->elements;
+	FrameGraphResourceEntry *resources = self->resources->elements;
+
+	for (size_t i = 0; i < self->passes->count; i++) {
+		passes[i].references = 0;
+		passes[i].pinned = passes[i].flags & FrameGraphPassSideEffects;
+		passes[i].culled = false;
+	}
+
+	for (size_t i = 0; i < self->resources->count; i++) {
+		resources[i].references = 0;
+		resources[i].first = resources[i].last = -1;
+	}
+
+	const FrameGraphAccessEntry *accesses = self->accesses->elements;
+	for (size_t i = 0; i < self->accesses->count; i++) {
+		const FrameGraphAccessEntry *access = &accesses[i];
+
+		if (access->write) {
+			passes[access->pass].references++;
+			if (resources[access->resource].imported) {
+				passes[access->pass].pinned = true;
+			}
+		} else if (_writes(self, access->pass, access->resource) == false) {
+			resources[access->resource].references++;
+		}
+	}
+
+	FrameGraphResource *stack = calloc(self->resources->count + 1, sizeof(FrameGraphResource));
+	assert(stack);
+
+	size_t count = 0;
+
+	for (size_t i = 0; i < self->resources->count; i++) {
+		if (resources[i].references == 0 && resources[i].imported == false) {
+			stack[count++] = (FrameGraphResource) i;
+		}
+	}
+
+	for (size_t i = 0; i < self->passes->count; i++) {
+		if (passes[i].references == 0 && passes[i].pinned == false) {
+			_cull(self, (FrameGraphPass) i, stack, &count);
+		}
+	}
+
+	while (count) {
+		const FrameGraphResource resource = stack[--count];
+
+		for (size_t i = 0; i < self->accesses->count; i++) {
+			const FrameGraphAccessEntry *access = &accesses[i];
+			if (access->resource == resource && access->write) {
+
+				FrameGraphPassEntry *pass = &passes[access->pass];
+				if (pass->culled || pass->pinned) {
+					continue;
+				}
+
+				if (--pass->references == 0) {
+					_cull(self, access->pass, stack, &count);
+				}
+			}
+		}
+	}
+
+	free(stack);
+
+	self->stats.passes = self->stats.culled = 0;
+
+	for (size_t i = 0; i < self->passes->count; i++) {
+		if (passes[i].culled) {
+			self->stats.culled++;
+		} else {
+			self->stats.passes++;
+		}
+	}
+
+	_sort(self);
+
+	_Bool *written = calloc(self->resources->count + 1, sizeof(_Bool));
+	assert(written);
+
+	const FrameGraphPass *order = self->order->elements;
+	for (size_t i = 0; i < self->order->count; i++) {
+		const FrameGraphPass pass = order[i];
+
+		for (size_t j = 0; j < self->accesses->count; j++) {
+			const FrameGraphAccessEntry *access = &accesses[j];
+			if (access->pass != pass) {
+				continue;
+			}
+
+			FrameGraphResourceEntry *resource = &resources[access->resource];
+			if (resource->first == -1) {
+				resource->first = pass;
+			}
+
+			resource->last = pass;
+
+			if (access->write) {
+				written[access->resource] = true;
+			} else if (resource->imported == false && _writes(self, pass, access->resource) == false) {
+				assert(written[access->resource]);
+			}
+		}
+	}
+
+	free(written);
+}
+
+/**
+ * @fn FrameGraphResource FrameGraph::createTexture(FrameGraph *self, const char *name, const FrameGraphTextureDescriptor *descriptor)
+ * @memberof FrameGraph
+ */
+static FrameGraphResource createTexture(FrameGraph *self, const char *name, const FrameGraphTextureDescriptor *descriptor) {
+
+	assert(descriptor->width > 0 && descriptor->height > 0 && descriptor->levels > 0);
+
+	const FrameGraphResourceEntry resource = {
+		.name = strdup(name ?: ""),
+		.descriptor = *descriptor,
+		.first = -1,
+		.last = -1
+	};
+
+	$(self->resources, addElement, (const ident) &resource);
+
+	return (FrameGraphResource) self->resources->count - 1;
+}
+
+/**
+ * @brief Acquires a Texture from the pool for the given transient resource.
+ * @return The size of the acquired Texture, in bytes.
+ */
+static GLsizeiptr _acquire(FrameGraph *self, FrameGraphResourceEntry *resource) {
+
+	const FrameGraphTextureDescriptor *descriptor = &resource->descriptor;
+
+	RenderTargetDescriptor target = MakeRenderTargetDescriptor(descriptor->width, descriptor->height, descriptor->internalFormat, 0);
+	target.levels = descriptor->levels;
+
+	resource->texture = $(self->pool, acquireTexture, &target);
+
+	return resource->texture->size;
+}
+
+/**
+ * @brief Returns the Texture of the given transient resource to the pool.
+ * @return The size of the returned Texture, in bytes.
+ */
+static GLsizeiptr _relinquish(FrameGraph *self, FrameGraphResourceEntry *resource) {
+
+	const GLsizeiptr size = resource->texture->size;
+
+	$(self->pool, relinquish, resource->texture);
+	resource->texture = NULL;
+
+	return size;
+}
+
+/**
+ * @return The memory barrier bits required to access a resource with the given access after
+ * incoherent writes.
+ */
+static GLbitfield _barrierForAccess(FrameGraphAccess access) {
+
+	switch (access) {
+		case FrameGraphAccessAttachment:
+			return GL_FRAMEBUFFER_BARRIER_BIT;
+		case FrameGraphAccessSampled:
+			return GL_TEXTURE_FETCH_BARRIER_BIT;
+		case FrameGraphAccessImage:
+			return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+		case FrameGraphAccessStorage:
+			return GL_SHADER_STORAGE_BARRIER_BIT;
+		case FrameGraphAccessUniform:
+			return GL_UNIFORM_BARRIER_BIT;
+		case FrameGraphAccessVertex:
+			return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT;
+		case FrameGraphAccessIndirect:
+			return GL_COMMAND_BARRIER_BIT;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Binds the framebuffer for the given pass, attaching the Textures it accesses as
+ * attachments, or the default framebuffer if it has none.
+ * @details The viewport is sized to the transient attachments, if any, and is otherwise the given
+ * viewport.
+ */
+static void _bindFramebuffer(FrameGraph *self, FrameGraphPass pass, const GLint *viewport) {
+
+	Texture *colors[FRAME_GRAPH_MAX_COLOR_ATTACHMENTS] = { NULL };
+	const FrameGraphResourceEntry *depth = NULL, *extent = NULL;
+	GLsizei count = 0;
+
+	const FrameGraphAccessEntry *access = self->accesses->elements;
+	for (size_t i = 0; i < self->accesses->count; i++, access++) {
+		if (access->pass != pass || access->access != FrameGraphAccessAttachment) {
+			continue;
+		}
+
+		const FrameGraphResourceEntry *resource = _resource(self, access->resource);
+		assert(resource->texture);
+
+		GLenum internalFormat = resource->descriptor.internalFormat;
+		if (resource->imported) {
+			internalFormat = resource->texture->internalFormat;
+		} else {
+			extent = resource;
+		}
+
+		if ($$(Framebuffer, attachmentForInternalFormat, internalFormat) == GL_COLOR_ATTACHMENT0) {
+			size_t j;
+			for (j = 0; j < (size_t) count; j++) {
+				if (colors[j] == resource->texture) {
+					break;
+				}
+			}
+			if (j == (size_t) count) {
+				assert(count < FRAME_GRAPH_MAX_COLOR_ATTACHMENTS);
+				colors[count++] = resource->texture;
+			}
+		} else {
+			depth = resource;
+		}
+	}
+
+	if (count == 0 && depth == NULL) {
+		$(self->framebuffer, unbind, GL_FRAMEBUFFER);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		return;
+	}
+
+	GLenum buffers[FRAME_GRAPH_MAX_COLOR_ATTACHMENTS];
+	for (GLsizei i = 0; i < FRAME_GRAPH_MAX_COLOR_ATTACHMENTS; i++) {
+		if (colors[i] || self->framebuffer->attachments[i]) {
+			$(self->framebuffer, attachTexture, GL_COLOR_ATTACHMENT0 + i, colors[i], 0);
+		}
+		buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+	}
+
+	$(self->framebuffer, attachTexture, GL_DEPTH_STENCIL_ATTACHMENT, NULL, 0);
+	if (depth) {
+		const GLenum internalFormat = depth->imported ? (GLenum) depth->texture->internalFormat : depth->descriptor.internalFormat;
+		const GLenum attachment = $$(Framebuffer, attachmentForInternalFormat, internalFormat);
+
+		$(self->framebuffer, attachTexture, attachment, depth->texture, 0);
+	}
+
+	$(self->framebuffer, drawBuffers, count, buffers);
+	$(self->framebuffer, bind, GL_FRAMEBUFFER);
+
+	if (extent) {
+		glViewport(0, 0, extent->descriptor.width, extent->descriptor.height);
+	} else {
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+
+	assert($(self->framebuffer, checkStatus) == GL_FRAMEBUFFER_COMPLETE);
+}
+
+/**
+ * @fn void FrameGraph::execute(FrameGraph *self)
+ * @memberof FrameGraph
+ */
+static void execute(FrameGraph *self) {
+
+	$(self, compile);
+
+	self->frame++;
+
+	self->stats.barriers = 0;
+	self->stats.transientBytes = 0;
+	self->stats.peakBytes = 0;
+
+	GLsizeiptr bytes = 0;
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	FrameGraphResourceEntry *resources = self->resources->elements;
+	const FrameGraphAccessEntry *accesses = self->accesses->elements;
+
+	const FrameGraphPass *order = self->order->elements;
+	for (size_t i = 0; i < self->order->count; i++) {
+		const FrameGraphPass p = order[i];
+
+		const FrameGraphPassEntry *pass = _pass(self, p);
+
+		for (size_t j = 0; j < self->resources->count; j++) {
+			FrameGraphResourceEntry *resource = &resources[j];
+			if (resource->first == p && resource->imported == false) {
+				const GLsizeiptr size = _acquire(self, resource);
+
+				self->stats.transientBytes += size;
+				bytes += size;
+
+				self->stats.peakBytes = max(self->stats.peakBytes, bytes);
+			}
+		}
+
+		GLbitfield barriers = 0;
+		for (size_t j = 0; j < self->accesses->count; j++) {
+			const FrameGraphAccessEntry *access = &accesses[j];
+			if (access->pass == p) {
+				FrameGraphResourceEntry *resource = &resources[access->resource];
+				if (resource->incoherent) {
+					const GLbitfield bits = _barrierForAccess(access->access) & ~resource->barriers;
+					resource->barriers |= bits;
+					barriers |= bits;
+				}
+			}
+		}
+
+		if (barriers && glMemoryBarrier) {
+			glMemoryBarrier(barriers);
+			self->stats.barriers++;
+		}
+
+		_bindFramebuffer(self, p, viewport);
+
+		pass->function(self, pass->data);
+
+		for (size_t j = 0; j < self->accesses->count; j++) {
+			const FrameGraphAccessEntry *access = &accesses[j];
+			if (access->pass == p && access->write) {
+				FrameGraphResourceEntry *resource = &resources[access->resource];
+				switch (access->access) {
+					case FrameGraphAccessImage:
+					case FrameGraphAccessStorage:
+						resource->incoherent = true;
+						resource->barriers = 0;
+						break;
+					default:
+						break;
+				}
+			}
+		}
+
+		for (size_t j = 0; j < self->resources->count; j++) {
+			FrameGraphResourceEntry *resource = &resources[j];
+			if (resource->last == p && resource->imported == false) {
+				bytes -= _relinquish(self, resource);
+			}
+		}
+	}
+
+	$(self->framebuffer, detachAll);
+	$(self->framebuffer, unbind, GL_FRAMEBUFFER);
+
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+/**
+ * @brief Adds an imported resource to the given FrameGraph.
+ */
+static FrameGraphResource _import(FrameGraph *self, const char *name, Texture *texture, Buffer *buffer) {
+
+	const FrameGraphResourceEntry resource = {
+		.name = strdup(name ?: ""),
+		.texture = texture ? retain(texture) : NULL,
+		.buffer = buffer ? retain(buffer) : NULL,
+		.imported = true,
+		.first = -1,
+		.last = -1
+	};
+
+	$(self->resources, addElement, (const ident) &resource);
+
+	return (FrameGraphResource) self->resources->count - 1;
+}
+
+/**
+ * @fn FrameGraphResource FrameGraph::importBuffer(FrameGraph *self, const char *name, Buffer *buffer)
+ * @memberof FrameGraph
+ */
+static FrameGraphResource importBuffer(FrameGraph *self, const char *name, Buffer *buffer) {
+
+	assert(buffer);
+
+	return _import(self, name, NULL, buffer);
+}
+
+/**
+ * @fn FrameGraphResource FrameGraph::importTexture(FrameGraph *self, const char *name, Texture *texture)
+ * @memberof FrameGraph
+ */
+static FrameGraphResource importTexture(FrameGraph *self, const char *name, Texture *texture) {
+
+	assert(texture);
+
+	return _import(self, name, texture, NULL);
+}
+
+/**
+ * @fn FrameGraph *FrameGraph::init(FrameGraph *self)
+ * @memberof FrameGraph
+ */
+static FrameGraph *init(FrameGraph *self) {
+
+	self = (FrameGraph *) super(Object, self, init);
+	if (self) {
+
+		self->passes = $(alloc(Vector), initWithSize, sizeof(FrameGraphPassEntry));
+		assert(self->passes);
+
+		self->resources = $(alloc(Vector), initWithSize, sizeof(FrameGraphResourceEntry));
+		assert(self->resources);
+
+		self->accesses = $(alloc(Vector), initWithSize, sizeof(FrameGraphAccessEntry));
+		assert(self->accesses);
+
+		self->order = $(alloc(Vector), initWithSize, sizeof(FrameGraphPass));
+		assert(self->order);
+
+		self->pool = $(alloc(RenderTargetPool), init);
+		assert(self->pool);
+
+		self->framebuffer = $(alloc(Framebuffer), init);
+		assert(self->framebuffer);
+	}
+
+	return self;
+}
+
+/**
+ * @brief Declares an access of the given resource by the given pass.
+ */
+static void _access(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access, _Bool write) {
+
+	_pass(self, pass);
+	_resource(self, resource);
+
+	const FrameGraphAccessEntry entry = {
+		.pass = pass,
+		.resource = resource,
+		.access = access,
+		.write = write
+	};
+
+	$(self->accesses, addElement, (const ident) &entry);
+}
+
+/**
+ * @fn void FrameGraph::read(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access)
+ * @memberof FrameGraph
+ */
+static void read(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access) {
+	_access(self, pass, resource, access, false);
+}
+
+/**
+ * @fn void FrameGraph::reset(FrameGraph *self)
+ * @memberof FrameGraph
+ */
+static void reset(FrameGraph *self) {
+
+	_freeEntries(self);
+
+	$(self->passes, removeAllElements);
+	$(self->resources, removeAllElements);
+	$(self->accesses, removeAllElements);
+	$(self->order, removeAllElements);
+
+	$(self->pool, nextFrame);
+}
+
+/**
+ * @fn Texture *FrameGraph::textureForResource(const FrameGraph *self, FrameGraphResource resource)
+ * @memberof FrameGraph
+ */
+static Texture *textureForResource(const FrameGraph *self, FrameGraphResource resource) {
+	return _resource(self, resource)->texture;
+}
+
+/**
+ * @fn void FrameGraph::write(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access)
+ * @memberof FrameGraph
+ */
+static void write(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access) {
+	_access(self, pass, resource, access, true);
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((FrameGraphInterface *) clazz->interface)->addPass = addPass;
+	((FrameGraphInterface *) clazz->interface)->bufferForResource = bufferForResource;
+	((FrameGraphInterface *) clazz->interface)->compile = compile;
+	((FrameGraphInterface *) clazz->interface)->createTexture = createTexture;
+	((FrameGraphInterface *) clazz->interface)->execute = execute;
+	((FrameGraphInterface *) clazz->interface)->importBuffer = importBuffer;
+	((FrameGraphInterface *) clazz->interface)->importTexture = importTexture;
+	((FrameGraphInterface *) clazz->interface)->init = init;
+	((FrameGraphInterface *) clazz->interface)->read = read;
+	((FrameGraphInterface *) clazz->interface)->reset = reset;
+	((FrameGraphInterface *) clazz->interface)->textureForResource = textureForResource;
+	((FrameGraphInterface *) clazz->interface)->write = write;
+}
+
+/**
+ * @fn Class *FrameGraph::_FrameGraph(void)
+ * @memberof FrameGraph
+ */
+Class *_FrameGraph(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "FrameGraph",
+			.superclass = _Object(),
+			.instanceSize = sizeof(FrameGraph),
+			.interfaceOffset = offsetof(FrameGraph, interface),
+			.interfaceSize = sizeof(FrameGraphInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
@@ -0,0 +1,397 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Vector.h>
+
+#include <ObjectivelyGL/Buffer.h>
+#include <ObjectivelyGL/Framebuffer.h>
+#include <ObjectivelyGL/RenderTargetPool.h>
+
+/**
+ * @file
+ * @brief FrameGraphs schedule render passes and their transient resources.
+ * @details Each frame, passes are added to a FrameGraph, and declare the resources they read and
+ * write. When the FrameGraph is executed, passes whose results are never read are culled, and the
+ * remaining passes are sorted so that each pass follows the passes that write the resources it
+ * reads, and otherwise executed in declaration order. Transient Textures are acquired from a
+ * RenderTargetPool when first used, and returned to it after last use, so that Textures whose
+ * lifetimes do not overlap share memory. Memory barriers are issued between passes that write with image or
+ * shader storage access and the passes that read those writes.
+ *
+ * FrameGraphs are not thread safe, and must be executed on the thread that owns the GL context.
+ */
+
+/**
+ * @brief The maximum count of color attachments bound for a pass.
+ */
+#define FRAME_GRAPH_MAX_COLOR_ATTACHMENTS FRAMEBUFFER_MAX_COLOR_ATTACHMENTS
+
+/**
+ * @brief A handle to a FrameGraph resource.
+ */
+typedef int FrameGraphResource;
+
+/**
+ * @brief A handle to a FrameGraph pass.
+ */
+typedef int FrameGraphPass;
+
+/**
+ * @brief The ways in which a pass may access a resource.
+ */
+typedef enum {
+
+	/**
+	 * @brief The Texture is a framebuffer attachment.
+	 */
+	FrameGraphAccessAttachment,
+
+	/**
+	 * @brief The Texture is sampled.
+	 */
+	FrameGraphAccessSampled,
+
+	/**
+	 * @brief The Texture is accessed with image load and store.
+	 */
+	FrameGraphAccessImage,
+
+	/**
+	 * @brief The Buffer is accessed as a shader storage buffer.
+	 */
+	FrameGraphAccessStorage,
+
+	/**
+	 * @brief The Buffer is accessed as a uniform buffer.
+	 */
+	FrameGraphAccessUniform,
+
+	/**
+	 * @brief The Buffer is accessed as a vertex or element buffer.
+	 */
+	FrameGraphAccessVertex,
+
+	/**
+	 * @brief The Buffer is accessed as an indirect command buffer.
+	 */
+	FrameGraphAccessIndirect,
+
+} FrameGraphAccess;
+
+/**
+ * @brief Pass flags.
+ */
+typedef enum {
+
+	/**
+	 * @brief No flags.
+	 */
+	FrameGraphPassNone = 0,
+
+	/**
+	 * @brief The pass has effects outside of the FrameGraph, e.g. drawing to the default
+	 * framebuffer, and is never culled.
+	 */
+	FrameGraphPassSideEffects = 1,
+
+} FrameGraphPassFlags;
+
+/**
+ * @brief The descriptor of a transient FrameGraph Texture.
+ */
+typedef struct {
+
+	/**
+	 * @brief The width and height.
+	 */
+	GLsizei width, height;
+
+	/**
+	 * @brief The sized internal format, e.g. `GL_RGBA16F` or `GL_DEPTH_COMPONENT24`.
+	 */
+	GLenum internalFormat;
+
+	/**
+	 * @brief The count of mipmap levels.
+	 */
+	GLsizei levels;
+
+} FrameGraphTextureDescriptor;
+
+#define MakeFrameGraphTextureDescriptor(width, height, internalFormat) \
+	(FrameGraphTextureDescriptor) { (width), (height), (internalFormat), 1 }
+
+/**
+ * @brief FrameGraph statistics for the most recent `compile` and `execute`.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of passes executed.
+	 */
+	size_t passes;
+
+	/**
+	 * @brief The count of passes culled.
+	 */
+	size_t culled;
+
+	/**
+	 * @brief The count of memory barriers issued.
+	 */
+	size_t barriers;
+
+	/**
+	 * @brief The total size of the transient Textures used by executed passes, in bytes.
+	 */
+	GLsizeiptr transientBytes;
+
+	/**
+	 * @brief The peak size of the pooled Textures acquired at once, in bytes.
+	 * @remarks This is less than `transientBytes` when transient Textures are aliased.
+	 */
+	GLsizeiptr peakBytes;
+
+} FrameGraphStats;
+
+typedef struct FrameGraph FrameGraph;
+typedef struct FrameGraphInterface FrameGraphInterface;
+
+/**
+ * @brief The function type of FrameGraph passes.
+ * @param graph The FrameGraph.
+ * @param data The user data.
+ */
+typedef void (*FrameGraphPassFunction)(FrameGraph *graph, ident data);
+
+/**
+ * @brief The FrameGraph type.
+ * @extends Object
+ */
+struct FrameGraph {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	FrameGraphInterface *interface;
+
+	/**
+	 * @brief The passes.
+	 * @private
+	 */
+	Vector *passes;
+
+	/**
+	 * @brief The resources.
+	 * @private
+	 */
+	Vector *resources;
+
+	/**
+	 * @brief The resource accesses of all passes, in declaration order.
+	 * @private
+	 */
+	Vector *accesses;
+
+	/**
+	 * @brief The passes that are not culled, in execution order.
+	 * @private
+	 */
+	Vector *order;
+
+	/**
+	 * @brief The RenderTargetPool from which transient Textures are acquired.
+	 */
+	RenderTargetPool *pool;
+
+	/**
+	 * @brief The Framebuffer to which the attachments of each pass are attached.
+	 * @private
+	 */
+	Framebuffer *framebuffer;
+
+	/**
+	 * @brief The count of frames executed.
+	 */
+	uint64_t frame;
+
+	/**
+	 * @brief The statistics.
+	 */
+	FrameGraphStats stats;
+};
+
+/**
+ * @brief The FrameGraph interface.
+ */
+struct FrameGraphInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn FrameGraphPass FrameGraph::addPass(FrameGraph *self, const char *name, FrameGraphPassFunction function, ident data, FrameGraphPassFlags flags)
+	 * @brief Adds a pass to this FrameGraph.
+	 * @param self The FrameGraph.
+	 * @param name The pass name.
+	 * @param function The FrameGraphPassFunction.
+	 * @param data The user data.
+	 * @param flags The FrameGraphPassFlags.
+	 * @return The pass.
+	 * @memberof FrameGraph
+	 */
+	FrameGraphPass (*addPass)(FrameGraph *self, const char *name, FrameGraphPassFunction function, ident data, FrameGraphPassFlags flags);
+
+	/**
+	 * @fn Buffer *FrameGraph::bufferForResource(const FrameGraph *self, FrameGraphResource resource)
+	 * @param self The FrameGraph.
+	 * @param resource The resource.
+	 * @return The Buffer of the given resource, or `NULL`.
+	 * @memberof FrameGraph
+	 */
+	Buffer *(*bufferForResource)(const FrameGraph *self, FrameGraphResource resource);
+
+	/**
+	 * @fn void FrameGraph::compile(FrameGraph *self)
+	 * @brief Culls unused passes, sorts the remaining passes, and derives the lifetimes of
+	 * transient resources.
+	 * @param self The FrameGraph.
+	 * @remarks A read follows the most recent write of the resource by a pass declared before it.
+	 * Reads of a transient resource not written by an earlier pass follow its last writer. Writes
+	 * follow the earlier writes and reads of the resource. Every read of a transient resource must
+	 * follow a write of it. Passes with cyclic dependencies, and the passes that depend on them,
+	 * are logged and culled.
+	 * @remarks This is called by `execute`, and need not be called directly.
+	 * @memberof FrameGraph
+	 */
+	void (*compile)(FrameGraph *self);
+
+	/**
+	 * @fn FrameGraphResource FrameGraph::createTexture(FrameGraph *self, const char *name, const FrameGraphTextureDescriptor *descriptor)
+	 * @brief Creates a transient Texture, valid only while the passes that use it execute.
+	 * @param self The FrameGraph.
+	 * @param name The resource name.
+	 * @param descriptor The FrameGraphTextureDescriptor.
+	 * @return The resource.
+	 * @memberof FrameGraph
+	 */
+	FrameGraphResource (*createTexture)(FrameGraph *self, const char *name, const FrameGraphTextureDescriptor *descriptor);
+
+	/**
+	 * @fn void FrameGraph::execute(FrameGraph *self)
+	 * @brief Compiles and executes this FrameGraph on the calling thread.
+	 * @param self The FrameGraph.
+	 * @memberof FrameGraph
+	 */
+	void (*execute)(FrameGraph *self);
+
+	/**
+	 * @fn FrameGraphResource FrameGraph::importBuffer(FrameGraph *self, const char *name, Buffer *buffer)
+	 * @brief Imports a Buffer that outlives the frame. Passes that write it are never culled.
+	 * @param self The FrameGraph.
+	 * @param name The resource name.
+	 * @param buffer The Buffer.
+	 * @return The resource.
+	 * @memberof FrameGraph
+	 */
+	FrameGraphResource (*importBuffer)(FrameGraph *self, const char *name, Buffer *buffer);
+
+	/**
+	 * @fn FrameGraphResource FrameGraph::importTexture(FrameGraph *self, const char *name, Texture *texture)
+	 * @brief Imports a Texture that outlives the frame. Passes that write it are never culled.
+	 * @param self The FrameGraph.
+	 * @param name The resource name.
+	 * @param texture The Texture.
+	 * @return The resource.
+	 * @memberof FrameGraph
+	 */
+	FrameGraphResource (*importTexture)(FrameGraph *self, const char *name, Texture *texture);
+
+	/**
+	 * @fn FrameGraph *FrameGraph::init(FrameGraph *self)
+	 * @brief Initializes this FrameGraph.
+	 * @param self The FrameGraph.
+	 * @return The initialized FrameGraph, or `NULL` on error.
+	 * @memberof FrameGraph
+	 */
+	FrameGraph *(*init)(FrameGraph *self);
+
+	/**
+	 * @fn void FrameGraph::read(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access)
+	 * @brief Declares that the given pass reads the given resource.
+	 * @param self The FrameGraph.
+	 * @param pass The pass.
+	 * @param resource The resource.
+	 * @param access The FrameGraphAccess.
+	 * @memberof FrameGraph
+	 */
+	void (*read)(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access);
+
+	/**
+	 * @fn void FrameGraph::reset(FrameGraph *self)
+	 * @brief Removes all passes and resources from this FrameGraph, and advances its RenderTargetPool
+	 * to the next frame.
+	 * @param self The FrameGraph.
+	 * @memberof FrameGraph
+	 */
+	void (*reset)(FrameGraph *self);
+
+	/**
+	 * @fn Texture *FrameGraph::textureForResource(const FrameGraph *self, FrameGraphResource resource)
+	 * @param self The FrameGraph.
+	 * @param resource The resource.
+	 * @return The Texture of the given resource, or `NULL` if it is not currently allocated.
+	 * @memberof FrameGraph
+	 */
+	Texture *(*textureForResource)(const FrameGraph *self, FrameGraphResource resource);
+
+	/**
+	 * @fn void FrameGraph::write(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access)
+	 * @brief Declares that the given pass writes the given resource.
+	 * @param self The FrameGraph.
+	 * @param pass The pass.
+	 * @param resource The resource.
+	 * @param access The FrameGraphAccess.
+	 * @memberof FrameGraph
+	 */
+	void (*write)(FrameGraph *self, FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access);
+};
+
+/**
+ * @fn Class *FrameGraph::_FrameGraph(void)
+ * @brief The FrameGraph archetype.
+ * @return The FrameGraph Class.
+ * @memberof FrameGraph
+ */
+OBJECTIVELYGL_EXPORT Class *_FrameGraph(void);
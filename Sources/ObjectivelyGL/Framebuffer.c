@@ -0,0 +1,297 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+
+#include "Framebuffer.h"
+
+#define _Class _Framebuffer
+
+/**
+ * @return The index of the given attachment point in the Framebuffer's attachments.
+ */
+static size_t _index(GLenum attachment) {
+
+	switch (attachment) {
+		case GL_DEPTH_ATTACHMENT:
+			return FRAMEBUFFER_MAX_COLOR_ATTACHMENTS;
+		case GL_STENCIL_ATTACHMENT:
+			return FRAMEBUFFER_MAX_COLOR_ATTACHMENTS + 1;
+		case GL_DEPTH_STENCIL_ATTACHMENT:
+			return FRAMEBUFFER_MAX_COLOR_ATTACHMENTS + 2;
+		default:
+			assert(attachment >= GL_COLOR_ATTACHMENT0);
+			assert(attachment < GL_COLOR_ATTACHMENT0 + FRAMEBUFFER_MAX_COLOR_ATTACHMENTS);
+			return attachment - GL_COLOR_ATTACHMENT0;
+	}
+}
+
+/**
+ * @return The attachment point of the given index in the Framebuffer's attachments.
+ */
+static GLenum _attachment(size_t index) {
+
+	switch (index) {
+		case FRAMEBUFFER_MAX_COLOR_ATTACHMENTS:
+			return GL_DEPTH_ATTACHMENT;
+		case FRAMEBUFFER_MAX_COLOR_ATTACHMENTS + 1:
+			return GL_STENCIL_ATTACHMENT;
+		case FRAMEBUFFER_MAX_COLOR_ATTACHMENTS + 2:
+			return GL_DEPTH_STENCIL_ATTACHMENT;
+		default:
+			return GL_COLOR_ATTACHMENT0 + (GLenum) index;
+	}
+}
+
+/**
+ * @brief Retains the given object at the given attachment point, releasing the previous one.
+ */
+static void _retain(Framebuffer *self, GLenum attachment, Object *object) {
+
+	const size_t index = _index(attachment);
+
+	if (self->attachments[index] != object) {
+		release(self->attachments[index]);
+		self->attachments[index] = object ? retain(object) : NULL;
+	}
+
+	if (attachment == GL_DEPTH_STENCIL_ATTACHMENT) {
+		self->attachments[_index(GL_DEPTH_ATTACHMENT)] = release(self->attachments[_index(GL_DEPTH_ATTACHMENT)]);
+		self->attachments[_index(GL_STENCIL_ATTACHMENT)] = release(self->attachments[_index(GL_STENCIL_ATTACHMENT)]);
+	}
+}
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	Framebuffer *this = (Framebuffer *) self;
+
+	for (size_t i = 0; i < lengthof(this->attachments); i++) {
+		release(this->attachments[i]);
+	}
+
+	glDeleteFramebuffers(1, &this->name);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - Framebuffer
+
+/**
+ * @fn void Framebuffer::attachRenderbuffer(Framebuffer *self, GLenum attachment, Renderbuffer *renderbuffer)
+ * @memberof Framebuffer
+ */
+static void attachRenderbuffer(Framebuffer *self, GLenum attachment, Renderbuffer *renderbuffer) {
+
+	const GLuint name = renderbuffer ? renderbuffer->name : 0;
+
+	if (HasDirectStateAccess()) {
+		glNamedFramebufferRenderbuffer(self->name, attachment, GL_RENDERBUFFER, name);
+	} else {
+		$(self, bind, GL_FRAMEBUFFER);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, name);
+	}
+
+	_retain(self, attachment, (Object *) renderbuffer);
+}
+
+/**
+ * @fn void Framebuffer::attachTexture(Framebuffer *self, GLenum attachment, Texture *texture, GLint level)
+ * @memberof Framebuffer
+ */
+static void attachTexture(Framebuffer *self, GLenum attachment, Texture *texture, GLint level) {
+
+	const GLuint name = texture ? texture->name : 0;
+
+	if (HasDirectStateAccess()) {
+		glNamedFramebufferTexture(self->name, attachment, name, level);
+	} else {
+		$(self, bind, GL_FRAMEBUFFER);
+		glFramebufferTexture(GL_FRAMEBUFFER, attachment, name, level);
+	}
+
+	_retain(self, attachment, (Object *) texture);
+}
+
+/**
+ * @fn GLenum Framebuffer::attachmentForInternalFormat(GLenum internalFormat)
+ * @memberof Framebuffer
+ */
+static GLenum attachmentForInternalFormat(GLenum internalFormat) {
+
+	switch (internalFormat) {
+		case GL_DEPTH_COMPONENT:
+		case GL_DEPTH_COMPONENT16:
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32:
+		case GL_DEPTH_COMPONENT32F:
+			return GL_DEPTH_ATTACHMENT;
+		case GL_DEPTH_STENCIL:
+		case GL_DEPTH24_STENCIL8:
+		case GL_DEPTH32F_STENCIL8:
+			return GL_DEPTH_STENCIL_ATTACHMENT;
+		case GL_STENCIL_INDEX8:
+			return GL_STENCIL_ATTACHMENT;
+		default:
+			return GL_COLOR_ATTACHMENT0;
+	}
+}
+
+/**
+ * @fn void Framebuffer::bind(const Framebuffer *self, GLenum target)
+ * @memberof Framebuffer
+ */
+static void bind(const Framebuffer *self, GLenum target) {
+	glBindFramebuffer(target, self->name);
+}
+
+/**
+ * @fn GLenum Framebuffer::checkStatus(const Framebuffer *self)
+ * @memberof Framebuffer
+ */
+static GLenum checkStatus(const Framebuffer *self) {
+
+	if (HasDirectStateAccess()) {
+		return glCheckNamedFramebufferStatus(self->name, GL_FRAMEBUFFER);
+	} else {
+		$(self, bind, GL_FRAMEBUFFER);
+		return glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	}
+}
+
+/**
+ * @fn void Framebuffer::detachAll(Framebuffer *self)
+ * @memberof Framebuffer
+ */
+static void detachAll(Framebuffer *self) {
+
+	for (size_t i = 0; i < lengthof(self->attachments); i++) {
+		if (self->attachments[i]) {
+			$(self, attachTexture, _attachment(i), NULL, 0);
+		}
+	}
+}
+
+/**
+ * @fn void Framebuffer::drawBuffers(const Framebuffer *self, GLsizei count, const GLenum *buffers)
+ * @memberof Framebuffer
+ */
+static void drawBuffers(const Framebuffer *self, GLsizei count, const GLenum *buffers) {
+
+	assert(count <= FRAMEBUFFER_MAX_COLOR_ATTACHMENTS);
+
+	if (HasDirectStateAccess()) {
+		if (count) {
+			glNamedFramebufferDrawBuffers(self->name, count, buffers);
+		} else {
+			glNamedFramebufferDrawBuffer(self->name, GL_NONE);
+		}
+	} else {
+		$(self, bind, GL_FRAMEBUFFER);
+		if (count) {
+			glDrawBuffers(count, buffers);
+		} else {
+			glDrawBuffer(GL_NONE);
+		}
+	}
+}
+
+/**
+ * @fn Framebuffer *Framebuffer::init(Framebuffer *self)
+ * @memberof Framebuffer
+ */
+static Framebuffer *init(Framebuffer *self) {
+
+	self = (Framebuffer *) super(Object, self, init);
+	if (self) {
+
+		if (HasDirectStateAccess()) {
+			glCreateFramebuffers(1, &self->name);
+		} else {
+			glGenFramebuffers(1, &self->name);
+		}
+
+		if (self->name == 0) {
+			return release(self);
+		}
+	}
+
+	return self;
+}
+
+/**
+ * @fn void Framebuffer::unbind(const Framebuffer *self, GLenum target)
+ * @memberof Framebuffer
+ */
+static void unbind(const Framebuffer *self, GLenum target) {
+	glBindFramebuffer(target, 0);
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((FramebufferInterface *) clazz->interface)->attachRenderbuffer = attachRenderbuffer;
+	((FramebufferInterface *) clazz->interface)->attachTexture = attachTexture;
+	((FramebufferInterface *) clazz->interface)->attachmentForInternalFormat = attachmentForInternalFormat;
+	((FramebufferInterface *) clazz->interface)->bind = bind;
+	((FramebufferInterface *) clazz->interface)->checkStatus = checkStatus;
+	((FramebufferInterface *) clazz->interface)->detachAll = detachAll;
+	((FramebufferInterface *) clazz->interface)->drawBuffers = drawBuffers;
+	((FramebufferInterface *) clazz->interface)->init = init;
+	((FramebufferInterface *) clazz->interface)->unbind = unbind;
+}
+
+/**
+ * @fn Class *Framebuffer::_Framebuffer(void)
+ * @memberof Framebuffer
+ */
+Class *_Framebuffer(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "Framebuffer",
+			.superclass = _Object(),
+			.instanceSize = sizeof(Framebuffer),
+			.interfaceOffset = offsetof(Framebuffer, interface),
+			.interfaceSize = sizeof(FramebufferInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
@@ -0,0 +1,182 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Object.h>
+
+#include <ObjectivelyGL/Renderbuffer.h>
+#include <ObjectivelyGL/Texture.h>
+
+/**
+ * @file
+ * @brief Framebuffers are render targets composed of Texture and Renderbuffer attachments.
+ * @details Framebuffers retain their attachments until they are detached, or the Framebuffer is
+ * deallocated.
+ */
+
+/**
+ * @brief The maximum count of color attachments.
+ */
+#define FRAMEBUFFER_MAX_COLOR_ATTACHMENTS 8
+
+/**
+ * @brief The maximum count of attachments, including depth and stencil attachments.
+ */
+#define FRAMEBUFFER_MAX_ATTACHMENTS (FRAMEBUFFER_MAX_COLOR_ATTACHMENTS + 3)
+
+typedef struct Framebuffer Framebuffer;
+typedef struct FramebufferInterface FramebufferInterface;
+
+/**
+ * @brief The Framebuffer type.
+ * @extends Object
+ */
+struct Framebuffer {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	FramebufferInterface *interface;
+
+	/**
+	 * @brief The name.
+	 */
+	GLuint name;
+
+	/**
+	 * @brief The attached Textures and Renderbuffers, by attachment point.
+	 * @private
+	 */
+	Object *attachments[FRAMEBUFFER_MAX_ATTACHMENTS];
+};
+
+/**
+ * @brief The Framebuffer interface.
+ */
+struct FramebufferInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn void Framebuffer::attachRenderbuffer(Framebuffer *self, GLenum attachment, Renderbuffer *renderbuffer)
+	 * @brief Attaches the given Renderbuffer to this Framebuffer.
+	 * @param self The Framebuffer.
+	 * @param attachment The attachment point, e.g. `GL_DEPTH_STENCIL_ATTACHMENT`.
+	 * @param renderbuffer The Renderbuffer, or `NULL` to detach.
+	 * @memberof Framebuffer
+	 */
+	void (*attachRenderbuffer)(Framebuffer *self, GLenum attachment, Renderbuffer *renderbuffer);
+
+	/**
+	 * @fn void Framebuffer::attachTexture(Framebuffer *self, GLenum attachment, Texture *texture, GLint level)
+	 * @brief Attaches the given level of the given Texture to this Framebuffer.
+	 * @param self The Framebuffer.
+	 * @param attachment The attachment point, e.g. `GL_COLOR_ATTACHMENT0`.
+	 * @param texture The Texture, or `NULL` to detach.
+	 * @param level The mipmap level.
+	 * @remarks Without Direct State Access, the Framebuffer is left bound to `GL_FRAMEBUFFER`.
+	 * @memberof Framebuffer
+	 */
+	void (*attachTexture)(Framebuffer *self, GLenum attachment, Texture *texture, GLint level);
+
+	/**
+	 * @fn GLenum Framebuffer::attachmentForInternalFormat(GLenum internalFormat)
+	 * @param internalFormat The sized internal format of a Texture or Renderbuffer.
+	 * @return The attachment point for the given internal format, e.g. `GL_DEPTH_ATTACHMENT`, or
+	 * `GL_COLOR_ATTACHMENT0` for color formats.
+	 * @memberof Framebuffer
+	 */
+	GLenum (*attachmentForInternalFormat)(GLenum internalFormat);
+
+	/**
+	 * @fn void Framebuffer::bind(const Framebuffer *self, GLenum target)
+	 * @brief Binds this Framebuffer to the specified target.
+	 * @param self The Framebuffer.
+	 * @param target The target, e.g. `GL_FRAMEBUFFER`, `GL_READ_FRAMEBUFFER`, etc.
+	 * @memberof Framebuffer
+	 */
+	void (*bind)(const Framebuffer *self, GLenum target);
+
+	/**
+	 * @fn GLenum Framebuffer::checkStatus(const Framebuffer *self)
+	 * @param self The Framebuffer.
+	 * @return The completeness status of this Framebuffer, e.g. `GL_FRAMEBUFFER_COMPLETE`.
+	 * @memberof Framebuffer
+	 */
+	GLenum (*checkStatus)(const Framebuffer *self);
+
+	/**
+	 * @fn void Framebuffer::detachAll(Framebuffer *self)
+	 * @brief Detaches and releases all attachments of this Framebuffer.
+	 * @param self The Framebuffer.
+	 * @memberof Framebuffer
+	 */
+	void (*detachAll)(Framebuffer *self);
+
+	/**
+	 * @fn void Framebuffer::drawBuffers(const Framebuffer *self, GLsizei count, const GLenum *buffers)
+	 * @brief Sets the color attachments written to by fragment shader outputs.
+	 * @param self The Framebuffer.
+	 * @param count The count of buffers, or `0` to write no color attachments.
+	 * @param buffers The buffers, e.g. `GL_COLOR_ATTACHMENT0`.
+	 * @memberof Framebuffer
+	 */
+	void (*drawBuffers)(const Framebuffer *self, GLsizei count, const GLenum *buffers);
+
+	/**
+	 * @fn Framebuffer *Framebuffer::init(Framebuffer *self)
+	 * @brief Initializes this Framebuffer.
+	 * @param self The Framebuffer.
+	 * @return The initialized Framebuffer, or `NULL` on error.
+	 * @memberof Framebuffer
+	 */
+	Framebuffer *(*init)(Framebuffer *self);
+
+	/**
+	 * @fn void Framebuffer::unbind(const Framebuffer *self, GLenum target)
+	 * @brief Binds the default framebuffer to the specified target.
+	 * @param self The Framebuffer.
+	 * @param target The target, e.g. `GL_FRAMEBUFFER`, `GL_READ_FRAMEBUFFER`, etc.
+	 * @memberof Framebuffer
+	 */
+	void (*unbind)(const Framebuffer *self, GLenum target);
+};
+
+/**
+ * @fn Class *Framebuffer::_Framebuffer(void)
+ * @brief The Framebuffer archetype.
+ * @return The Framebuffer Class.
+ * @memberof Framebuffer
+ */
+OBJECTIVELYGL_EXPORT Class *_Framebuffer(void);
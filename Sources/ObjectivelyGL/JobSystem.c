@@ -0,0 +1,642 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "JobSystem.h"
+
+/**
+ * @brief The count of times an idle worker or waiter polls for Jobs before parking.
+ */
+#define JOB_SYSTEM_SPIN_COUNT 256
+
+/**
+ * @brief The count of Jobs per Thread a parallel-for is split into, by default.
+ */
+#define JOB_SYSTEM_JOBS_PER_THREAD 4
+
+/**
+ * @brief A Command, and the JobCounter tracking it.
+ */
+typedef struct {
+	Command command;
+	JobCounter *counter;
+} Job;
+
+/**
+ * @brief A Job waiting on a JobCounter.
+ */
+typedef struct JobContinuation {
+	Job job;
+	struct JobContinuation *next;
+} JobContinuation;
+
+/**
+ * @brief A parallel-for range.
+ */
+typedef struct {
+	JobRangeFunction function;
+	size_t begin, end;
+	ident data;
+} JobRange;
+
+/**
+ * @brief A worker Thread and its deque of Jobs.
+ */
+typedef struct {
+	JobSystem *system;
+	Thread *thread;
+	Lock *lock;
+	Job *jobs;
+	size_t capacity;
+	size_t head, tail;
+	unsigned int seed;
+} JobWorker;
+
+/**
+ * @brief The worker of the calling thread, if it is a worker Thread.
+ */
+static __thread JobWorker *_worker;
+
+#define _Class _JobSystem
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	JobSystem *this = (JobSystem *) self;
+
+	JobWorker *workers = this->workers;
+
+	for (size_t i = 0; i < this->threads; i++) {
+		$(workers[i].thread, cancel);
+	}
+
+	synchronized(this->condition, $(this->condition, broadcast));
+
+	for (size_t i = 0; i <= this->threads; i++) {
+		if (workers[i].thread) {
+			$(workers[i].thread, join, NULL);
+			release(workers[i].thread);
+		}
+		release(workers[i].lock);
+		free(workers[i].jobs);
+	}
+
+	free(workers);
+
+	release(this->condition);
+	release(this->lock);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - JobSystem
+
+/**
+ * @brief Pauses the calling thread briefly while spinning.
+ */
+static inline void _pause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @return The worker of the calling thread in the given JobSystem, or `NULL`.
+ */
+static JobWorker *_currentWorker(const JobSystem *self) {
+	return _worker && _worker->system == self ? _worker : NULL;
+}
+
+/**
+ * @brief Pushes the given Job to the back of the given worker's deque.
+ */
+static void _push(JobSystem *self, JobWorker *worker, const Job *job) {
+
+	synchronized(worker->lock, {
+
+		if (worker->tail - worker->head == worker->capacity) {
+			const size_t capacity = worker->capacity ? worker->capacity << 1 : 64;
+			Job *jobs = malloc(capacity * sizeof(Job));
+			assert(jobs);
+
+			for (size_t i = worker->head; i < worker->tail; i++) {
+				jobs[i - worker->head] = worker->jobs[i % worker->capacity];
+			}
+
+			free(worker->jobs);
+
+			worker->jobs = jobs;
+			worker->capacity = capacity;
+
+			__atomic_store_n(&worker->tail, worker->tail - worker->head, __ATOMIC_RELAXED);
+			__atomic_store_n(&worker->head, 0, __ATOMIC_RELAXED);
+		}
+
+		worker->jobs[worker->tail % worker->capacity] = *job;
+		__atomic_add_fetch(&worker->tail, 1, __ATOMIC_RELAXED);
+	});
+
+	__atomic_add_fetch(&self->pending, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&self->sleeping, __ATOMIC_SEQ_CST)) {
+		synchronized(self->condition, $(self->condition, signal));
+	}
+}
+
+/**
+ * @brief Pops a Job from the back of the given worker's deque.
+ * @return True if a Job was popped, false otherwise.
+ */
+static _Bool _pop(JobSystem *self, JobWorker *worker, Job *job) {
+
+	_Bool popped = false;
+
+	synchronized(worker->lock, {
+		if (worker->tail > worker->head) {
+			__atomic_sub_fetch(&worker->tail, 1, __ATOMIC_RELAXED);
+			*job = worker->jobs[worker->tail % worker->capacity];
+			popped = true;
+		}
+	});
+
+	if (popped) {
+		__atomic_sub_fetch(&self->pending, 1, __ATOMIC_SEQ_CST);
+	}
+
+	return popped;
+}
+
+/**
+ * @brief Steals a Job from the front of the given worker's deque.
+ * @return True if a Job was stolen, false otherwise.
+ */
+static _Bool _steal(JobSystem *self, JobWorker *worker, Job *job) {
+
+	// check for an empty deque without contending for its Lock
+
+	if (__atomic_load_n(&worker->tail, __ATOMIC_RELAXED) == __atomic_load_n(&worker->head, __ATOMIC_RELAXED)) {
+		return false;
+	}
+
+	_Bool stolen = false;
+
+	if ($(worker->lock, tryLock)) {
+		if (worker->tail > worker->head) {
+			*job = worker->jobs[worker->head % worker->capacity];
+			__atomic_add_fetch(&worker->head, 1, __ATOMIC_RELAXED);
+			stolen = true;
+		}
+		$(worker->lock, unlock);
+	}
+
+	if (stolen) {
+		__atomic_sub_fetch(&self->pending, 1, __ATOMIC_SEQ_CST);
+	}
+
+	return stolen;
+}
+
+/**
+ * @brief Finds a Job for the given worker to run, popping its own deque before stealing.
+ * @param worker The worker, or `NULL` if the calling thread is not a worker Thread.
+ * @return True if a Job was found, false otherwise.
+ */
+static _Bool _find(JobSystem *self, JobWorker *worker, Job *job) {
+
+	if (worker && _pop(self, worker, job)) {
+		return true;
+	}
+
+	JobWorker *workers = self->workers;
+	const size_t count = self->threads + 1;
+
+	size_t victim;
+	if (worker) {
+		victim = (size_t) rand_r(&worker->seed);
+	} else {
+		victim = self->threads;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		JobWorker *w = &workers[(victim + i) % count];
+		if (w != worker && _steal(self, w, job)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @return The deque for Jobs submitted by the calling thread: its own if it is a worker Thread,
+ * or the shared deque otherwise.
+ */
+static JobWorker *_deque(const JobSystem *self) {
+
+	JobWorker *worker = _currentWorker(self);
+	if (worker == NULL) {
+		worker = (JobWorker *) self->workers + self->threads;
+	}
+
+	return worker;
+}
+
+/**
+ * @brief Decrements the given JobCounter, submitting its continuations if it reaches zero.
+ */
+static void _complete(JobSystem *self, JobCounter *counter) {
+
+	size_t value = __atomic_load_n(&counter->value, __ATOMIC_SEQ_CST);
+	while (value > 1) {
+		if (__atomic_compare_exchange_n(&counter->value, &value, value - 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+			return;
+		}
+	}
+
+	// the last decrement is made under the lock, so that waiters may synchronize with it
+
+	JobContinuation *continuations = NULL;
+	_Bool completed = false;
+
+	synchronized(self->lock, {
+		if (__atomic_sub_fetch(&counter->value, 1, __ATOMIC_SEQ_CST) == 0) {
+			continuations = counter->continuations;
+			counter->continuations = NULL;
+			completed = true;
+		}
+	});
+
+	if (completed && __atomic_load_n(&self->waiting, __ATOMIC_SEQ_CST)) {
+		synchronized(self->condition, $(self->condition, broadcast));
+	}
+
+	while (continuations) {
+		JobContinuation *next = continuations->next;
+
+		_push(self, _deque(self), &continuations->job);
+		free(continuations);
+
+		continuations = next;
+	}
+}
+
+/**
+ * @brief Runs the given Job.
+ */
+static void _run(JobSystem *self, const Job *job) {
+
+	job->command.consumer(job->command.data);
+
+	if (job->counter) {
+		_complete(self, job->counter);
+	}
+}
+
+/**
+ * @brief Consumer for parallel-for ranges.
+ */
+static void _range(ident data) {
+
+	const JobRange *range = data;
+
+	range->function(range->begin, range->end, range->data);
+}
+
+/**
+ * @brief ThreadFunction.
+ */
+static ident _thread(Thread *thread) {
+
+	JobWorker *worker = thread->data;
+	JobSystem *self = worker->system;
+
+	_worker = worker;
+
+	while (!thread->isCancelled) {
+
+		Job job;
+		if (_find(self, worker, &job)) {
+			_run(self, &job);
+			continue;
+		}
+
+		size_t i;
+		for (i = 0; i < JOB_SYSTEM_SPIN_COUNT; i++) {
+			if (__atomic_load_n(&self->pending, __ATOMIC_SEQ_CST) || thread->isCancelled) {
+				break;
+			}
+			_pause();
+		}
+
+		if (i < JOB_SYSTEM_SPIN_COUNT) {
+			continue;
+		}
+
+		synchronized(self->condition, {
+			__atomic_add_fetch(&self->sleeping, 1, __ATOMIC_SEQ_CST);
+			while (__atomic_load_n(&self->pending, __ATOMIC_SEQ_CST) == 0 && !thread->isCancelled) {
+				$(self->condition, wait);
+			}
+			__atomic_sub_fetch(&self->sleeping, 1, __ATOMIC_SEQ_CST);
+		});
+	}
+
+	_worker = NULL;
+
+	return NULL;
+}
+
+/**
+ * @fn JobSystem *JobSystem::init(JobSystem *self)
+ * @memberof JobSystem
+ */
+static JobSystem *init(JobSystem *self) {
+
+	const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return $(self, initWithThreads, cores > 1 ? (size_t) cores - 1 : 1);
+}
+
+/**
+ * @fn JobSystem *JobSystem::initWithThreads(JobSystem *self, size_t threads)
+ * @memberof JobSystem
+ */
+static JobSystem *initWithThreads(JobSystem *self, size_t threads) {
+
+	self = (JobSystem *) super(Object, self, init);
+	if (self) {
+		self->threads = threads;
+
+		self->condition = $(alloc(Condition), init);
+		assert(self->condition);
+
+		self->lock = $(alloc(Lock), init);
+		assert(self->lock);
+
+		JobWorker *workers = calloc(threads + 1, sizeof(JobWorker));
+		assert(workers);
+
+		self->workers = workers;
+
+		for (size_t i = 0; i <= threads; i++) {
+			workers[i].system = self;
+			workers[i].seed = (unsigned int) i;
+
+			workers[i].lock = $(alloc(Lock), init);
+			assert(workers[i].lock);
+		}
+
+		for (size_t i = 0; i < threads; i++) {
+			workers[i].thread = $(alloc(Thread), initWithFunction, _thread, &workers[i]);
+			assert(workers[i].thread);
+
+			$(workers[i].thread, start);
+		}
+	}
+
+	return self;
+}
+
+/**
+ * @fn void JobSystem::parallelFor(JobSystem *self, size_t count, size_t grain, JobRangeFunction function, ident data)
+ * @memberof JobSystem
+ */
+static void parallelFor(JobSystem *self, size_t count, size_t grain, JobRangeFunction function, ident data) {
+
+	assert(function);
+
+	if (count == 0) {
+		return;
+	}
+
+	if (grain == 0) {
+		grain = max((size_t) 1, count / ((self->threads + 1) * JOB_SYSTEM_JOBS_PER_THREAD));
+	}
+
+	const size_t jobs = (count + grain - 1) / grain;
+	if (jobs == 1 || self->threads == 0) {
+		function(0, count, data);
+		return;
+	}
+
+	JobRange *ranges = calloc(jobs, sizeof(JobRange));
+	assert(ranges);
+
+	JobCounter counter = { .value = 0 };
+
+	for (size_t i = 0; i < jobs; i++) {
+		ranges[i].function = function;
+		ranges[i].begin = i * grain;
+		ranges[i].end = min(count, ranges[i].begin + grain);
+		ranges[i].data = data;
+
+		if (i < jobs - 1) {
+			$(self, submit, _range, &ranges[i], &counter);
+		}
+	}
+
+	_range(&ranges[jobs - 1]);
+
+	$(self, wait, &counter);
+
+	free(ranges);
+}
+
+/**
+ * @brief The shared JobSystem.
+ */
+static JobSystem *_sharedInstance;
+
+/**
+ * @brief Releases the shared JobSystem when the process exits.
+ */
+static void _releaseSharedInstance(void) {
+	_sharedInstance = release(_sharedInstance);
+}
+
+/**
+ * @fn JobSystem *JobSystem::sharedInstance(void)
+ * @memberof JobSystem
+ */
+static JobSystem *sharedInstance(void) {
+	static Once once;
+
+	do_once(&once, {
+		_sharedInstance = $(alloc(JobSystem), init);
+		assert(_sharedInstance);
+
+		atexit(_releaseSharedInstance);
+	});
+
+	return _sharedInstance;
+}
+
+/**
+ * @fn void JobSystem::submit(JobSystem *self, Consumer consumer, ident data, JobCounter *counter)
+ * @memberof JobSystem
+ */
+static void submit(JobSystem *self, Consumer consumer, ident data, JobCounter *counter) {
+
+	assert(consumer);
+
+	Job job;
+	job.command.consumer = consumer;
+	job.command.data = data;
+	job.counter = counter;
+
+	if (counter) {
+		__atomic_add_fetch(&counter->value, 1, __ATOMIC_SEQ_CST);
+	}
+
+	_push(self, _deque(self), &job);
+}
+
+/**
+ * @fn void JobSystem::submitAfter(JobSystem *self, JobCounter *dependency, Consumer consumer, ident data, JobCounter *counter)
+ * @memberof JobSystem
+ */
+static void submitAfter(JobSystem *self, JobCounter *dependency, Consumer consumer, ident data, JobCounter *counter) {
+
+	assert(dependency);
+	assert(consumer);
+
+	JobContinuation *continuation = calloc(1, sizeof(JobContinuation));
+	assert(continuation);
+
+	continuation->job.command.consumer = consumer;
+	continuation->job.command.data = data;
+	continuation->job.counter = counter;
+
+	if (counter) {
+		__atomic_add_fetch(&counter->value, 1, __ATOMIC_SEQ_CST);
+	}
+
+	synchronized(self->lock, {
+		if (__atomic_load_n(&dependency->value, __ATOMIC_SEQ_CST)) {
+			continuation->next = dependency->continuations;
+			dependency->continuations = continuation;
+			continuation = NULL;
+		}
+	});
+
+	if (continuation) {
+		_push(self, _deque(self), &continuation->job);
+		free(continuation);
+	}
+}
+
+/**
+ * @fn void JobSystem::wait(JobSystem *self, JobCounter *counter)
+ * @memberof JobSystem
+ */
+static void wait(JobSystem *self, JobCounter *counter) {
+
+	assert(counter);
+
+	JobWorker *worker = _currentWorker(self);
+
+	size_t spins = 0;
+
+	while (__atomic_load_n(&counter->value, __ATOMIC_SEQ_CST)) {
+
+		Job job;
+		if (_find(self, worker, &job)) {
+			_run(self, &job);
+			spins = 0;
+			continue;
+		}
+
+		if (++spins < JOB_SYSTEM_SPIN_COUNT) {
+			_pause();
+			continue;
+		}
+
+		// park until the last Job completes, or until Jobs are submitted that we may run
+
+		synchronized(self->condition, {
+			__atomic_add_fetch(&self->waiting, 1, __ATOMIC_SEQ_CST);
+			__atomic_add_fetch(&self->sleeping, 1, __ATOMIC_SEQ_CST);
+			while (__atomic_load_n(&counter->value, __ATOMIC_SEQ_CST) && __atomic_load_n(&self->pending, __ATOMIC_SEQ_CST) == 0) {
+				$(self->condition, wait);
+			}
+			__atomic_sub_fetch(&self->sleeping, 1, __ATOMIC_SEQ_CST);
+			__atomic_sub_fetch(&self->waiting, 1, __ATOMIC_SEQ_CST);
+		});
+
+		spins = 0;
+	}
+
+	synchronized(self->lock, {});
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((JobSystemInterface *) clazz->interface)->init = init;
+	((JobSystemInterface *) clazz->interface)->initWithThreads = initWithThreads;
+	((JobSystemInterface *) clazz->interface)->parallelFor = parallelFor;
+	((JobSystemInterface *) clazz->interface)->sharedInstance = sharedInstance;
+	((JobSystemInterface *) clazz->interface)->submit = submit;
+	((JobSystemInterface *) clazz->interface)->submitAfter = submitAfter;
+	((JobSystemInterface *) clazz->interface)->wait = wait;
+}
+
+/**
+ * @fn Class *JobSystem::_JobSystem(void)
+ * @memberof JobSystem
+ */
+Class *_JobSystem(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "JobSystem",
+			.superclass = _Object(),
+			.instanceSize = sizeof(JobSystem),
+			.interfaceOffset = offsetof(JobSystem, interface),
+			.interfaceSize = sizeof(JobSystemInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
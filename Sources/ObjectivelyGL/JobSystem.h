@@ -0,0 +1,225 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Condition.h>
+#include <Objectively/Thread.h>
+
+#include <ObjectivelyGL/Command.h>
+
+/**
+ * @file
+ * @brief A work-stealing JobSystem for parallel CPU work.
+ * @details Each worker Thread owns a deque of Jobs. Workers push and pop Jobs at the back of their
+ * own deque, and steal Jobs from the front of the others' when theirs is empty. Jobs submitted
+ * from threads outside of the JobSystem are pushed to a shared deque, from which all workers
+ * steal.
+ *
+ * Completion is tracked with JobCounters. Each Job submitted with a JobCounter increments it, and
+ * decrements it once it has run. Threads waiting on a JobCounter run pending Jobs until it reaches
+ * zero, so Jobs may safely wait on the Jobs they submit. Continuations may be attached to a
+ * JobCounter with _submitAfter_.
+ *
+ * CommandQueue remains the place for work that must run serially, such as OpenGL calls.
+ */
+
+/**
+ * @brief A JobRangeFunction processes the elements `[begin, end)` of a parallel-for.
+ */
+typedef void (*JobRangeFunction)(size_t begin, size_t end, ident data);
+
+/**
+ * @brief JobCounters track the completion of Jobs.
+ * @details JobCounters must be zero-initialized, and must outlive the Jobs submitted with them.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of incomplete Jobs.
+	 */
+	size_t value;
+
+	/**
+	 * @brief The Jobs to submit once `value` reaches zero.
+	 * @private
+	 */
+	ident continuations;
+
+} JobCounter;
+
+typedef struct JobSystem JobSystem;
+typedef struct JobSystemInterface JobSystemInterface;
+
+/**
+ * @brief The JobSystem type.
+ * @extends Object
+ */
+struct JobSystem {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	JobSystemInterface *interface;
+
+	/**
+	 * @brief The count of worker Threads.
+	 */
+	size_t threads;
+
+	/**
+	 * @brief The workers, and the shared deque.
+	 * @private
+	 */
+	ident workers;
+
+	/**
+	 * @brief The count of Jobs pending in all deques.
+	 * @private
+	 */
+	size_t pending;
+
+	/**
+	 * @brief The count of parked workers.
+	 * @private
+	 */
+	size_t sleeping;
+
+	/**
+	 * @brief The count of threads parked in _wait_.
+	 * @private
+	 */
+	size_t waiting;
+
+	/**
+	 * @brief The Condition parked workers and waiters wait on.
+	 * @private
+	 */
+	Condition *condition;
+
+	/**
+	 * @brief The Lock guarding JobCounter continuations.
+	 * @private
+	 */
+	Lock *lock;
+};
+
+/**
+ * @brief The JobSystem interface.
+ */
+struct JobSystemInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn JobSystem *JobSystem::init(JobSystem *self)
+	 * @brief Initializes this JobSystem with one worker Thread per additional processor core.
+	 * @param self The JobSystem.
+	 * @return The initialized JobSystem, or `NULL` on error.
+	 * @memberof JobSystem
+	 */
+	JobSystem *(*init)(JobSystem *self);
+
+	/**
+	 * @fn JobSystem *JobSystem::initWithThreads(JobSystem *self, size_t threads)
+	 * @brief Initializes this JobSystem with the specified count of worker Threads.
+	 * @param self The JobSystem.
+	 * @param threads The count of worker Threads. If `0`, Jobs are run by waiting threads only.
+	 * @return The initialized JobSystem, or `NULL` on error.
+	 * @memberof JobSystem
+	 */
+	JobSystem *(*initWithThreads)(JobSystem *self, size_t threads);
+
+	/**
+	 * @fn void JobSystem::parallelFor(JobSystem *self, size_t count, size_t grain, JobRangeFunction function, ident data)
+	 * @brief Calls `function` over the range `[0, count)`, split into Jobs of `grain` elements.
+	 * @param self The JobSystem.
+	 * @param count The count of elements.
+	 * @param grain The count of elements per Job, or `0` to choose one from the count of Threads.
+	 * @param function The JobRangeFunction.
+	 * @param data The user data.
+	 * @remarks This method returns once all elements have been processed.
+	 * @memberof JobSystem
+	 */
+	void (*parallelFor)(JobSystem *self, size_t count, size_t grain, JobRangeFunction function, ident data);
+
+	/**
+	 * @fn JobSystem *JobSystem::sharedInstance(void)
+	 * @return The shared JobSystem, used by ObjectivelyGL itself.
+	 * @memberof JobSystem
+	 */
+	JobSystem *(*sharedInstance)(void);
+
+	/**
+	 * @fn void JobSystem::submit(JobSystem *self, Consumer consumer, ident data, JobCounter *counter)
+	 * @brief Submits a Job to this JobSystem.
+	 * @param self The JobSystem.
+	 * @param consumer The Consumer.
+	 * @param data The user data.
+	 * @param counter The JobCounter to increment until the Job has run, or `NULL`.
+	 * @memberof JobSystem
+	 */
+	void (*submit)(JobSystem *self, Consumer consumer, ident data, JobCounter *counter);
+
+	/**
+	 * @fn void JobSystem::submitAfter(JobSystem *self, JobCounter *dependency, Consumer consumer, ident data, JobCounter *counter)
+	 * @brief Submits a Job to this JobSystem once `dependency` reaches zero.
+	 * @param self The JobSystem.
+	 * @param dependency The JobCounter the Job depends on.
+	 * @param consumer The Consumer.
+	 * @param data The user data.
+	 * @param counter The JobCounter to increment until the Job has run, or `NULL`.
+	 * @remarks If `dependency` is already zero, the Job is submitted immediately.
+	 * @memberof JobSystem
+	 */
+	void (*submitAfter)(JobSystem *self, JobCounter *dependency, Consumer consumer, ident data, JobCounter *counter);
+
+	/**
+	 * @fn void JobSystem::wait(JobSystem *self, JobCounter *counter)
+	 * @brief Runs pending Jobs until the specified JobCounter reaches zero.
+	 * @param self The JobSystem.
+	 * @param counter The JobCounter.
+	 * @remarks When no Jobs are pending, the calling thread spins briefly and then parks until
+	 * the JobCounter reaches zero or more Jobs are submitted.
+	 * @memberof JobSystem
+	 */
+	void (*wait)(JobSystem *self, JobCounter *counter);
+};
+
+/**
+ * @fn Class *JobSystem::_JobSystem(void)
+ * @brief The JobSystem archetype.
+ * @return The JobSystem Class.
+ * @memberof JobSystem
+ */
+OBJECTIVELYGL_EXPORT Class *_JobSystem(void);
@@ -0,0 +1,427 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MemoryTracker.h"
+
+#define _Class _MemoryTracker
+
+/**
+ * @brief The budget of a MemoryCategory.
+ */
+typedef struct {
+
+	/**
+	 * @brief The budget, in bytes, or `0`.
+	 */
+	GLsizeiptr bytes;
+
+	/**
+	 * @brief The MemoryBudgetFunction.
+	 */
+	MemoryBudgetFunction function;
+
+	/**
+	 * @brief The user data.
+	 */
+	ident data;
+
+} MemoryBudget;
+
+/**
+ * @brief A MemoryBudget exceeded by an allocation, to notify outside of the Lock.
+ */
+typedef struct {
+
+	/**
+	 * @brief The MemoryBudget.
+	 */
+	MemoryBudget budget;
+
+	/**
+	 * @brief The MemoryCategory.
+	 */
+	MemoryCategory category;
+
+	/**
+	 * @brief The size of the MemoryCategory after the allocation, in bytes.
+	 */
+	GLsizeiptr bytes;
+
+} MemoryNotification;
+
+/**
+ * @brief The names of each MemoryCategory, for reporting.
+ */
+static const char *_names[] = {
+	"vertex",
+	"index",
+	"uniform",
+	"pixel",
+	"buffer",
+	"texture",
+	"renderbuffer",
+	"all"
+};
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	MemoryTracker *this = (MemoryTracker *) self;
+
+	free(this->budgets);
+
+	release(this->formats);
+	release(this->lock);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - MemoryTracker
+
+/**
+ * @brief Applies an allocation of `bytes` (or deallocation, if negative) to the given MemoryStats.
+ */
+static void _update(MemoryStats *stats, GLsizeiptr bytes) {
+
+	if (bytes < 0) {
+		assert(stats->count > 0);
+		assert(stats->bytes >= -bytes);
+
+		stats->count--;
+	} else {
+		stats->count++;
+	}
+
+	stats->bytes += bytes;
+	stats->peak = max(stats->peak, stats->bytes);
+}
+
+/**
+ * @return The MemoryStats for the given Texture format, which are created if necessary.
+ */
+static MemoryStats *_formatStats(MemoryTracker *self, GLenum format) {
+
+	for (size_t i = 0; i < self->formats->count; i++) {
+		MemoryFormatStats *stats = VectorElement(self->formats, MemoryFormatStats, i);
+		if (stats->format == format) {
+			return &stats->stats;
+		}
+	}
+
+	MemoryFormatStats stats = { .format = format };
+	$(self->formats, addElement, &stats);
+
+	return &VectorElement(self->formats, MemoryFormatStats, self->formats->count - 1)->stats;
+}
+
+/**
+ * @brief Checks the budget of the given MemoryCategory after an allocation of `bytes`.
+ * @return True if the allocation exceeded the budget, in which case `notification` is populated.
+ */
+static _Bool _checkBudget(const MemoryTracker *self, MemoryCategory category, GLsizeiptr bytes, MemoryNotification *notification) {
+
+	const MemoryBudget *budget = (const MemoryBudget *) self->budgets + category;
+	if (budget->bytes) {
+
+		const GLsizeiptr current = self->categories[category].bytes;
+		if (current > budget->bytes && current - bytes <= budget->bytes) {
+
+			notification->budget = *budget;
+			notification->category = category;
+			notification->bytes = current;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Applies an allocation of `bytes` (or deallocation, if negative), notifying exceeded budgets.
+ */
+static void _account(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes) {
+
+	assert(category < MemoryCategoryAll);
+
+	MemoryNotification notifications[2];
+	size_t count = 0;
+
+	synchronized(self->lock, {
+
+		_update(&self->categories[category], bytes);
+		_update(&self->categories[MemoryCategoryAll], bytes);
+
+		if (format != GL_NONE) {
+			_update(_formatStats(self, format), bytes);
+		}
+
+		if (bytes > 0) {
+			if (_checkBudget(self, category, bytes, &notifications[count])) {
+				count++;
+			}
+			if (_checkBudget(self, MemoryCategoryAll, bytes, &notifications[count])) {
+				count++;
+			}
+		}
+	});
+
+	for (size_t i = 0; i < count; i++) {
+		const MemoryNotification *notification = &notifications[i];
+		notification->budget.function(self, notification->category, notification->bytes, notification->budget.data);
+	}
+}
+
+/**
+ * @fn void MemoryTracker::allocate(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes)
+ * @memberof MemoryTracker
+ */
+static void allocate(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes) {
+
+	assert(bytes >= 0);
+
+	_account(self, category, format, bytes);
+}
+
+/**
+ * @fn GLsizeiptr MemoryTracker::bytesForInternalFormat(GLint internalFormat)
+ * @memberof MemoryTracker
+ */
+static GLsizeiptr bytesForInternalFormat(GLint internalFormat) {
+
+	switch (internalFormat) {
+		case GL_RED:
+		case GL_R8:
+		case GL_STENCIL_INDEX8:
+			return 1;
+		case GL_RG:
+		case GL_RG8:
+		case GL_R16:
+		case GL_R16F:
+		case GL_DEPTH_COMPONENT16:
+			return 2;
+		case GL_RGB16F:
+		case GL_RGBA16:
+		case GL_RGBA16F:
+		case GL_RG32F:
+		case GL_DEPTH32F_STENCIL8:
+			return 8;
+		case GL_RGB32F:
+		case GL_RGBA32F:
+			return 16;
+		default:
+			return 4;
+	}
+}
+
+/**
+ * @fn void MemoryTracker::deallocate(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes)
+ * @memberof MemoryTracker
+ */
+static void deallocate(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes) {
+
+	assert(bytes >= 0);
+
+	_account(self, category, format, -bytes);
+}
+
+/**
+ * @fn MemoryTracker *MemoryTracker::init(MemoryTracker *self)
+ * @memberof MemoryTracker
+ */
+static MemoryTracker *init(MemoryTracker *self) {
+
+	self = (MemoryTracker *) super(Object, self, init);
+	if (self) {
+
+		self->formats = $(alloc(Vector), initWithSize, sizeof(MemoryFormatStats));
+		assert(self->formats);
+
+		self->budgets = calloc(MemoryCategoryCount, sizeof(MemoryBudget));
+		assert(self->budgets);
+
+		self->lock = $(alloc(Lock), init);
+		assert(self->lock);
+	}
+
+	return self;
+}
+
+/**
+ * @fn void MemoryTracker::setBudget(MemoryTracker *self, MemoryCategory category, GLsizeiptr bytes, MemoryBudgetFunction function, ident data)
+ * @memberof MemoryTracker
+ */
+static void setBudget(MemoryTracker *self, MemoryCategory category, GLsizeiptr bytes, MemoryBudgetFunction function, ident data) {
+
+	assert(category < MemoryCategoryCount);
+	assert(bytes == 0 || function);
+
+	MemoryBudget *budget = (MemoryBudget *) self->budgets + category;
+
+	synchronized(self->lock, {
+		budget->bytes = bytes;
+		budget->function = function;
+		budget->data = data;
+	});
+}
+
+/**
+ * @brief The shared MemoryTracker.
+ */
+static MemoryTracker *_sharedInstance;
+
+/**
+ * @brief Releases the shared MemoryTracker when the process exits.
+ */
+static void _releaseSharedInstance(void) {
+	_sharedInstance = release(_sharedInstance);
+}
+
+/**
+ * @fn MemoryTracker *MemoryTracker::sharedInstance(void)
+ * @memberof MemoryTracker
+ */
+static MemoryTracker *sharedInstance(void) {
+	static Once once;
+
+	do_once(&once, {
+		_sharedInstance = $(alloc(MemoryTracker), init);
+		assert(_sharedInstance);
+
+		atexit(_releaseSharedInstance);
+	});
+
+	return _sharedInstance;
+}
+
+/**
+ * @fn MemorySnapshot MemoryTracker::snapshot(const MemoryTracker *self)
+ * @memberof MemoryTracker
+ */
+static MemorySnapshot snapshot(const MemoryTracker *self) {
+
+	MemorySnapshot snapshot;
+
+	synchronized(self->lock, {
+
+		for (size_t i = 0; i < MemoryCategoryCount; i++) {
+			snapshot.categories[i] = self->categories[i];
+		}
+
+		snapshot.numFormats = min(self->formats->count, MEMORY_SNAPSHOT_MAX_FORMATS);
+
+		for (size_t i = 0; i < snapshot.numFormats; i++) {
+			snapshot.formats[i] = *VectorElement(self->formats, MemoryFormatStats, i);
+		}
+	});
+
+	return snapshot;
+}
+
+/**
+ * @fn _Bool MemoryTracker::writeReport(const MemoryTracker *self, const char *path)
+ * @memberof MemoryTracker
+ */
+static _Bool writeReport(const MemoryTracker *self, const char *path) {
+
+	FILE *file = path ? fopen(path, "w") : stdout;
+	if (file == NULL) {
+		return false;
+	}
+
+	const MemorySnapshot snapshot = $(self, snapshot);
+
+	fprintf(file, "%-16s %8s %14s %14s\n", "category", "count", "bytes", "peak");
+
+	for (size_t i = 0; i < MemoryCategoryCount; i++) {
+		const MemoryStats *stats = &snapshot.categories[i];
+		fprintf(file, "%-16s %8zu %14zd %14zd\n", _names[i], stats->count, stats->bytes, stats->peak);
+	}
+
+	for (size_t i = 0; i < snapshot.numFormats; i++) {
+		const MemoryFormatStats *format = &snapshot.formats[i];
+		fprintf(file, "texture 0x%04x    %8zu %14zd %14zd\n",
+				format->format,
+				format->stats.count,
+				format->stats.bytes,
+				format->stats.peak);
+	}
+
+	if (path) {
+		return fclose(file) == 0;
+	}
+
+	return fflush(file) == 0;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((MemoryTrackerInterface *) clazz->interface)->allocate = allocate;
+	((MemoryTrackerInterface *) clazz->interface)->bytesForInternalFormat = bytesForInternalFormat;
+	((MemoryTrackerInterface *) clazz->interface)->deallocate = deallocate;
+	((MemoryTrackerInterface *) clazz->interface)->init = init;
+	((MemoryTrackerInterface *) clazz->interface)->setBudget = setBudget;
+	((MemoryTrackerInterface *) clazz->interface)->sharedInstance = sharedInstance;
+	((MemoryTrackerInterface *) clazz->interface)->snapshot = snapshot;
+	((MemoryTrackerInterface *) clazz->interface)->writeReport = writeReport;
+}
+
+/**
+ * @fn Class *MemoryTracker::_MemoryTracker(void)
+ * @memberof MemoryTracker
+ */
+Class *_MemoryTracker(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "MemoryTracker",
+			.superclass = _Object(),
+			.instanceSize = sizeof(MemoryTracker),
+			.interfaceOffset = offsetof(MemoryTracker, interface),
+			.interfaceSize = sizeof(MemoryTrackerInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
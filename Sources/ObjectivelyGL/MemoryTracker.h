@@ -0,0 +1,313 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Lock.h>
+#include <Objectively/Vector.h>
+
+#include <ObjectivelyGL/Types.h>
+
+/**
+ * @file
+ * @brief The MemoryTracker accounts for the GPU memory held by Buffers, Textures and Renderbuffers.
+ * @details Buffers, Textures and Renderbuffers report their allocations to the shared MemoryTracker
+ * by MemoryCategory, and Textures and Renderbuffers additionally by internal format. The current
+ * and peak bytes of each are available through _snapshot_ and _writeReport_. Budgets may be set per MemoryCategory, so
+ * that applications streaming assets are notified once an allocation exceeds the budget, and may
+ * evict assets in time.
+ *
+ * Texture and Renderbuffer sizes are estimates, since drivers are free to pad and compress storage.
+ */
+
+/**
+ * @brief The maximum count of Texture formats in a MemorySnapshot.
+ */
+#define MEMORY_SNAPSHOT_MAX_FORMATS 32
+
+/**
+ * @brief MemoryCategories classify GPU allocations.
+ */
+typedef enum {
+
+	/**
+	 * @brief Vertex Buffers, bound to `GL_ARRAY_BUFFER`.
+	 */
+	MemoryCategoryVertex,
+
+	/**
+	 * @brief Index Buffers, bound to `GL_ELEMENT_ARRAY_BUFFER`.
+	 */
+	MemoryCategoryIndex,
+
+	/**
+	 * @brief Uniform Buffers, bound to `GL_UNIFORM_BUFFER`.
+	 */
+	MemoryCategoryUniform,
+
+	/**
+	 * @brief Pixel Buffers, bound to `GL_PIXEL_PACK_BUFFER` or `GL_PIXEL_UNPACK_BUFFER`.
+	 */
+	MemoryCategoryPixel,
+
+	/**
+	 * @brief Buffers bound to any other target.
+	 */
+	MemoryCategoryBuffer,
+
+	/**
+	 * @brief Textures.
+	 */
+	MemoryCategoryTexture,
+
+	/**
+	 * @brief Renderbuffers.
+	 */
+	MemoryCategoryRenderbuffer,
+
+	/**
+	 * @brief All of the above.
+	 */
+	MemoryCategoryAll,
+
+	/**
+	 * @brief The count of MemoryCategories.
+	 */
+	MemoryCategoryCount
+
+} MemoryCategory;
+
+/**
+ * @brief Allocation statistics for a MemoryCategory or Texture format.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of live allocations.
+	 */
+	size_t count;
+
+	/**
+	 * @brief The current size of live allocations, in bytes.
+	 */
+	GLsizeiptr bytes;
+
+	/**
+	 * @brief The peak size of live allocations, in bytes.
+	 */
+	GLsizeiptr peak;
+
+} MemoryStats;
+
+/**
+ * @brief Allocation statistics for a Texture format.
+ */
+typedef struct {
+
+	/**
+	 * @brief The internal format.
+	 */
+	GLenum format;
+
+	/**
+	 * @brief The MemoryStats.
+	 */
+	MemoryStats stats;
+
+} MemoryFormatStats;
+
+/**
+ * @brief A point-in-time copy of a MemoryTracker's statistics.
+ */
+typedef struct {
+
+	/**
+	 * @brief The MemoryStats of each MemoryCategory.
+	 */
+	MemoryStats categories[MemoryCategoryCount];
+
+	/**
+	 * @brief The MemoryStats of each Texture format.
+	 */
+	MemoryFormatStats formats[MEMORY_SNAPSHOT_MAX_FORMATS];
+
+	/**
+	 * @brief The count of Texture formats.
+	 */
+	size_t numFormats;
+
+} MemorySnapshot;
+
+typedef struct MemoryTracker MemoryTracker;
+
+/**
+ * @brief The function type for MemoryTracker budget notifications.
+ * @param tracker The MemoryTracker.
+ * @param category The MemoryCategory whose budget was exceeded.
+ * @param bytes The current size of the MemoryCategory, in bytes.
+ * @param data The user data.
+ */
+typedef void (*MemoryBudgetFunction)(MemoryTracker *tracker, MemoryCategory category, GLsizeiptr bytes, ident data);
+
+typedef struct MemoryTrackerInterface MemoryTrackerInterface;
+
+/**
+ * @brief The MemoryTracker type.
+ * @extends Object
+ */
+struct MemoryTracker {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	MemoryTrackerInterface *interface;
+
+	/**
+	 * @brief The MemoryStats of each MemoryCategory.
+	 * @private
+	 */
+	MemoryStats categories[MemoryCategoryCount];
+
+	/**
+	 * @brief The MemoryFormatStats of each Texture format.
+	 * @private
+	 */
+	Vector *formats;
+
+	/**
+	 * @brief The budgets of each MemoryCategory.
+	 * @private
+	 */
+	ident budgets;
+
+	/**
+	 * @brief The Lock guarding all statistics.
+	 * @private
+	 */
+	Lock *lock;
+};
+
+/**
+ * @brief The MemoryTracker interface.
+ */
+struct MemoryTrackerInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn void MemoryTracker::allocate(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes)
+	 * @brief Accounts for an allocation.
+	 * @param self The MemoryTracker.
+	 * @param category The MemoryCategory.
+	 * @param format The internal format of a Texture, or `GL_NONE`.
+	 * @param bytes The size of the allocation, in bytes.
+	 * @remarks If the allocation exceeds a budget, its MemoryBudgetFunction is called on the
+	 * calling thread.
+	 * @memberof MemoryTracker
+	 */
+	void (*allocate)(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes);
+
+	/**
+	 * @fn GLsizeiptr MemoryTracker::bytesForInternalFormat(GLint internalFormat)
+	 * @param internalFormat The internal format.
+	 * @return The estimated size of a texel of the given internal format, in bytes.
+	 * @remarks Three component formats are assumed to be padded to four components.
+	 * @memberof MemoryTracker
+	 */
+	GLsizeiptr (*bytesForInternalFormat)(GLint internalFormat);
+
+	/**
+	 * @fn void MemoryTracker::deallocate(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes)
+	 * @brief Accounts for a deallocation.
+	 * @param self The MemoryTracker.
+	 * @param category The MemoryCategory.
+	 * @param format The internal format of a Texture, or `GL_NONE`.
+	 * @param bytes The size of the allocation, in bytes.
+	 * @memberof MemoryTracker
+	 */
+	void (*deallocate)(MemoryTracker *self, MemoryCategory category, GLenum format, GLsizeiptr bytes);
+
+	/**
+	 * @fn MemoryTracker *MemoryTracker::init(MemoryTracker *self)
+	 * @brief Initializes this MemoryTracker.
+	 * @param self The MemoryTracker.
+	 * @return The initialized MemoryTracker, or `NULL` on error.
+	 * @memberof MemoryTracker
+	 */
+	MemoryTracker *(*init)(MemoryTracker *self);
+
+	/**
+	 * @fn void MemoryTracker::setBudget(MemoryTracker *self, MemoryCategory category, GLsizeiptr bytes, MemoryBudgetFunction function, ident data)
+	 * @brief Sets the budget of the given MemoryCategory.
+	 * @param self The MemoryTracker.
+	 * @param category The MemoryCategory, or `MemoryCategoryAll` for a total budget.
+	 * @param bytes The budget, in bytes, or `0` to clear it.
+	 * @param function The MemoryBudgetFunction called when an allocation exceeds the budget.
+	 * @param data The user data.
+	 * @memberof MemoryTracker
+	 */
+	void (*setBudget)(MemoryTracker *self, MemoryCategory category, GLsizeiptr bytes, MemoryBudgetFunction function, ident data);
+
+	/**
+	 * @fn MemoryTracker *MemoryTracker::sharedInstance(void)
+	 * @return The shared MemoryTracker, to which Buffers, Textures and Renderbuffers report.
+	 * @memberof MemoryTracker
+	 */
+	MemoryTracker *(*sharedInstance)(void);
+
+	/**
+	 * @fn MemorySnapshot MemoryTracker::snapshot(const MemoryTracker *self)
+	 * @param self The MemoryTracker.
+	 * @return A MemorySnapshot of this MemoryTracker's statistics.
+	 * @memberof MemoryTracker
+	 */
+	MemorySnapshot (*snapshot)(const MemoryTracker *self);
+
+	/**
+	 * @fn _Bool MemoryTracker::writeReport(const MemoryTracker *self, const char *path)
+	 * @brief Writes a plain text report of this MemoryTracker's statistics to the given path.
+	 * @param self The MemoryTracker.
+	 * @param path The output path, or `NULL` for the standard output.
+	 * @return True on success, false on error.
+	 * @memberof MemoryTracker
+	 */
+	_Bool (*writeReport)(const MemoryTracker *self, const char *path);
+};
+
+/**
+ * @fn Class *MemoryTracker::_MemoryTracker(void)
+ * @brief The MemoryTracker archetype.
+ * @return The MemoryTracker Class.
+ * @memberof MemoryTracker
+ */
+OBJECTIVELYGL_EXPORT Class *_MemoryTracker(void);
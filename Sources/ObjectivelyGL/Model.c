@@ -22,6 +22,8 @@
  */
 
 #include <assert.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "Model.h"
@@ -50,6 +52,120 @@ static void dealloc(Object *self) {
 
 #pragma mark - Model
 
+/**
+ * @brief The context of a parallel tangent calculation.
+ */
+typedef struct {
+	Model *model;
+	const ModelMesh *mesh;
+	vec3s *tangents;
+} TangentCalculation;
+
+/**
+ * @brief JobRangeFunction for calculating the tangent and bitangent of triangles.
+ */
+static void calculateTriangleTangents(size_t begin, size_t end, ident data) {
+
+	const TangentCalculation *calc = data;
+
+	const GLuint *elements = VectorElement(calc->model->elements, GLuint, calc->mesh->elements);
+
+	for (size_t i = begin; i < end; i++) {
+
+		const ModelVertex *a = VectorElement(calc->model->vertices, ModelVertex, elements[i * 3 + 0]);
+		const ModelVertex *b = VectorElement(calc->model->vertices, ModelVertex, elements[i * 3 + 1]);
+		const ModelVertex *c = VectorElement(calc->model->vertices, ModelVertex, elements[i * 3 + 2]);
+
+		const vec3s e1 = glms_vec3_sub(b->position, a->position);
+		const vec3s e2 = glms_vec3_sub(c->position, a->position);
+
+		const vec2s st1 = glms_vec2_sub(b->diffuse, a->diffuse);
+		const vec2s st2 = glms_vec2_sub(c->diffuse, a->diffuse);
+
+		vec3s *tangent = &calc->tangents[i * 2 + 0];
+		vec3s *bitangent = &calc->tangents[i * 2 + 1];
+
+		const float det = st1.x * st2.y - st2.x * st1.y;
+		if (fabsf(det) > FLT_EPSILON) {
+			const float r = 1.f / det;
+
+			*tangent = glms_vec3_scale(glms_vec3_sub(glms_vec3_scale(e1, st2.y), glms_vec3_scale(e2, st1.y)), r);
+			*bitangent = glms_vec3_scale(glms_vec3_sub(glms_vec3_scale(e2, st1.x), glms_vec3_scale(e1, st2.x)), r);
+		} else {
+			*tangent = *bitangent = GLMS_VEC3_ZERO;
+		}
+	}
+}
+
+/**
+ * @brief JobRangeFunction for orthogonalizing the accumulated tangents of vertices.
+ */
+static void orthogonalizeTangents(size_t begin, size_t end, ident data) {
+
+	const TangentCalculation *calc = data;
+
+	ModelVertex *v = VectorElement(calc->model->vertices, ModelVertex, begin);
+	for (size_t i = begin; i < end; i++, v++) {
+
+		vec3s t = glms_vec3_sub(v->tangent, glms_vec3_scale(v->normal, glms_vec3_dot(v->normal, v->tangent)));
+		if (glms_vec3_dot(t, t) <= FLT_EPSILON) {
+			t = glms_vec3_cross(v->normal, fabsf(v->normal.x) < .9f ? (vec3s) {{ 1.f, 0.f, 0.f }} : GLMS_YUP);
+		}
+
+		const vec3s tangent = glms_vec3_normalize(t);
+		const vec3s bitangent = glms_vec3_cross(v->normal, tangent);
+
+		v->tangent = tangent;
+		v->bitangent = glms_vec3_dot(bitangent, v->bitangent) < 0.f ? glms_vec3_scale(bitangent, -1.f) : bitangent;
+	}
+}
+
+/**
+ * @fn void Model::calculateTangents(Model *self)
+ * @memberof Model
+ */
+static void calculateTangents(Model *self) {
+
+	JobSystem *jobs = $$(JobSystem, sharedInstance);
+
+	TangentCalculation calc = {
+		.model = self,
+	};
+
+	ModelVertex *v = self->vertices->elements;
+	for (size_t i = 0; i < self->vertices->count; i++, v++) {
+		v->tangent = v->bitangent = GLMS_VEC3_ZERO;
+	}
+
+	for (size_t i = 0; i < self->meshes->count; i++) {
+
+		calc.mesh = VectorElement(self->meshes, ModelMesh, i);
+		if (calc.mesh->type != GL_TRIANGLES) {
+			continue;
+		}
+
+		const size_t triangles = calc.mesh->count / 3;
+
+		calc.tangents = realloc(calc.tangents, triangles * 2 * sizeof(vec3s));
+		assert(calc.tangents || triangles == 0);
+
+		$(jobs, parallelFor, triangles, MODEL_PARALLEL_GRAIN, calculateTriangleTangents, &calc);
+
+		const GLuint *elements = VectorElement(self->elements, GLuint, calc.mesh->elements);
+
+		for (size_t j = 0; j < triangles * 3; j++) {
+			ModelVertex *vertex = VectorElement(self->vertices, ModelVertex, elements[j]);
+
+			vertex->tangent = glms_vec3_add(vertex->tangent, calc.tangents[(j / 3) * 2 + 0]);
+			vertex->bitangent = glms_vec3_add(vertex->bitangent, calc.tangents[(j / 3) * 2 + 1]);
+		}
+	}
+
+	free(calc.tangents);
+
+	$(jobs, parallelFor, self->vertices->count, MODEL_PARALLEL_GRAIN, orthogonalizeTangents, &calc);
+}
+
 /**
  * @fn Buffer *Model::elementsBuffer(const Model *self)
  * @memberof Model
@@ -172,19 +288,28 @@ static VertexArray *vertexArray(const Model *self, const Attribute *attributes)
 }
 
 /**
- * @fn Buffer *Model::vertexBuffer(const Model *self, const Attribute *attributes)
- * @memberof Model
+ * @brief The context of a parallel vertex packing.
  */
-static Buffer *vertexBuffer(const Model *self, const Attribute *attributes) {
+typedef struct {
+	const Model *model;
+	const Attribute *attributes;
+	size_t vertexSize;
+	ident vertices;
+} VertexPacking;
+
+/**
+ * @brief JobRangeFunction for packing ModelVertices into interleaved vertex data.
+ */
+static void packVertices(size_t begin, size_t end, ident data) {
+
+	const VertexPacking *packing = data;
 
-	const size_t vertexSize = SizeOfAttributes(attributes);
-	ident vertices = malloc(vertexSize * self->vertices->count);
-	ident out = vertices;
+	ident out = packing->vertices + begin * packing->vertexSize;
 
-	ModelVertex *in = self->vertices->elements;
-	for (size_t i = 0; i < self->vertices->count; i++, in++, out += vertexSize) {
+	const ModelVertex *in = VectorElement(packing->model->vertices, ModelVertex, begin);
+	for (size_t i = begin; i < end; i++, in++, out += packing->vertexSize) {
 
-		const Attribute *attr = attributes;
+		const Attribute *attr = packing->attributes;
 		while (attr->type != GL_NONE) {
 
 			ident dest = out + (ptrdiff_t) attr->pointer;
@@ -219,15 +344,49 @@ static Buffer *vertexBuffer(const Model *self, const Attribute *attributes) {
 			attr++;
 		}
 	}
+}
 
-	const BufferData data = MakeBufferData(GL_ARRAY_BUFFER,
-										   vertexSize * self->vertices->count,
-										   vertices,
-										   GL_STATIC_DRAW);
+/**
+ * @fn Buffer *Model::vertexBuffer(const Model *self, const Attribute *attributes)
+ * @memberof Model
+ */
+static Buffer *vertexBuffer(const Model *self, const Attribute *attributes) {
+
+	JobSystem *jobs = $$(JobSystem, sharedInstance);
+
+	VertexPacking packing = {
+		.model = self,
+		.attributes = attributes,
+		.vertexSize = SizeOfAttributes(attributes),
+	};
+
+	const GLsizeiptr size = packing.vertexSize * self->vertices->count;
+
+	const BufferData data = MakeBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STATIC_DRAW);
 
 	Buffer *buffer = $(alloc(Buffer), initWithData, &data);
+	if (buffer == NULL || size == 0) {
+		return buffer;
+	}
+
+	packing.vertices = $(buffer, mapRange, GL_ARRAY_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (packing.vertices) {
+		$(jobs, parallelFor, self->vertices->count, MODEL_PARALLEL_GRAIN, packVertices, &packing);
+
+		if ($(buffer, unmap, GL_ARRAY_BUFFER)) {
+			return buffer;
+		}
+	}
+
+	packing.vertices = malloc(size);
+	assert(packing.vertices);
+
+	$(jobs, parallelFor, self->vertices->count, MODEL_PARALLEL_GRAIN, packVertices, &packing);
+
+	const BufferSubData subData = MakeBufferSubData(GL_ARRAY_BUFFER, 0, size, packing.vertices);
+	$(buffer, writeSubData, &subData);
 
-	free(vertices);
+	free(packing.vertices);
 
 	return buffer;
 }
@@ -241,6 +400,7 @@ static void initialize(Class *clazz) {
 
 	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
 
+	((ModelInterface *) clazz->interface)->calculateTangents = calculateTangents;
 	((ModelInterface *) clazz->interface)->elementsBuffer = elementsBuffer;
 	((ModelInterface *) clazz->interface)->init = init;
 	((ModelInterface *) clazz->interface)->initWithBytes = initWithBytes;
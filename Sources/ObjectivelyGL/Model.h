@@ -26,6 +26,7 @@
 #include <Objectively/Resource.h>
 #include <Objectively/Vector.h>
 
+#include <ObjectivelyGL/JobSystem.h>
 #include <ObjectivelyGL/VertexArray.h>
 
 /**
@@ -33,6 +34,11 @@
  * @brief ..
  */
 
+/**
+ * @brief The count of vertices or triangles per Job when processing Models in parallel.
+ */
+#define MODEL_PARALLEL_GRAIN 4096
+
 typedef struct Model Model;
 typedef struct ModelInterface ModelInterface;
 
@@ -175,6 +181,16 @@ struct ModelInterface {
 	 */
 	ObjectInterface objectInterface;
 
+	/**
+	 * @fn void Model::calculateTangents(Model *self)
+	 * @brief Calculates the tangent and bitangent vectors of this Model's vertices.
+	 * @param self The Model.
+	 * @remarks Tangents are calculated from the triangle meshes' diffuse texture coordinates, and
+	 * orthogonalized against the vertex normals, which must be unit length.
+	 * @memberof Model
+	 */
+	void (*calculateTangents)(Model *self);
+
 	/**
 	 * @fn Buffer *Model::elementsBuffer(const Model *self)
 	 * @param self The Model.
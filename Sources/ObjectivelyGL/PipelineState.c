@@ -0,0 +1,461 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <Objectively/Hash.h>
+#include <Objectively/Lock.h>
+
+#include "PipelineState.h"
+#include "StateCache.h"
+
+#define _Class _PipelineState
+
+/**
+ * @brief The interned PipelineStates, sorted by hash. PipelineStates are not retained by the table.
+ */
+static Vector *_states;
+
+/**
+ * @brief The Lock guarding the interned PipelineStates.
+ */
+static Lock *_lock;
+
+/**
+ * @brief The PipelineState last applied on this thread, and a copy of its descriptor.
+ */
+static __thread const PipelineState *_appliedState;
+static __thread PipelineDescriptor _applied;
+
+/**
+ * @brief True if the state last applied on this thread is known.
+ */
+static __thread _Bool _valid;
+
+/**
+ * @return The index of the first interned PipelineState with a hash not less than `hash`.
+ */
+static size_t _search(int hash) {
+
+	size_t i = 0, j = _states->count;
+	while (i < j) {
+		const size_t k = (i + j) / 2;
+		const PipelineState *state = *VectorElement(_states, PipelineState *, k);
+		if (state->hash < hash) {
+			i = k + 1;
+		} else {
+			j = k;
+		}
+	}
+
+	return i;
+}
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	PipelineState *this = (PipelineState *) self;
+
+	if (_lock) {
+		synchronized(_lock, {
+			for (size_t i = _search(this->hash); i < _states->count; i++) {
+				if (*VectorElement(_states, PipelineState *, i) == this) {
+					$(_states, removeElementAtIndex, i);
+					break;
+				}
+			}
+		});
+	}
+
+	if (_appliedState == this) {
+		_appliedState = NULL;
+		_valid = false;
+	}
+
+	release(this->descriptor.program);
+	release(this->descriptor.vertexArray);
+
+	super(Object, self, dealloc);
+}
+
+/**
+ * @see Object::hash(const Object *)
+ */
+static int hash(const Object *self) {
+	return ((PipelineState *) self)->hash;
+}
+
+/**
+ * @return True if the given PipelineDescriptors are equal.
+ */
+static _Bool _isEqualDescriptor(const PipelineDescriptor *a, const PipelineDescriptor *b) {
+
+	return a->program == b->program &&
+		a->vertexArray == b->vertexArray &&
+		a->depth.test == b->depth.test &&
+		a->depth.write == b->depth.write &&
+		a->depth.func == b->depth.func &&
+		a->blend.enabled == b->blend.enabled &&
+		a->blend.srcRGB == b->blend.srcRGB &&
+		a->blend.dstRGB == b->blend.dstRGB &&
+		a->blend.srcAlpha == b->blend.srcAlpha &&
+		a->blend.dstAlpha == b->blend.dstAlpha &&
+		a->blend.equationRGB == b->blend.equationRGB &&
+		a->blend.equationAlpha == b->blend.equationAlpha &&
+		a->blend.colorWrite == b->blend.colorWrite &&
+		a->raster.cullFace == b->raster.cullFace &&
+		a->raster.frontFace == b->raster.frontFace &&
+		a->raster.polygonMode == b->raster.polygonMode &&
+		a->raster.polygonOffsetFactor == b->raster.polygonOffsetFactor &&
+		a->raster.polygonOffsetUnits == b->raster.polygonOffsetUnits &&
+		a->raster.scissorTest == b->raster.scissorTest;
+}
+
+/**
+ * @see Object::isEqual(const Object *, const Object *)
+ */
+static _Bool isEqual(const Object *self, const Object *other) {
+
+	if (super(Object, self, isEqual, other)) {
+		return true;
+	}
+
+	if (other && $(other, isKindOfClass, _PipelineState())) {
+		const PipelineState *this = (PipelineState *) self;
+		const PipelineState *that = (PipelineState *) other;
+
+		return _isEqualDescriptor(&this->descriptor, &that->descriptor);
+	}
+
+	return false;
+}
+
+#pragma mark - PipelineState
+
+/**
+ * @fn size_t PipelineState::apply(const PipelineState *self)
+ * @memberof PipelineState
+ */
+static size_t apply(const PipelineState *self) {
+
+	const PipelineDescriptor *d = &self->descriptor;
+	const PipelineDescriptor *a = &_applied;
+
+	size_t changes = 0;
+
+	// Program, VertexArray and DrawList bind without invalidating, so the program and VertexArray
+	// are always bound, and the current StateCache elides them if they are already bound
+
+	StateCache *cache = $$(StateCache, currentCache);
+	const size_t calls = cache ? cache->stats.calls : 0;
+
+	if (d->program) {
+		$(d->program, use);
+	}
+
+	if (d->vertexArray) {
+		$(d->vertexArray, bind);
+	}
+
+	if (cache) {
+		changes += cache->stats.calls - calls;
+	} else {
+		changes += (d->program != NULL) + (d->vertexArray != NULL);
+	}
+
+	if (_valid && _appliedState == self) {
+		return changes;
+	}
+
+	const _Bool all = _valid == false;
+
+	if (all || d->depth.test != a->depth.test) {
+		$$(StateCache, currentSetEnabled, GL_DEPTH_TEST, d->depth.test);
+		changes++;
+	}
+
+	if (all || d->depth.write != a->depth.write) {
+		glDepthMask(d->depth.write);
+		changes++;
+	}
+
+	if (all || d->depth.func != a->depth.func) {
+		glDepthFunc(d->depth.func);
+		changes++;
+	}
+
+	if (all || d->blend.enabled != a->blend.enabled) {
+		$$(StateCache, currentSetEnabled, GL_BLEND, d->blend.enabled);
+		changes++;
+	}
+
+	if (all ||
+		d->blend.srcRGB != a->blend.srcRGB ||
+		d->blend.dstRGB != a->blend.dstRGB ||
+		d->blend.srcAlpha != a->blend.srcAlpha ||
+		d->blend.dstAlpha != a->blend.dstAlpha) {
+		glBlendFuncSeparate(d->blend.srcRGB, d->blend.dstRGB, d->blend.srcAlpha, d->blend.dstAlpha);
+		changes++;
+	}
+
+	if (all ||
+		d->blend.equationRGB != a->blend.equationRGB ||
+		d->blend.equationAlpha != a->blend.equationAlpha) {
+		glBlendEquationSeparate(d->blend.equationRGB, d->blend.equationAlpha);
+		changes++;
+	}
+
+	if (all || d->blend.colorWrite != a->blend.colorWrite) {
+		const GLboolean write = d->blend.colorWrite;
+		glColorMask(write, write, write, write);
+		changes++;
+	}
+
+	const _Bool cull = d->raster.cullFace != GL_NONE;
+	if (all || cull != (a->raster.cullFace != GL_NONE)) {
+		$$(StateCache, currentSetEnabled, GL_CULL_FACE, cull);
+		changes++;
+	}
+
+	if (cull && (all || d->raster.cullFace != a->raster.cullFace)) {
+		glCullFace(d->raster.cullFace);
+		changes++;
+	}
+
+	if (all || d->raster.frontFace != a->raster.frontFace) {
+		glFrontFace(d->raster.frontFace);
+		changes++;
+	}
+
+	if (all || d->raster.polygonMode != a->raster.polygonMode) {
+		glPolygonMode(GL_FRONT_AND_BACK, d->raster.polygonMode);
+		changes++;
+	}
+
+	const _Bool offset = d->raster.polygonOffsetFactor != 0.f || d->raster.polygonOffsetUnits != 0.f;
+	const _Bool appliedOffset = a->raster.polygonOffsetFactor != 0.f || a->raster.polygonOffsetUnits != 0.f;
+
+	if (all || offset != appliedOffset) {
+		$$(StateCache, currentSetEnabled, GL_POLYGON_OFFSET_FILL, offset);
+		changes++;
+	}
+
+	if (offset && (all ||
+		d->raster.polygonOffsetFactor != a->raster.polygonOffsetFactor ||
+		d->raster.polygonOffsetUnits != a->raster.polygonOffsetUnits)) {
+		glPolygonOffset(d->raster.polygonOffsetFactor, d->raster.polygonOffsetUnits);
+		changes++;
+	}
+
+	if (all || d->raster.scissorTest != a->raster.scissorTest) {
+		$$(StateCache, currentSetEnabled, GL_SCISSOR_TEST, d->raster.scissorTest);
+		changes++;
+	}
+
+	_appliedState = self;
+	_applied = *d;
+	_valid = true;
+
+	return changes;
+}
+
+/**
+ * @return The hash of the given PipelineDescriptor.
+ */
+static int _hashDescriptor(const PipelineDescriptor *d) {
+
+	int hash = HASH_SEED;
+
+	hash = HashForInteger(hash, (long) d->program);
+	hash = HashForInteger(hash, (long) d->vertexArray);
+
+	hash = HashForInteger(hash, d->depth.test);
+	hash = HashForInteger(hash, d->depth.write);
+	hash = HashForInteger(hash, d->depth.func);
+
+	hash = HashForInteger(hash, d->blend.enabled);
+	hash = HashForInteger(hash, d->blend.srcRGB);
+	hash = HashForInteger(hash, d->blend.dstRGB);
+	hash = HashForInteger(hash, d->blend.srcAlpha);
+	hash = HashForInteger(hash, d->blend.dstAlpha);
+	hash = HashForInteger(hash, d->blend.equationRGB);
+	hash = HashForInteger(hash, d->blend.equationAlpha);
+	hash = HashForInteger(hash, d->blend.colorWrite);
+
+	hash = HashForInteger(hash, d->raster.cullFace);
+	hash = HashForInteger(hash, d->raster.frontFace);
+	hash = HashForInteger(hash, d->raster.polygonMode);
+	hash = HashForInteger(hash, (long) (d->raster.polygonOffsetFactor * 1024.f));
+	hash = HashForInteger(hash, (long) (d->raster.polygonOffsetUnits * 1024.f));
+	hash = HashForInteger(hash, d->raster.scissorTest);
+
+	return hash;
+}
+
+/**
+ * @fn PipelineState *PipelineState::initWithDescriptor(PipelineState *self, const PipelineDescriptor *descriptor)
+ * @memberof PipelineState
+ */
+static PipelineState *initWithDescriptor(PipelineState *self, const PipelineDescriptor *descriptor) {
+
+	assert(descriptor);
+
+	self = (PipelineState *) super(Object, self, init);
+	if (self) {
+		self->descriptor = *descriptor;
+
+		retain(self->descriptor.program);
+		retain(self->descriptor.vertexArray);
+
+		self->hash = _hashDescriptor(descriptor);
+	}
+
+	return self;
+}
+
+/**
+ * @fn void PipelineState::invalidate(void)
+ * @memberof PipelineState
+ */
+static void invalidate(void) {
+	_appliedState = NULL;
+	_valid = false;
+}
+
+/**
+ * @brief Retains the given interned PipelineState, unless it is being deallocated.
+ * @return The PipelineState, or `NULL`.
+ */
+static PipelineState *_retainIfReferenced(PipelineState *state) {
+
+	Object *object = (Object *) state;
+
+	unsigned int count = object->referenceCount;
+	while (count) {
+		if (__sync_bool_compare_and_swap(&object->referenceCount, count, count + 1)) {
+			return state;
+		}
+		count = object->referenceCount;
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn PipelineState *PipelineState::pipelineStateWithDescriptor(const PipelineDescriptor *descriptor)
+ * @memberof PipelineState
+ */
+static PipelineState *pipelineStateWithDescriptor(const PipelineDescriptor *descriptor) {
+
+	const int hash = _hashDescriptor(descriptor);
+
+	PipelineState *state = NULL;
+
+	synchronized(_lock, {
+		size_t i = _search(hash);
+		for (; i < _states->count; i++) {
+			PipelineState *interned = *VectorElement(_states, PipelineState *, i);
+			if (interned->hash != hash) {
+				break;
+			}
+			if (_isEqualDescriptor(&interned->descriptor, descriptor)) {
+				state = _retainIfReferenced(interned);
+				if (state) {
+					break;
+				}
+			}
+		}
+
+		if (state == NULL) {
+			state = $(alloc(PipelineState), initWithDescriptor, descriptor);
+			assert(state);
+
+			$(_states, insertElementAtIndex, (const ident) &state, i);
+		}
+	});
+
+	return state;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+	((ObjectInterface *) clazz->interface)->hash = hash;
+	((ObjectInterface *) clazz->interface)->isEqual = isEqual;
+
+	((PipelineStateInterface *) clazz->interface)->apply = apply;
+	((PipelineStateInterface *) clazz->interface)->initWithDescriptor = initWithDescriptor;
+	((PipelineStateInterface *) clazz->interface)->invalidate = invalidate;
+	((PipelineStateInterface *) clazz->interface)->pipelineStateWithDescriptor = pipelineStateWithDescriptor;
+
+	_states = $(alloc(Vector), initWithSize, sizeof(PipelineState *));
+	assert(_states);
+
+	_lock = $(alloc(Lock), init);
+	assert(_lock);
+}
+
+/**
+ * @see Class::destroy(Class *)
+ */
+static void destroy(Class *clazz) {
+
+	_states = release(_states);
+	_lock = release(_lock);
+}
+
+/**
+ * @fn Class *PipelineState::_PipelineState(void)
+ * @memberof PipelineState
+ */
+Class *_PipelineState(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "PipelineState",
+			.superclass = _Object(),
+			.instanceSize = sizeof(PipelineState),
+			.interfaceOffset = offsetof(PipelineState, interface),
+			.interfaceSize = sizeof(PipelineStateInterface),
+			.initialize = initialize,
+			.destroy = destroy,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
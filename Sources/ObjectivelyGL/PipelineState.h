@@ -0,0 +1,316 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <ObjectivelyGL/Program.h>
+#include <ObjectivelyGL/VertexArray.h>
+
+/**
+ * @file
+ * @brief PipelineStates are immutable, interned snapshots of render pipeline state.
+ * @details A PipelineState captures the Program, VertexArray, and depth, blend and rasterizer state
+ * needed to draw. PipelineStates are interned by their PipelineDescriptor, so that equal
+ * descriptors yield the same instance. Applying a PipelineState issues only the depth, blend and
+ * rasterizer calls that differ from the PipelineState last applied on the calling thread, and binds
+ * its Program and VertexArray through the current StateCache.
+ */
+
+/**
+ * @brief Depth state.
+ */
+typedef struct {
+
+	/**
+	 * @brief True to enable the depth test.
+	 */
+	_Bool test;
+
+	/**
+	 * @brief True to enable writes to the depth buffer.
+	 */
+	_Bool write;
+
+	/**
+	 * @brief The depth comparison function, e.g. `GL_LESS`.
+	 */
+	GLenum func;
+
+} DepthState;
+
+/**
+ * @brief Creates a DepthState with the OpenGL defaults.
+ */
+#define MakeDepthState() \
+	(DepthState) { \
+		.test = false, \
+		.write = true, \
+		.func = GL_LESS \
+	}
+
+/**
+ * @brief Blend state.
+ */
+typedef struct {
+
+	/**
+	 * @brief True to enable blending.
+	 */
+	_Bool enabled;
+
+	/**
+	 * @brief The source and destination color blend factors, e.g. `GL_SRC_ALPHA`.
+	 */
+	GLenum srcRGB, dstRGB;
+
+	/**
+	 * @brief The source and destination alpha blend factors.
+	 */
+	GLenum srcAlpha, dstAlpha;
+
+	/**
+	 * @brief The color and alpha blend equations, e.g. `GL_FUNC_ADD`.
+	 */
+	GLenum equationRGB, equationAlpha;
+
+	/**
+	 * @brief True to enable writes to the color buffer.
+	 */
+	_Bool colorWrite;
+
+} BlendState;
+
+/**
+ * @brief Creates a BlendState with the OpenGL defaults.
+ */
+#define MakeBlendState() \
+	(BlendState) { \
+		.enabled = false, \
+		.srcRGB = GL_ONE, \
+		.dstRGB = GL_ZERO, \
+		.srcAlpha = GL_ONE, \
+		.dstAlpha = GL_ZERO, \
+		.equationRGB = GL_FUNC_ADD, \
+		.equationAlpha = GL_FUNC_ADD, \
+		.colorWrite = true \
+	}
+
+/**
+ * @brief Creates a BlendState for premultiplied or conventional alpha blending.
+ */
+#define MakeBlendStateAlpha(src) \
+	(BlendState) { \
+		.enabled = true, \
+		.srcRGB = src, \
+		.dstRGB = GL_ONE_MINUS_SRC_ALPHA, \
+		.srcAlpha = GL_ONE, \
+		.dstAlpha = GL_ONE_MINUS_SRC_ALPHA, \
+		.equationRGB = GL_FUNC_ADD, \
+		.equationAlpha = GL_FUNC_ADD, \
+		.colorWrite = true \
+	}
+
+/**
+ * @brief Rasterizer state.
+ */
+typedef struct {
+
+	/**
+	 * @brief The faces to cull, e.g. `GL_BACK`, or `GL_NONE` to disable face culling.
+	 */
+	GLenum cullFace;
+
+	/**
+	 * @brief The winding of front faces, e.g. `GL_CCW`.
+	 */
+	GLenum frontFace;
+
+	/**
+	 * @brief The polygon rasterization mode, e.g. `GL_FILL`.
+	 */
+	GLenum polygonMode;
+
+	/**
+	 * @brief The polygon offset factor and units. Polygon offset is disabled if both are `0`.
+	 */
+	GLfloat polygonOffsetFactor, polygonOffsetUnits;
+
+	/**
+	 * @brief True to enable the scissor test.
+	 */
+	_Bool scissorTest;
+
+} RasterState;
+
+/**
+ * @brief Creates a RasterState with the OpenGL defaults.
+ */
+#define MakeRasterState() \
+	(RasterState) { \
+		.cullFace = GL_NONE, \
+		.frontFace = GL_CCW, \
+		.polygonMode = GL_FILL, \
+		.polygonOffsetFactor = 0.f, \
+		.polygonOffsetUnits = 0.f, \
+		.scissorTest = false \
+	}
+
+/**
+ * @brief The descriptor of a PipelineState.
+ */
+typedef struct {
+
+	/**
+	 * @brief The Program.
+	 */
+	Program *program;
+
+	/**
+	 * @brief The VertexArray, or `NULL`.
+	 */
+	VertexArray *vertexArray;
+
+	/**
+	 * @brief The depth state.
+	 */
+	DepthState depth;
+
+	/**
+	 * @brief The blend state.
+	 */
+	BlendState blend;
+
+	/**
+	 * @brief The rasterizer state.
+	 */
+	RasterState raster;
+
+} PipelineDescriptor;
+
+/**
+ * @brief Creates a PipelineDescriptor for the given Program and VertexArray with the OpenGL
+ * default depth, blend and rasterizer state.
+ */
+#define MakePipelineDescriptor(_program, _vertexArray) \
+	(PipelineDescriptor) { \
+		.program = _program, \
+		.vertexArray = _vertexArray, \
+		.depth = MakeDepthState(), \
+		.blend = MakeBlendState(), \
+		.raster = MakeRasterState() \
+	}
+
+typedef struct PipelineState PipelineState;
+typedef struct PipelineStateInterface PipelineStateInterface;
+
+/**
+ * @brief The PipelineState type.
+ * @extends Object
+ */
+struct PipelineState {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	PipelineStateInterface *interface;
+
+	/**
+	 * @brief The descriptor.
+	 * @remarks The Program and VertexArray are retained.
+	 */
+	PipelineDescriptor descriptor;
+
+	/**
+	 * @brief The hash of the descriptor.
+	 */
+	int hash;
+};
+
+/**
+ * @brief The PipelineState interface.
+ */
+struct PipelineStateInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn size_t PipelineState::apply(const PipelineState *self)
+	 * @brief Applies this PipelineState, issuing only the GL calls that differ from the
+	 * PipelineState last applied on the calling thread.
+	 * @param self The PipelineState.
+	 * @return The count of GL state changes issued.
+	 * @remarks The program and VertexArray are bound on every call, because Program, VertexArray
+	 * and DrawList change them without invalidating. The current StateCache, if any, elides them
+	 * when they are already bound.
+	 * @memberof PipelineState
+	 */
+	size_t (*apply)(const PipelineState *self);
+
+	/**
+	 * @fn PipelineState *PipelineState::initWithDescriptor(PipelineState *self, const PipelineDescriptor *descriptor)
+	 * @brief Initializes this PipelineState with the given PipelineDescriptor.
+	 * @param self The PipelineState.
+	 * @param descriptor The PipelineDescriptor.
+	 * @return The initialized PipelineState, or `NULL` on error.
+	 * @remarks Most callers should prefer `pipelineStateWithDescriptor`, which interns.
+	 * @memberof PipelineState
+	 */
+	PipelineState *(*initWithDescriptor)(PipelineState *self, const PipelineDescriptor *descriptor);
+
+	/**
+	 * @fn void PipelineState::invalidate(void)
+	 * @brief Forgets the PipelineState last applied on the calling thread, so that the next
+	 * PipelineState applied issues all of its GL calls.
+	 * @remarks Call this after changing depth, blend or raster state by calling OpenGL directly.
+	 * @memberof PipelineState
+	 */
+	void (*invalidate)(void);
+
+	/**
+	 * @fn PipelineState *PipelineState::pipelineStateWithDescriptor(const PipelineDescriptor *descriptor)
+	 * @brief Returns the interned PipelineState for the given PipelineDescriptor, creating it
+	 * if necessary.
+	 * @param descriptor The PipelineDescriptor.
+	 * @return The retained PipelineState, which the caller must release.
+	 * @memberof PipelineState
+	 */
+	PipelineState *(*pipelineStateWithDescriptor)(const PipelineDescriptor *descriptor);
+};
+
+/**
+ * @fn Class *PipelineState::_PipelineState(void)
+ * @brief The PipelineState archetype.
+ * @return The PipelineState Class.
+ * @memberof PipelineState
+ */
+OBJECTIVELYGL_EXPORT Class *_PipelineState(void);
@@ -26,12 +26,164 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <Objectively/Hash.h>
 #include <Objectively/MutableString.h>
 
 #include "Program.h"
+#include "StateCache.h"
 
 #define _Class _Program
 
+/**
+ * @brief A slot in a VariableIndex.
+ */
+typedef struct {
+
+	/**
+	 * @brief The hash of the Variable name.
+	 */
+	int hash;
+
+	/**
+	 * @brief The index of the Variable, or `-1` if this slot is empty.
+	 */
+	GLint index;
+
+} VariableSlot;
+
+/**
+ * @brief An open addressing hash index of Variables by name.
+ */
+typedef struct {
+
+	/**
+	 * @brief The slots.
+	 */
+	VariableSlot *slots;
+
+	/**
+	 * @brief The count of slots, which is a power of two.
+	 */
+	size_t capacity;
+
+} VariableIndex;
+
+/**
+ * @brief Frees the given VariableIndex.
+ */
+static void _freeIndex(VariableIndex *index) {
+
+	if (index) {
+		free(index->slots);
+		free(index);
+	}
+}
+
+/**
+ * @return A new VariableIndex for the given Vector of Variables.
+ * @remarks The load factor is kept at or below one half, so that probe sequences are short.
+ */
+static VariableIndex *_index(const Vector *variables) {
+
+	VariableIndex *index = calloc(1, sizeof(VariableIndex));
+	assert(index);
+
+	index->capacity = 8;
+	while (index->capacity < variables->count * 2) {
+		index->capacity <<= 1;
+	}
+
+	index->slots = malloc(index->capacity * sizeof(VariableSlot));
+	assert(index->slots);
+
+	for (size_t i = 0; i < index->capacity; i++) {
+		index->slots[i].index = -1;
+	}
+
+	const Variable *var = variables->elements;
+	for (size_t i = 0; i < variables->count; i++, var++) {
+
+		const int hash = HashForCString(HASH_SEED, var->name);
+
+		size_t slot = (unsigned) hash & (index->capacity - 1);
+		while (index->slots[slot].index != -1) {
+			slot = (slot + 1) & (index->capacity - 1);
+		}
+
+		index->slots[slot] = (VariableSlot) { .hash = hash, .index = (GLint) i };
+	}
+
+	return index;
+}
+
+/**
+ * @return The index of the Variable with the given name, or `-1`.
+ */
+static GLint _lookup(const VariableIndex *index, const Vector *variables, const GLchar *name) {
+
+	if (index == NULL) {
+		return -1;
+	}
+
+	const int hash = HashForCString(HASH_SEED, name);
+
+	size_t slot = (unsigned) hash & (index->capacity - 1);
+	while (index->slots[slot].index != -1) {
+
+		const VariableSlot *s = &index->slots[slot];
+		if (s->hash == hash && !strcmp(name, VectorElement(variables, Variable, s->index)->name)) {
+			return s->index;
+		}
+
+		slot = (slot + 1) & (index->capacity - 1);
+	}
+
+	return -1;
+}
+
+/**
+ * @return The size of the value read by `setUniform` for the given Variable, in bytes, or `0` if
+ * its type is not supported.
+ */
+static GLsizei _length(const Variable *var) {
+
+	switch (var->type) {
+		case GL_FLOAT:
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+			return 4;
+		case GL_FLOAT_VEC2:
+		case GL_INT_VEC2:
+		case GL_UNSIGNED_INT_VEC2:
+			return 8 * var->size;
+		case GL_FLOAT_VEC3:
+		case GL_INT_VEC3:
+		case GL_UNSIGNED_INT_VEC3:
+			return 12 * var->size;
+		case GL_FLOAT_VEC4:
+		case GL_INT_VEC4:
+		case GL_UNSIGNED_INT_VEC4:
+			return 16 * var->size;
+		case GL_FLOAT_MAT3:
+			return 36 * var->size;
+		case GL_FLOAT_MAT4:
+			return 64 * var->size;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Frees the shadow copies of the given Vector of uniform Variables.
+ */
+static void _freeValues(Vector *uniforms) {
+
+	Variable *var = uniforms->elements;
+	for (size_t i = 0; i < uniforms->count; i++, var++) {
+		free(var->value);
+	}
+}
+
 #pragma mark - Object
 
 /**
@@ -43,12 +195,17 @@ static void dealloc(Object *self) {
 
 	$(this, detachAll);
 
+	_freeValues(this->uniforms);
+
 	release(this->shaders);
 	release(this->attributes);
 	release(this->uniforms);
 	release(this->uniformBlocks);
 
-	glDeleteProgram(this->name);
+	_freeIndex(this->attributeIndex);
+	_freeIndex(this->uniformIndex);
+
+	$$(StateCache, currentDeleteProgram, this->name);
 
 	super(Object, self, dealloc);
 }
@@ -119,14 +276,12 @@ static void attach(Program *self, Shader *shader) {
  */
 static const Variable *attributeForName(const Program *self, const GLchar *name) {
 
-	const Variable *attr = self->attributes->elements;
-	for (size_t i = 0; i < self->attributes->count; i++, attr++) {
-		if (!strcmp(name, attr->name)) {
-			return attr;
-		}
+	const GLint index = _lookup(self->attributeIndex, self->attributes, name);
+	if (index == -1) {
+		return NULL;
 	}
 
-	return NULL;
+	return VectorElement(self->attributes, Variable, index);
 }
 
 /**
@@ -264,6 +419,18 @@ static Program *initWithDescriptor(Program *self, ProgramDescriptor *descriptor)
 	return self;
 }
 
+/**
+ * @fn void Program::invalidateUniforms(Program *self)
+ * @memberof Program
+ */
+static void invalidateUniforms(Program *self) {
+
+	Variable *var = self->uniforms->elements;
+	for (size_t i = 0; i < self->uniforms->count; i++, var++) {
+		var->valid = GL_FALSE;
+	}
+}
+
 /**
  * @fn GLint Program::link(Program *self)
  * @memberof Program
@@ -277,6 +444,12 @@ static GLint link(Program *self) {
 
 	if (status == GL_TRUE) {
 
+		_freeValues(self->uniforms);
+
+		$(self->attributes, removeAllElements);
+		$(self->uniforms, removeAllElements);
+		$(self->uniformBlocks, removeAllElements);
+
 		GLint activeAttributes;
 		glGetProgramiv(self->name, GL_ACTIVE_ATTRIBUTES, &activeAttributes);
 		for (GLint i = 0; i < activeAttributes; i++) {
@@ -306,6 +479,13 @@ static GLint link(Program *self) {
 							   var.name);
 
 			var.location = glGetUniformLocation(self->name, var.name);
+
+			var.length = _length(&var);
+			if (var.length) {
+				var.value = calloc(1, var.length);
+				assert(var.value);
+			}
+
 			$(self->uniforms, addElement, &var);
 		}
 
@@ -326,6 +506,12 @@ static GLint link(Program *self) {
 
 			$(self->uniformBlocks, addElement, &block);
 		}
+
+		_freeIndex(self->attributeIndex);
+		self->attributeIndex = _index(self->attributes);
+
+		_freeIndex(self->uniformIndex);
+		self->uniformIndex = _index(self->uniforms);
 	}
 
 	return status;
@@ -337,6 +523,20 @@ static GLint link(Program *self) {
  */
 static void setUniform(const Program *self, const Variable *var, const GLvoid *value) {
 
+	ProgramStats *stats = (ProgramStats *) &self->stats;
+
+	if (var->value) {
+		if (var->valid && memcmp(var->value, value, var->length) == 0) {
+			stats->uniformsElided++;
+			return;
+		}
+
+		memcpy(var->value, value, var->length);
+		((Variable *) var)->valid = GL_TRUE;
+	}
+
+	stats->uniformUpdates++;
+
 	switch (var->type) {
 		case GL_FLOAT:
 			glUniform1f(var->location, *(GLfloat *) value);
@@ -392,8 +592,6 @@ static void setUniform(const Program *self, const Variable *var, const GLvoid *v
 			assert(false);
 			break;
 	}
-
-	assert(glGetError() == GL_NO_ERROR);
 }
 
 /**
@@ -421,6 +619,19 @@ static void setUniformBlockBindingForName(const Program *self, const GLchar *nam
 	}
 }
 
+/**
+ * @fn void Program::setUniformForHandle(const Program *self, UniformHandle handle, const void *value)
+ * @memberof Program
+ */
+static void setUniformForHandle(const Program *self, UniformHandle handle, const void *value) {
+
+	if (handle.index != -1) {
+		$(self, setUniform, VectorElement(self->uniforms, Variable, handle.index), value);
+	} else {
+		assert(false);
+	}
+}
+
 /**
  * @fn void Program::setUniformForName(const Program *self, const GLchar *name, const void *value)
  * @memberof Program
@@ -457,14 +668,20 @@ static const UniformBlock *uniformBlockForName(const Program *self, const GLchar
  */
 static const Variable *uniformForName(const Program *self, const GLchar *name) {
 
-	const Variable *var = self->uniforms->elements;
-	for (size_t i = 0; i < self->uniforms->count; i++, var++) {
-		if (!strcmp(name, var->name)) {
-			return var;
-		}
+	const GLint index = _lookup(self->uniformIndex, self->uniforms, name);
+	if (index == -1) {
+		return NULL;
 	}
 
-	return NULL;
+	return VectorElement(self->uniforms, Variable, index);
+}
+
+/**
+ * @fn UniformHandle Program::uniformHandleForName(const Program *self, const GLchar *name)
+ * @memberof Program
+ */
+static UniformHandle uniformHandleForName(const Program *self, const GLchar *name) {
+	return (UniformHandle) { _lookup(self->uniformIndex, self->uniforms, name) };
 }
 
 /**
@@ -473,7 +690,7 @@ static const Variable *uniformForName(const Program *self, const GLchar *name) {
  */
 static void use(const Program *self) {
 
-	glUseProgram(self->name);
+	$$(StateCache, currentUseProgram, self->name);
 
 	if (self->use) {
 		self->use(self);
@@ -498,13 +715,16 @@ static void initialize(Class *clazz) {
 	((ProgramInterface *) clazz->interface)->init = init;
 	((ProgramInterface *) clazz->interface)->initWithShaders = initWithShaders;
 	((ProgramInterface *) clazz->interface)->initWithDescriptor = initWithDescriptor;
+	((ProgramInterface *) clazz->interface)->invalidateUniforms = invalidateUniforms;
 	((ProgramInterface *) clazz->interface)->link = link;
 	((ProgramInterface *) clazz->interface)->setUniform = setUniform;
 	((ProgramInterface *) clazz->interface)->setUniformBlockBinding = setUniformBlockBinding;
 	((ProgramInterface *) clazz->interface)->setUniformBlockBindingForName = setUniformBlockBindingForName;
+	((ProgramInterface *) clazz->interface)->setUniformForHandle = setUniformForHandle;
 	((ProgramInterface *) clazz->interface)->setUniformForName = setUniformForName;
 	((ProgramInterface *) clazz->interface)->uniformBlockForName = uniformBlockForName;
 	((ProgramInterface *) clazz->interface)->uniformForName = uniformForName;
+	((ProgramInterface *) clazz->interface)->uniformHandleForName = uniformHandleForName;
 	((ProgramInterface *) clazz->interface)->use = use;
 }
 
@@ -109,8 +109,63 @@ typedef struct {
 	 */
 	GLenum type;
 
+	/**
+	 * @brief The shadow copy of a uniform Variable's current value, or `NULL`.
+	 * @private
+	 */
+	GLvoid *value;
+
+	/**
+	 * @brief The size of the shadow copy, in bytes.
+	 * @private
+	 */
+	GLsizei length;
+
+	/**
+	 * @brief True if the shadow copy holds the current value.
+	 * @private
+	 */
+	GLboolean valid;
+
 } Variable;
 
+/**
+ * @brief Program statistics.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of uniform updates issued to GL.
+	 */
+	size_t uniformUpdates;
+
+	/**
+	 * @brief The count of uniform updates elided because the value was unchanged.
+	 */
+	size_t uniformsElided;
+
+} ProgramStats;
+
+/**
+ * @brief UniformHandles are pre-resolved references to uniform Variables.
+ * @details Callers that set the same uniforms repeatedly should resolve their handles once, with
+ * `uniformHandleForName`, and set them with `setUniformForHandle`. UniformHandles remain valid
+ * until the Program is linked again.
+ */
+typedef struct {
+
+	/**
+	 * @brief The index of the uniform Variable in the Program's uniforms, or `-1`.
+	 */
+	GLint index;
+
+} UniformHandle;
+
+/**
+ * @brief The UniformHandle of uniform Variables that are not active in a Program.
+ */
+#define UniformHandleNone (UniformHandle) { -1 }
+
 /**
  * @brief Uniform blocks.
  */
@@ -175,6 +230,17 @@ struct Program {
 	 */
 	Vector *uniformBlocks;
 
+	/**
+	 * @brief The hash indexes of attribute and uniform Variables by name, built on `link`.
+	 * @private
+	 */
+	ident attributeIndex, uniformIndex;
+
+	/**
+	 * @brief The statistics.
+	 */
+	ProgramStats stats;
+
 	/**
 	 * @brief An optional callback that, if set, is called on `use`.
 	 */
@@ -274,9 +340,21 @@ struct ProgramInterface {
 	 */
 	Program *(*initWithDescriptor)(Program *self, ProgramDescriptor *descriptor);
 	
+	/**
+	 * @fn void Program::invalidateUniforms(Program *self)
+	 * @brief Invalidates the shadow copies of this Program's uniform values.
+	 * @details Call this after setting this Program's uniforms outside of ObjectivelyGL, e.g. with
+	 * `glUniform*` or `glProgramUniform*` directly, so that the next `setUniform` of each
+	 * uniform is issued to GL.
+	 * @param self The Program.
+	 * @memberof Program
+	 */
+	void (*invalidateUniforms)(Program *self);
+
 	/**
 	 * @fn GLint Program::link(Program *self)
 	 * @brief Links this Program and resolves all attribute and uniform Variables.
+	 * @details The Variables are indexed by name, so that lookups by name are constant time.
 	 * @param self The Program.
 	 * @return `GL_TRUE` on success, `GL_FALSE` on error.
 	 * @memberof Program
@@ -286,6 +364,8 @@ struct ProgramInterface {
 	/**
 	 * @fn void Program::setUniform(const Program *self, const Variable *variable, const GLvoid *value)
 	 * @brief Sets the uniform Variable to the specified value.
+	 * @details The value is compared to the Variable's shadow copy, and the update is elided if
+	 * it is unchanged.
 	 * @param self The Program.
 	 * @param variable The uniform Variable.
 	 * @param value The value, which must be a pointer.
@@ -313,6 +393,16 @@ struct ProgramInterface {
 	 */
 	void (*setUniformBlockBindingForName)(const Program *self, const GLchar *name, GLuint index);
 
+	/**
+	 * @fn void Program::setUniformForHandle(const Program *self, UniformHandle handle, const void *value)
+	 * @brief Sets the uniform Variable for the given UniformHandle to the specified value.
+	 * @param self The Program.
+	 * @param handle The UniformHandle.
+	 * @param value The value, which must be a pointer.
+	 * @memberof Program
+	 */
+	void (*setUniformForHandle)(const Program *self, UniformHandle handle, const void *value);
+
 	/**
 	 * @fn void Program::setUniformForName(const Program *self, const GLchar *name, const void *value)
 	 * @brief Sets the uniform Variable for the given name to the specified value.
@@ -340,6 +430,15 @@ struct ProgramInterface {
 	 * @memberof Program
 	 */
 	const Variable *(*uniformForName)(const Program *self, const GLchar *name);
+
+	/**
+	 * @fn UniformHandle Program::uniformHandleForName(const Program *self, const GLchar *name)
+	 * @param self The Program.
+	 * @param name The uniform Variable name.
+	 * @return The UniformHandle for the given name, or `UniformHandleNone`.
+	 * @memberof Program
+	 */
+	UniformHandle (*uniformHandleForName)(const Program *self, const GLchar *name);
 	
 	/**
 	 * @fn void Program::use(const Program *self)
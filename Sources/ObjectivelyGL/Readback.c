@@ -0,0 +1,404 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Readback.h"
+
+#define _Class _Readback
+
+/**
+ * @brief A read in flight.
+ */
+typedef struct {
+
+	/**
+	 * @brief The pixel pack Buffer.
+	 */
+	Buffer *buffer;
+
+	/**
+	 * @brief The fence, signaled once the pixels are available in `buffer`.
+	 */
+	GLsync sync;
+
+	/**
+	 * @brief True once the commands preceding `sync` have been flushed.
+	 */
+	_Bool flushed;
+
+	/**
+	 * @brief The ReadbackFunction.
+	 */
+	ReadbackFunction function;
+
+	/**
+	 * @brief The ReadbackResult, less its pixels.
+	 */
+	ReadbackResult result;
+
+} ReadbackRead;
+
+/**
+ * @brief A read awaiting delivery on a CommandQueue, followed by its pixels.
+ */
+typedef struct {
+
+	/**
+	 * @brief The ReadbackFunction.
+	 */
+	ReadbackFunction function;
+
+	/**
+	 * @brief The ReadbackResult.
+	 */
+	ReadbackResult result;
+
+} ReadbackDelivery;
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	Readback *this = (Readback *) self;
+
+	ReadbackRead *reads = this->reads;
+	for (size_t i = 0; i < this->count; i++) {
+		if (reads[i].sync) {
+			glDeleteSync(reads[i].sync);
+		}
+		release(reads[i].buffer);
+	}
+
+	free(this->reads);
+
+	release(this->queue);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - Readback
+
+/**
+ * @brief Consumer for ReadbackDeliveries on the CommandQueue.
+ */
+static void _deliver(ident data) {
+
+	ReadbackDelivery *delivery = data;
+
+	delivery->function(&delivery->result);
+
+	free(delivery);
+}
+
+/**
+ * @brief Maps the pixels of the oldest read in flight, and delivers them.
+ */
+static void _complete(Readback *self) {
+
+	ReadbackRead *read = (ReadbackRead *) self->reads + self->tail;
+
+	glDeleteSync(read->sync);
+	read->sync = NULL;
+
+	$(read->buffer, bind, GL_PIXEL_PACK_BUFFER);
+
+	ident pixels = $(read->buffer, mapRange, GL_PIXEL_PACK_BUFFER, 0, read->result.size, GL_MAP_READ_BIT);
+	if (pixels) {
+
+		if (self->queue) {
+			ReadbackDelivery *delivery = malloc(sizeof(ReadbackDelivery) + read->result.size);
+			assert(delivery);
+
+			delivery->function = read->function;
+			delivery->result = read->result;
+			delivery->result.pixels = memcpy(delivery + 1, pixels, read->result.size);
+
+			if ($(self->queue, enqueue, _deliver, delivery) == false) {
+				free(delivery);
+				self->overruns++;
+			}
+		} else {
+			read->result.pixels = pixels;
+			read->function(&read->result);
+			read->result.pixels = NULL;
+		}
+
+		$(read->buffer, unmap, GL_PIXEL_PACK_BUFFER);
+	}
+
+	$(read->buffer, unbind, GL_PIXEL_PACK_BUFFER);
+
+	self->tail = (self->tail + 1) % self->count;
+	self->pending--;
+}
+
+/**
+ * @fn Readback *Readback::initWithSize(Readback *self, GLsizeiptr size, size_t count, CommandQueue *queue)
+ * @memberof Readback
+ */
+static Readback *initWithSize(Readback *self, GLsizeiptr size, size_t count, CommandQueue *queue) {
+
+	assert(size > 0);
+	assert(count > 0);
+
+	self = (Readback *) super(Object, self, init);
+	if (self) {
+
+		self->reads = calloc(count, sizeof(ReadbackRead));
+		assert(self->reads);
+
+		self->count = count;
+		self->size = size;
+
+		ReadbackRead *reads = self->reads;
+		for (size_t i = 0; i < count; i++) {
+			reads[i].buffer = $(alloc(Buffer), initWithData, &MakeBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ));
+			if (reads[i].buffer == NULL) {
+				return release(self);
+			}
+		}
+
+		$(reads[count - 1].buffer, unbind, GL_PIXEL_PACK_BUFFER);
+
+		if (queue) {
+			self->queue = retain(queue);
+		}
+	}
+
+	return self;
+}
+
+/**
+ * @fn size_t Readback::poll(Readback *self)
+ * @memberof Readback
+ */
+static size_t poll(Readback *self) {
+
+	size_t count = 0;
+
+	while (self->pending) {
+
+		ReadbackRead *read = (ReadbackRead *) self->reads + self->tail;
+
+		// the first poll flushes, else the fence may never be submitted to the GPU
+
+		const GLbitfield flags = read->flushed ? 0 : GL_SYNC_FLUSH_COMMANDS_BIT;
+		read->flushed = true;
+
+		const GLenum status = glClientWaitSync(read->sync, flags, 0);
+		if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+			_complete(self);
+			count++;
+		} else {
+			break;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * @fn _Bool Readback::readPixels(Readback *self, const ReadbackRegion *region, ReadbackFunction function, ident data)
+ * @memberof Readback
+ */
+static _Bool readPixels(Readback *self, const ReadbackRegion *region, ReadbackFunction function, ident data) {
+
+	assert(function);
+
+	const GLsizeiptr size = $$(Readback, sizeOfRegion, region);
+
+	assert(size > 0);
+	assert(size <= self->size);
+
+	if (self->pending == self->count) {
+		self->overruns++;
+		return false;
+	}
+
+	ReadbackRead *read = (ReadbackRead *) self->reads + (self->tail + self->pending) % self->count;
+
+	$(read->buffer, bind, GL_PIXEL_PACK_BUFFER);
+
+	GLint alignment;
+	glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+	glReadPixels(region->x, region->y, region->width, region->height, region->format, region->type, NULL);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+
+	$(read->buffer, unbind, GL_PIXEL_PACK_BUFFER);
+
+	read->sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	read->flushed = false;
+	read->function = function;
+	read->result = (ReadbackResult) {
+		.region = *region,
+		.size = size,
+		.data = data
+	};
+
+	self->pending++;
+	return true;
+}
+
+/**
+ * @fn GLsizeiptr Readback::sizeOfRegion(const ReadbackRegion *region)
+ * @memberof Readback
+ */
+static GLsizeiptr sizeOfRegion(const ReadbackRegion *region) {
+
+	GLsizeiptr components;
+	switch (region->format) {
+		case GL_RED:
+		case GL_GREEN:
+		case GL_BLUE:
+		case GL_RED_INTEGER:
+		case GL_DEPTH_COMPONENT:
+		case GL_STENCIL_INDEX:
+		case GL_DEPTH_STENCIL:
+			components = 1;
+			break;
+		case GL_RG:
+		case GL_RG_INTEGER:
+			components = 2;
+			break;
+		case GL_RGB:
+		case GL_BGR:
+		case GL_RGB_INTEGER:
+			components = 3;
+			break;
+		case GL_RGBA:
+		case GL_BGRA:
+		case GL_RGBA_INTEGER:
+			components = 4;
+			break;
+		default:
+			return 0;
+	}
+
+	GLsizeiptr bytes;
+	switch (region->type) {
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+			bytes = components;
+			break;
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+		case GL_HALF_FLOAT:
+			bytes = components * 2;
+			break;
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT:
+			bytes = components * 4;
+			break;
+		case GL_UNSIGNED_INT_8_8_8_8:
+		case GL_UNSIGNED_INT_8_8_8_8_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_24_8:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+			bytes = 4;
+			break;
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+			bytes = 8;
+			break;
+		default:
+			return 0;
+	}
+
+	return bytes * region->width * region->height;
+}
+
+/**
+ * @fn size_t Readback::wait(Readback *self)
+ * @memberof Readback
+ */
+static size_t wait(Readback *self) {
+
+	size_t count = 0;
+
+	while (self->pending) {
+
+		const ReadbackRead *read = (ReadbackRead *) self->reads + self->tail;
+
+		GLenum status;
+		do {
+			status = glClientWaitSync(read->sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		} while (status == GL_TIMEOUT_EXPIRED);
+
+		assert(status != GL_WAIT_FAILED);
+
+		_complete(self);
+		count++;
+	}
+
+	return count;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((ReadbackInterface *) clazz->interface)->initWithSize = initWithSize;
+	((ReadbackInterface *) clazz->interface)->poll = poll;
+	((ReadbackInterface *) clazz->interface)->readPixels = readPixels;
+	((ReadbackInterface *) clazz->interface)->sizeOfRegion = sizeOfRegion;
+	((ReadbackInterface *) clazz->interface)->wait = wait;
+}
+
+/**
+ * @fn Class *Readback::_Readback(void)
+ * @memberof Readback
+ */
+Class *_Readback(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "Readback",
+			.superclass = _Object(),
+			.instanceSize = sizeof(Readback),
+			.interfaceOffset = offsetof(Readback, interface),
+			.interfaceSize = sizeof(ReadbackInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
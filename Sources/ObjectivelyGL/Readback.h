@@ -0,0 +1,242 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <ObjectivelyGL/Buffer.h>
+#include <ObjectivelyGL/CommandQueue.h>
+
+/**
+ * @file
+ * @brief Readbacks read framebuffer regions asynchronously, through a pool of pixel pack Buffers.
+ * @details `glReadPixels` into client memory stalls the calling thread until the GPU has finished
+ * rendering the region. A Readback instead reads into a `GL_PIXEL_PACK_BUFFER`, guarded by a fence,
+ * and copies the pixels out once the fence has been signaled, typically a few frames later. Each
+ * Buffer in the pool holds one read in flight, so that reads may be issued every frame for
+ * continuous capture.
+ *
+ * Completed reads are delivered to a ReadbackFunction on the Readback's CommandQueue, or on the
+ * thread calling _poll_ if it has none.
+ */
+
+/**
+ * @brief The default count of Buffers in a Readback's pool.
+ */
+#define READBACK_DEFAULT_BUFFERS 3
+
+/**
+ * @brief A framebuffer region to read back.
+ */
+typedef struct {
+
+	/**
+	 * @brief The origin of the region, in window coordinates.
+	 */
+	GLint x, y;
+
+	/**
+	 * @brief The size of the region, in pixels.
+	 */
+	GLsizei width, height;
+
+	/**
+	 * @brief The pixel format, e.g. `GL_RGBA`.
+	 */
+	GLenum format;
+
+	/**
+	 * @brief The pixel type, e.g. `GL_UNSIGNED_BYTE`.
+	 */
+	GLenum type;
+
+} ReadbackRegion;
+
+/**
+ * @brief Creates a ReadbackRegion.
+ */
+#define MakeReadbackRegion(x, y, width, height, format, type) \
+	(ReadbackRegion) { (x), (y), (width), (height), (format), (type) }
+
+/**
+ * @brief A completed read.
+ */
+typedef struct {
+
+	/**
+	 * @brief The region read.
+	 */
+	ReadbackRegion region;
+
+	/**
+	 * @brief The pixels, tightly packed, which are valid only for the duration of the delivery.
+	 */
+	const GLvoid *pixels;
+
+	/**
+	 * @brief The size of the pixels, in bytes.
+	 */
+	GLsizeiptr size;
+
+	/**
+	 * @brief The user data.
+	 */
+	ident data;
+
+} ReadbackResult;
+
+/**
+ * @brief The function type for Readback delivery.
+ */
+typedef void (*ReadbackFunction)(const ReadbackResult *result);
+
+typedef struct Readback Readback;
+typedef struct ReadbackInterface ReadbackInterface;
+
+/**
+ * @brief The Readback type.
+ * @extends Object
+ */
+struct Readback {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	ReadbackInterface *interface;
+
+	/**
+	 * @brief The CommandQueue on which reads are delivered, or `NULL`.
+	 */
+	CommandQueue *queue;
+
+	/**
+	 * @brief The pool of reads.
+	 * @private
+	 */
+	ident reads;
+
+	/**
+	 * @brief The count of Buffers in the pool.
+	 */
+	size_t count;
+
+	/**
+	 * @brief The size of each Buffer in the pool, in bytes.
+	 */
+	GLsizeiptr size;
+
+	/**
+	 * @brief The index of the oldest read in flight.
+	 * @private
+	 */
+	size_t tail;
+
+	/**
+	 * @brief The count of reads in flight.
+	 */
+	size_t pending;
+
+	/**
+	 * @brief The count of reads refused because the pool was exhausted, or dropped because their
+	 * delivery could not be enqueued on the CommandQueue.
+	 */
+	size_t overruns;
+};
+
+/**
+ * @brief The Readback interface.
+ */
+struct ReadbackInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn Readback *Readback::initWithSize(Readback *self, GLsizeiptr size, size_t count, CommandQueue *queue)
+	 * @brief Initializes this Readback with a pool of Buffers.
+	 * @param self The Readback.
+	 * @param size The size of each Buffer, in bytes, which limits the size of each read.
+	 * @param count The count of Buffers, and so of reads in flight.
+	 * @param queue The CommandQueue on which to deliver reads, or `NULL` to deliver them on the
+	 * thread calling _poll_.
+	 * @return The initialized Readback, or `NULL` on error.
+	 * @memberof Readback
+	 */
+	Readback *(*initWithSize)(Readback *self, GLsizeiptr size, size_t count, CommandQueue *queue);
+
+	/**
+	 * @fn size_t Readback::poll(Readback *self)
+	 * @brief Delivers the reads whose fences have been signaled, without blocking.
+	 * @param self The Readback.
+	 * @return The count of reads delivered.
+	 * @remarks This must be called on the thread owning the GL context, typically once per frame.
+	 * @memberof Readback
+	 */
+	size_t (*poll)(Readback *self);
+
+	/**
+	 * @fn _Bool Readback::readPixels(Readback *self, const ReadbackRegion *region, ReadbackFunction function, ident data)
+	 * @brief Reads the given region of the framebuffer bound to `GL_READ_FRAMEBUFFER`.
+	 * @param self The Readback.
+	 * @param region The ReadbackRegion.
+	 * @param function The ReadbackFunction to deliver the read to.
+	 * @param data User data.
+	 * @return True if the read was issued, false if the pool was exhausted.
+	 * @memberof Readback
+	 */
+	_Bool (*readPixels)(Readback *self, const ReadbackRegion *region, ReadbackFunction function, ident data);
+
+	/**
+	 * @fn GLsizeiptr Readback::sizeOfRegion(const ReadbackRegion *region)
+	 * @brief Calculates the size of the given region, tightly packed.
+	 * @param region The ReadbackRegion.
+	 * @return The size of the region, in bytes, or `0` if its format or type is not supported.
+	 * @memberof Readback
+	 */
+	GLsizeiptr (*sizeOfRegion)(const ReadbackRegion *region);
+
+	/**
+	 * @fn size_t Readback::wait(Readback *self)
+	 * @brief Waits for and delivers all reads in flight.
+	 * @param self The Readback.
+	 * @return The count of reads delivered.
+	 * @memberof Readback
+	 */
+	size_t (*wait)(Readback *self);
+};
+
+/**
+ * @fn Class *Readback::_Readback(void)
+ * @brief The Readback archetype.
+ * @return The Readback Class.
+ * @memberof Readback
+ */
+OBJECTIVELYGL_EXPORT Class *_Readback(void);
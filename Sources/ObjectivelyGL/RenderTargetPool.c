@@ -0,0 +1,370 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+
+#include "RenderTargetPool.h"
+
+#define _Class _RenderTargetPool
+
+/**
+ * @brief A pooled attachment.
+ */
+typedef struct {
+
+	/**
+	 * @brief The descriptor.
+	 */
+	RenderTargetDescriptor descriptor;
+
+	/**
+	 * @brief The Texture, or `NULL`.
+	 */
+	Texture *texture;
+
+	/**
+	 * @brief The Renderbuffer, or `NULL`.
+	 */
+	Renderbuffer *renderbuffer;
+
+	/**
+	 * @brief True if this attachment is acquired.
+	 */
+	_Bool acquired;
+
+	/**
+	 * @brief The frame in which this attachment was last acquired.
+	 */
+	uint64_t frame;
+
+} RenderTarget;
+
+/**
+ * @return The estimated size of the given RenderTarget, in bytes.
+ */
+static GLsizeiptr _size(const RenderTarget *target) {
+	return target->texture ? target->texture->size : target->renderbuffer->size;
+}
+
+/**
+ * @brief Releases the RenderTarget at the given index.
+ */
+static void _remove(RenderTargetPool *self, size_t index) {
+
+	RenderTarget *target = VectorElement(self->targets, RenderTarget, index);
+
+	self->stats.bytes -= _size(target);
+
+	release(target->texture);
+	release(target->renderbuffer);
+
+	$(self->targets, removeElementAtIndex, index);
+}
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	RenderTargetPool *this = (RenderTargetPool *) self;
+
+	const RenderTarget *target = this->targets->elements;
+	for (size_t i = 0; i < this->targets->count; i++, target++) {
+		release(target->texture);
+		release(target->renderbuffer);
+	}
+
+	release(this->targets);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - RenderTargetPool
+
+/**
+ * @return The first RenderTarget of the given kind matching the given descriptor that is not
+ * acquired, or `NULL`.
+ */
+static RenderTarget *_find(RenderTargetPool *self, const RenderTargetDescriptor *descriptor, _Bool texture) {
+
+	RenderTarget *target = self->targets->elements;
+	for (size_t i = 0; i < self->targets->count; i++, target++) {
+
+		if (target->acquired || (target->texture != NULL) != texture) {
+			continue;
+		}
+
+		if (target->descriptor.width == descriptor->width &&
+			target->descriptor.height == descriptor->height &&
+			target->descriptor.internalFormat == descriptor->internalFormat &&
+			target->descriptor.samples == descriptor->samples &&
+			target->descriptor.levels == descriptor->levels) {
+			return target;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Acquires the given RenderTarget.
+ */
+static void _acquire(RenderTargetPool *self, RenderTarget *target) {
+
+	target->acquired = true;
+	target->frame = self->frame;
+
+	self->stats.acquired++;
+}
+
+/**
+ * @brief Adds and acquires a RenderTarget for the given attachment.
+ */
+static void _add(RenderTargetPool *self, const RenderTargetDescriptor *descriptor, Texture *texture, Renderbuffer *renderbuffer) {
+
+	RenderTarget target = {
+		.descriptor = *descriptor,
+		.texture = texture,
+		.renderbuffer = renderbuffer
+	};
+
+	_acquire(self, &target);
+
+	$(self->targets, addElement, &target);
+
+	self->stats.allocations++;
+	self->stats.bytes += _size(&target);
+}
+
+/**
+ * @fn Renderbuffer *RenderTargetPool::acquireRenderbuffer(RenderTargetPool *self, const RenderTargetDescriptor *descriptor)
+ * @memberof RenderTargetPool
+ */
+static Renderbuffer *acquireRenderbuffer(RenderTargetPool *self, const RenderTargetDescriptor *descriptor) {
+
+	assert(descriptor->levels == 1);
+
+	RenderTarget *target = _find(self, descriptor, false);
+	if (target) {
+		_acquire(self, target);
+		self->stats.recycles++;
+		return target->renderbuffer;
+	}
+
+	const RenderbufferStorage storage = MakeRenderbufferStorage(descriptor->internalFormat,
+																descriptor->width,
+																descriptor->height,
+																descriptor->samples);
+
+	Renderbuffer *renderbuffer = $(alloc(Renderbuffer), initWithStorage, &storage);
+	assert(renderbuffer);
+
+	_add(self, descriptor, NULL, renderbuffer);
+
+	return renderbuffer;
+}
+
+/**
+ * @brief Resolves a pixel format and type compatible with the given internal format.
+ */
+static void _formatForInternalFormat(GLenum internalFormat, GLenum *format, GLenum *type) {
+
+	switch (internalFormat) {
+		case GL_DEPTH_COMPONENT16:
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32:
+		case GL_DEPTH_COMPONENT32F:
+			*format = GL_DEPTH_COMPONENT;
+			*type = GL_FLOAT;
+			break;
+		case GL_DEPTH24_STENCIL8:
+			*format = GL_DEPTH_STENCIL;
+			*type = GL_UNSIGNED_INT_24_8;
+			break;
+		case GL_DEPTH32F_STENCIL8:
+			*format = GL_DEPTH_STENCIL;
+			*type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+			break;
+		default:
+			*format = GL_RGBA;
+			*type = GL_UNSIGNED_BYTE;
+			break;
+	}
+}
+
+/**
+ * @fn Texture *RenderTargetPool::acquireTexture(RenderTargetPool *self, const RenderTargetDescriptor *descriptor)
+ * @memberof RenderTargetPool
+ */
+static Texture *acquireTexture(RenderTargetPool *self, const RenderTargetDescriptor *descriptor) {
+
+	assert(descriptor->samples == 0);
+	assert(descriptor->levels > 0);
+
+	RenderTarget *target = _find(self, descriptor, true);
+	if (target) {
+		_acquire(self, target);
+		self->stats.recycles++;
+		return target->texture;
+	}
+
+	const GLenum internalFormat = descriptor->internalFormat;
+	const GLsizei width = descriptor->width, height = descriptor->height;
+
+	Texture *texture = $(alloc(Texture), initWithStorage, &MakeTextureStorage2D(descriptor->levels, internalFormat, width, height));
+	if (texture == NULL) {
+		GLenum format, type;
+		_formatForInternalFormat(internalFormat, &format, &type);
+
+		texture = $(alloc(Texture), initWithTextureData, &MakeTextureData(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL));
+		assert(texture);
+	}
+
+	$(texture, bind, GL_TEXTURE_2D);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, descriptor->levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, descriptor->levels - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	$(texture, unbind, GL_TEXTURE_2D);
+
+	_add(self, descriptor, texture, NULL);
+
+	return texture;
+}
+
+/**
+ * @fn RenderTargetPool *RenderTargetPool::init(RenderTargetPool *self)
+ * @memberof RenderTargetPool
+ */
+static RenderTargetPool *init(RenderTargetPool *self) {
+
+	self = (RenderTargetPool *) super(Object, self, init);
+	if (self) {
+
+		self->targets = $(alloc(Vector), initWithSize, sizeof(RenderTarget));
+		assert(self->targets);
+
+		self->maxIdleFrames = RENDER_TARGET_POOL_MAX_IDLE_FRAMES;
+	}
+
+	return self;
+}
+
+/**
+ * @fn void RenderTargetPool::nextFrame(RenderTargetPool *self)
+ * @memberof RenderTargetPool
+ */
+static void nextFrame(RenderTargetPool *self) {
+
+	self->frame++;
+
+	for (size_t i = self->targets->count; i > 0; i--) {
+		const RenderTarget *target = VectorElement(self->targets, RenderTarget, i - 1);
+		if (target->acquired == false && target->frame + self->maxIdleFrames < self->frame) {
+			_remove(self, i - 1);
+			self->stats.purges++;
+		}
+	}
+}
+
+/**
+ * @fn void RenderTargetPool::purge(RenderTargetPool *self)
+ * @memberof RenderTargetPool
+ */
+static void purge(RenderTargetPool *self) {
+
+	for (size_t i = self->targets->count; i > 0; i--) {
+		const RenderTarget *target = VectorElement(self->targets, RenderTarget, i - 1);
+		if (target->acquired == false) {
+			_remove(self, i - 1);
+			self->stats.purges++;
+		}
+	}
+}
+
+/**
+ * @fn void RenderTargetPool::relinquish(RenderTargetPool *self, const ident attachment)
+ * @memberof RenderTargetPool
+ */
+static void relinquish(RenderTargetPool *self, const ident attachment) {
+
+	RenderTarget *target = self->targets->elements;
+	for (size_t i = 0; i < self->targets->count; i++, target++) {
+		if (target->texture == attachment || target->renderbuffer == attachment) {
+			assert(target->acquired);
+
+			target->acquired = false;
+			self->stats.acquired--;
+			return;
+		}
+	}
+
+	assert(false);
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((RenderTargetPoolInterface *) clazz->interface)->acquireRenderbuffer = acquireRenderbuffer;
+	((RenderTargetPoolInterface *) clazz->interface)->acquireTexture = acquireTexture;
+	((RenderTargetPoolInterface *) clazz->interface)->init = init;
+	((RenderTargetPoolInterface *) clazz->interface)->nextFrame = nextFrame;
+	((RenderTargetPoolInterface *) clazz->interface)->purge = purge;
+	((RenderTargetPoolInterface *) clazz->interface)->relinquish = relinquish;
+}
+
+/**
+ * @fn Class *RenderTargetPool::_RenderTargetPool(void)
+ * @memberof RenderTargetPool
+ */
+Class *_RenderTargetPool(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "RenderTargetPool",
+			.superclass = _Object(),
+			.instanceSize = sizeof(RenderTargetPool),
+			.interfaceOffset = offsetof(RenderTargetPool, interface),
+			.interfaceSize = sizeof(RenderTargetPoolInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
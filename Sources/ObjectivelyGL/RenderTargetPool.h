@@ -0,0 +1,227 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Vector.h>
+
+#include <ObjectivelyGL/Renderbuffer.h>
+#include <ObjectivelyGL/Texture.h>
+
+/**
+ * @file
+ * @brief RenderTargetPools recycle framebuffer attachments across passes and frames.
+ * @details Offscreen passes acquire their Texture and Renderbuffer attachments from a
+ * RenderTargetPool, and relinquish them when they are no longer needed. Attachments are keyed by
+ * their size, format and sample count, so that later passes, or the same passes in later frames,
+ * reuse them rather than allocating new ones. Attachments left idle for `maxIdleFrames` frames are
+ * released.
+ *
+ * RenderTargetPools are not thread safe, and must be used on the thread that owns the GL context.
+ */
+
+/**
+ * @brief The default count of frames after which idle attachments are released.
+ */
+#define RENDER_TARGET_POOL_MAX_IDLE_FRAMES 8
+
+/**
+ * @brief The descriptor of a pooled attachment.
+ */
+typedef struct {
+
+	/**
+	 * @brief The width and height.
+	 */
+	GLsizei width, height;
+
+	/**
+	 * @brief The sized internal format, e.g. `GL_RGBA16F` or `GL_DEPTH24_STENCIL8`.
+	 */
+	GLenum internalFormat;
+
+	/**
+	 * @brief The count of samples, or `0` for single sampled attachments.
+	 * @remarks Multisample attachments must be Renderbuffers.
+	 */
+	GLsizei samples;
+
+	/**
+	 * @brief The count of mipmap levels of Textures. Renderbuffers have exactly one.
+	 */
+	GLsizei levels;
+
+} RenderTargetDescriptor;
+
+#define MakeRenderTargetDescriptor(width, height, internalFormat, samples) \
+	(RenderTargetDescriptor) { (width), (height), (internalFormat), (samples), 1 }
+
+/**
+ * @brief RenderTargetPool statistics.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of attachments allocated.
+	 */
+	size_t allocations;
+
+	/**
+	 * @brief The count of acquisitions satisfied by a pooled attachment.
+	 */
+	size_t recycles;
+
+	/**
+	 * @brief The count of idle attachments released.
+	 */
+	size_t purges;
+
+	/**
+	 * @brief The count of attachments currently acquired.
+	 */
+	size_t acquired;
+
+	/**
+	 * @brief The estimated size of all pooled attachments, in bytes.
+	 */
+	GLsizeiptr bytes;
+
+} RenderTargetPoolStats;
+
+typedef struct RenderTargetPool RenderTargetPool;
+typedef struct RenderTargetPoolInterface RenderTargetPoolInterface;
+
+/**
+ * @brief The RenderTargetPool type.
+ * @extends Object
+ */
+struct RenderTargetPool {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	RenderTargetPoolInterface *interface;
+
+	/**
+	 * @brief The pooled attachments.
+	 * @private
+	 */
+	Vector *targets;
+
+	/**
+	 * @brief The current frame.
+	 */
+	uint64_t frame;
+
+	/**
+	 * @brief Attachments not acquired for this many frames are released.
+	 */
+	uint64_t maxIdleFrames;
+
+	/**
+	 * @brief The statistics.
+	 */
+	RenderTargetPoolStats stats;
+};
+
+/**
+ * @brief The RenderTargetPool interface.
+ */
+struct RenderTargetPoolInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn Renderbuffer *RenderTargetPool::acquireRenderbuffer(RenderTargetPool *self, const RenderTargetDescriptor *descriptor)
+	 * @brief Acquires a Renderbuffer matching the given descriptor.
+	 * @param self The RenderTargetPool.
+	 * @param descriptor The RenderTargetDescriptor.
+	 * @return The Renderbuffer, which remains owned by this RenderTargetPool.
+	 * @memberof RenderTargetPool
+	 */
+	Renderbuffer *(*acquireRenderbuffer)(RenderTargetPool *self, const RenderTargetDescriptor *descriptor);
+
+	/**
+	 * @fn Texture *RenderTargetPool::acquireTexture(RenderTargetPool *self, const RenderTargetDescriptor *descriptor)
+	 * @brief Acquires a 2D Texture matching the given descriptor.
+	 * @param self The RenderTargetPool.
+	 * @param descriptor The RenderTargetDescriptor, whose sample count must be `0`.
+	 * @return The Texture, which remains owned by this RenderTargetPool.
+	 * @remarks Textures are created with linear filtering and edge clamping, and their contents
+	 * are undefined when acquired.
+	 * @memberof RenderTargetPool
+	 */
+	Texture *(*acquireTexture)(RenderTargetPool *self, const RenderTargetDescriptor *descriptor);
+
+	/**
+	 * @fn RenderTargetPool *RenderTargetPool::init(RenderTargetPool *self)
+	 * @brief Initializes this RenderTargetPool.
+	 * @param self The RenderTargetPool.
+	 * @return The initialized RenderTargetPool, or `NULL` on error.
+	 * @memberof RenderTargetPool
+	 */
+	RenderTargetPool *(*init)(RenderTargetPool *self);
+
+	/**
+	 * @fn void RenderTargetPool::nextFrame(RenderTargetPool *self)
+	 * @brief Advances this RenderTargetPool to the next frame, releasing idle attachments.
+	 * @param self The RenderTargetPool.
+	 * @memberof RenderTargetPool
+	 */
+	void (*nextFrame)(RenderTargetPool *self);
+
+	/**
+	 * @fn void RenderTargetPool::purge(RenderTargetPool *self)
+	 * @brief Releases all attachments that are not acquired.
+	 * @param self The RenderTargetPool.
+	 * @memberof RenderTargetPool
+	 */
+	void (*purge)(RenderTargetPool *self);
+
+	/**
+	 * @fn void RenderTargetPool::relinquish(RenderTargetPool *self, const ident attachment)
+	 * @brief Returns an acquired Texture or Renderbuffer to this RenderTargetPool.
+	 * @param self The RenderTargetPool.
+	 * @param attachment The Texture or Renderbuffer.
+	 * @memberof RenderTargetPool
+	 */
+	void (*relinquish)(RenderTargetPool *self, const ident attachment);
+};
+
+/**
+ * @fn Class *RenderTargetPool::_RenderTargetPool(void)
+ * @brief The RenderTargetPool archetype.
+ * @return The RenderTargetPool Class.
+ * @memberof RenderTargetPool
+ */
+OBJECTIVELYGL_EXPORT Class *_RenderTargetPool(void);
@@ -0,0 +1,151 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+
+#include "Renderbuffer.h"
+
+#define _Class _Renderbuffer
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	Renderbuffer *this = (Renderbuffer *) self;
+
+	if (this->size) {
+		MemoryTracker *tracker = $$(MemoryTracker, sharedInstance);
+		$(tracker, deallocate, MemoryCategoryRenderbuffer, this->storage.internalFormat, this->size);
+	}
+
+	glDeleteRenderbuffers(1, &this->name);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - Renderbuffer
+
+/**
+ * @fn void Renderbuffer::bind(const Renderbuffer *self)
+ * @memberof Renderbuffer
+ */
+static void bind(const Renderbuffer *self) {
+	glBindRenderbuffer(GL_RENDERBUFFER, self->name);
+}
+
+/**
+ * @fn Renderbuffer *Renderbuffer::initWithStorage(Renderbuffer *self, const RenderbufferStorage *storage)
+ * @memberof Renderbuffer
+ */
+static Renderbuffer *initWithStorage(Renderbuffer *self, const RenderbufferStorage *storage) {
+
+	assert(storage->width > 0 && storage->height > 0 && storage->samples >= 0);
+
+	self = (Renderbuffer *) super(Object, self, init);
+	if (self) {
+
+		if (HasDirectStateAccess()) {
+			glCreateRenderbuffers(1, &self->name);
+		} else {
+			glGenRenderbuffers(1, &self->name);
+		}
+
+		if (self->name == 0) {
+			return release(self);
+		}
+
+		if (HasDirectStateAccess()) {
+			glNamedRenderbufferStorageMultisample(self->name,
+												  storage->samples,
+												  storage->internalFormat,
+												  storage->width,
+												  storage->height);
+		} else {
+			$(self, bind);
+			glRenderbufferStorageMultisample(GL_RENDERBUFFER,
+											 storage->samples,
+											 storage->internalFormat,
+											 storage->width,
+											 storage->height);
+		}
+
+		self->storage = *storage;
+		self->size = $$(MemoryTracker, bytesForInternalFormat, storage->internalFormat)
+			* storage->width * storage->height * max(storage->samples, 1);
+
+		MemoryTracker *tracker = $$(MemoryTracker, sharedInstance);
+		$(tracker, allocate, MemoryCategoryRenderbuffer, storage->internalFormat, self->size);
+	}
+
+	return self;
+}
+
+/**
+ * @fn void Renderbuffer::unbind(const Renderbuffer *self)
+ * @memberof Renderbuffer
+ */
+static void unbind(const Renderbuffer *self) {
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((RenderbufferInterface *) clazz->interface)->bind = bind;
+	((RenderbufferInterface *) clazz->interface)->initWithStorage = initWithStorage;
+	((RenderbufferInterface *) clazz->interface)->unbind = unbind;
+}
+
+/**
+ * @fn Class *Renderbuffer::_Renderbuffer(void)
+ * @memberof Renderbuffer
+ */
+Class *_Renderbuffer(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "Renderbuffer",
+			.superclass = _Object(),
+			.instanceSize = sizeof(Renderbuffer),
+			.interfaceOffset = offsetof(Renderbuffer, interface),
+			.interfaceSize = sizeof(RenderbufferInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
@@ -0,0 +1,145 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Object.h>
+
+#include <ObjectivelyGL/MemoryTracker.h>
+#include <ObjectivelyGL/Types.h>
+
+/**
+ * @file
+ * @brief Renderbuffers are framebuffer attachments that are never sampled.
+ * @details Renderbuffers are well suited to depth and stencil attachments that are only tested
+ * against, and to multisample color attachments that are resolved with `glBlitFramebuffer`.
+ */
+
+typedef struct Renderbuffer Renderbuffer;
+typedef struct RenderbufferInterface RenderbufferInterface;
+
+/**
+ * @brief RenderbufferStorage is used to allocate storage for a Renderbuffer.
+ * @see glRenderbufferStorageMultisample
+ */
+typedef struct RenderbufferStorage {
+
+	/**
+	 * @brief The sized internal format, e.g. `GL_DEPTH24_STENCIL8`.
+	 */
+	GLenum internalFormat;
+
+	/**
+	 * @brief The width and height.
+	 */
+	GLsizei width, height;
+
+	/**
+	 * @brief The count of samples, or `0` for a single sampled Renderbuffer.
+	 */
+	GLsizei samples;
+} RenderbufferStorage;
+
+#define MakeRenderbufferStorage(internalFormat, width, height, samples) \
+	(RenderbufferStorage) { (internalFormat), (width), (height), (samples) }
+
+/**
+ * @brief The Renderbuffer type.
+ * @extends Object
+ */
+struct Renderbuffer {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	RenderbufferInterface *interface;
+
+	/**
+	 * @brief The name.
+	 */
+	GLuint name;
+
+	/**
+	 * @brief The RenderbufferStorage.
+	 */
+	RenderbufferStorage storage;
+
+	/**
+	 * @brief The estimated size, in bytes.
+	 */
+	GLsizeiptr size;
+};
+
+/**
+ * @brief The Renderbuffer interface.
+ */
+struct RenderbufferInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn void Renderbuffer::bind(const Renderbuffer *self)
+	 * @brief Binds this Renderbuffer to `GL_RENDERBUFFER`.
+	 * @param self The Renderbuffer.
+	 * @memberof Renderbuffer
+	 */
+	void (*bind)(const Renderbuffer *self);
+
+	/**
+	 * @fn Renderbuffer *Renderbuffer::initWithStorage(Renderbuffer *self, const RenderbufferStorage *storage)
+	 * @brief Initializes this Renderbuffer with the specified storage.
+	 * @param self The Renderbuffer.
+	 * @param storage The RenderbufferStorage.
+	 * @return The initialized Renderbuffer, or `NULL` on error.
+	 * @remarks Where Direct State Access is available, the Renderbuffer is created without binding
+	 * it. Otherwise, it is left bound to `GL_RENDERBUFFER`.
+	 * @memberof Renderbuffer
+	 */
+	Renderbuffer *(*initWithStorage)(Renderbuffer *self, const RenderbufferStorage *storage);
+
+	/**
+	 * @fn void Renderbuffer::unbind(const Renderbuffer *self)
+	 * @brief Unbinds this Renderbuffer from `GL_RENDERBUFFER`.
+	 * @param self The Renderbuffer.
+	 * @memberof Renderbuffer
+	 */
+	void (*unbind)(const Renderbuffer *self);
+};
+
+/**
+ * @fn Class *Renderbuffer::_Renderbuffer(void)
+ * @brief The Renderbuffer archetype.
+ * @return The Renderbuffer Class.
+ * @memberof Renderbuffer
+ */
+OBJECTIVELYGL_EXPORT Class *_Renderbuffer(void);
@@ -0,0 +1,732 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "StateCache.h"
+
+#define _Class _StateCache
+
+/**
+ * @brief The binding value of state that is not known to the StateCache.
+ */
+#define UNKNOWN ((GLuint) -1)
+
+/**
+ * @brief The Buffer targets shadowed by StateCaches.
+ */
+static const GLenum _bufferTargets[] = {
+	GL_ARRAY_BUFFER,
+	GL_ATOMIC_COUNTER_BUFFER,
+	GL_COPY_READ_BUFFER,
+	GL_COPY_WRITE_BUFFER,
+	GL_DISPATCH_INDIRECT_BUFFER,
+	GL_DRAW_INDIRECT_BUFFER,
+	GL_ELEMENT_ARRAY_BUFFER,
+	GL_PIXEL_PACK_BUFFER,
+	GL_PIXEL_UNPACK_BUFFER,
+	GL_QUERY_BUFFER,
+	GL_SHADER_STORAGE_BUFFER,
+	GL_TEXTURE_BUFFER,
+	GL_TRANSFORM_FEEDBACK_BUFFER,
+	GL_UNIFORM_BUFFER,
+};
+
+#define NUM_BUFFER_TARGETS (sizeof(_bufferTargets) / sizeof(_bufferTargets[0]))
+
+/**
+ * @brief The Texture targets shadowed by StateCaches.
+ */
+static const GLenum _textureTargets[] = {
+	GL_TEXTURE_1D,
+	GL_TEXTURE_1D_ARRAY,
+	GL_TEXTURE_2D,
+	GL_TEXTURE_2D_ARRAY,
+	GL_TEXTURE_2D_MULTISAMPLE,
+	GL_TEXTURE_2D_MULTISAMPLE_ARRAY,
+	GL_TEXTURE_3D,
+	GL_TEXTURE_BUFFER,
+	GL_TEXTURE_CUBE_MAP,
+	GL_TEXTURE_CUBE_MAP_ARRAY,
+	GL_TEXTURE_RECTANGLE,
+};
+
+#define NUM_TEXTURE_TARGETS (sizeof(_textureTargets) / sizeof(_textureTargets[0]))
+
+/**
+ * @brief The capabilities shadowed by StateCaches.
+ */
+static const GLenum _capabilities[] = {
+	GL_BLEND,
+	GL_CULL_FACE,
+	GL_DEPTH_CLAMP,
+	GL_DEPTH_TEST,
+	GL_DITHER,
+	GL_FRAMEBUFFER_SRGB,
+	GL_LINE_SMOOTH,
+	GL_MULTISAMPLE,
+	GL_POLYGON_OFFSET_FILL,
+	GL_POLYGON_OFFSET_LINE,
+	GL_POLYGON_OFFSET_POINT,
+	GL_PRIMITIVE_RESTART,
+	GL_PROGRAM_POINT_SIZE,
+	GL_RASTERIZER_DISCARD,
+	GL_SAMPLE_ALPHA_TO_COVERAGE,
+	GL_SCISSOR_TEST,
+	GL_STENCIL_TEST,
+	GL_TEXTURE_CUBE_MAP_SEAMLESS,
+};
+
+#define NUM_CAPABILITIES (sizeof(_capabilities) / sizeof(_capabilities[0]))
+
+/**
+ * @brief An indexed Buffer binding.
+ */
+typedef struct {
+
+	/**
+	 * @brief The Buffer name.
+	 */
+	GLuint name;
+
+	/**
+	 * @brief The offset of the bound range, in bytes.
+	 */
+	GLintptr offset;
+
+	/**
+	 * @brief The size of the bound range, in bytes, or `0` for the whole Buffer.
+	 */
+	GLsizeiptr size;
+
+} IndexedBinding;
+
+/**
+ * @brief The state shadowed by a StateCache.
+ */
+typedef struct {
+
+	/**
+	 * @brief The program name.
+	 */
+	GLuint program;
+
+	/**
+	 * @brief The VertexArray name.
+	 */
+	GLuint vertexArray;
+
+	/**
+	 * @brief The Buffer names, by target.
+	 */
+	GLuint buffers[NUM_BUFFER_TARGETS];
+
+	/**
+	 * @brief The indexed uniform Buffer bindings.
+	 */
+	IndexedBinding uniformBuffers[STATE_CACHE_MAX_UNIFORM_BUFFERS];
+
+	/**
+	 * @brief The active texture unit, relative to `GL_TEXTURE0`.
+	 */
+	GLuint activeTexture;
+
+	/**
+	 * @brief The Texture names, by unit and target.
+	 */
+	GLuint textures[STATE_CACHE_MAX_TEXTURE_UNITS][NUM_TEXTURE_TARGETS];
+
+	/**
+	 * @brief The capabilities, `1` if enabled, `0` if disabled, or `-1` if unknown.
+	 */
+	GLbyte capabilities[NUM_CAPABILITIES];
+
+} State;
+
+/**
+ * @brief The StateCache current on this thread.
+ */
+static __thread StateCache *_current;
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	StateCache *this = (StateCache *) self;
+
+	if (_current == this) {
+		_current = NULL;
+	}
+
+	free(this->state);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - StateCache
+
+/**
+ * @return The index of `value` in `values`, or `-1`.
+ */
+static ssize_t _indexOf(const GLenum *values, size_t count, GLenum value) {
+
+	for (size_t i = 0; i < count; i++) {
+		if (values[i] == value) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Updates the shadowed binding `*binding` to `name`.
+ * @return True if the call must be issued to OpenGL, false if it may be elided.
+ */
+static _Bool _update(StateCache *self, GLuint *binding, GLuint name) {
+
+	if (binding && *binding == name) {
+		self->stats.elided++;
+		return false;
+	}
+
+	if (binding) {
+		*binding = name;
+	}
+
+	self->stats.calls++;
+	return true;
+}
+
+/**
+ * @fn void StateCache::activeTexture(StateCache *self, GLenum unit)
+ * @memberof StateCache
+ */
+static void activeTexture(StateCache *self, GLenum unit) {
+
+	State *state = self->state;
+
+	if (_update(self, &state->activeTexture, unit - GL_TEXTURE0)) {
+		glActiveTexture(unit);
+	}
+}
+
+/**
+ * @fn void StateCache::bindBuffer(StateCache *self, GLenum target, GLuint name)
+ * @memberof StateCache
+ */
+static void bindBuffer(StateCache *self, GLenum target, GLuint name) {
+
+	State *state = self->state;
+
+	const ssize_t i = _indexOf(_bufferTargets, NUM_BUFFER_TARGETS, target);
+	if (_update(self, i == -1 ? NULL : &state->buffers[i], name)) {
+		glBindBuffer(target, name);
+	}
+}
+
+/**
+ * @fn void StateCache::bindBufferRange(StateCache *self, GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size)
+ * @memberof StateCache
+ */
+static void bindBufferRange(StateCache *self, GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size) {
+
+	State *state = self->state;
+
+	if (target == GL_UNIFORM_BUFFER && index < STATE_CACHE_MAX_UNIFORM_BUFFERS) {
+		IndexedBinding *binding = &state->uniformBuffers[index];
+		if (binding->name == name && binding->offset == offset && binding->size == size) {
+			self->stats.elided++;
+			return;
+		}
+
+		*binding = (IndexedBinding) {
+			.name = name,
+			.offset = offset,
+			.size = size
+		};
+	}
+
+	const ssize_t i = _indexOf(_bufferTargets, NUM_BUFFER_TARGETS, target);
+	if (i != -1) {
+		state->buffers[i] = name;
+	}
+
+	self->stats.calls++;
+
+	if (size) {
+		glBindBufferRange(target, index, name, offset, size);
+	} else {
+		glBindBufferBase(target, index, name);
+	}
+}
+
+/**
+ * @fn void StateCache::bindTexture(StateCache *self, GLenum target, GLuint name)
+ * @memberof StateCache
+ */
+static void bindTexture(StateCache *self, GLenum target, GLuint name) {
+
+	State *state = self->state;
+
+	GLuint *binding = NULL;
+
+	const ssize_t i = _indexOf(_textureTargets, NUM_TEXTURE_TARGETS, target);
+	if (i != -1 && state->activeTexture < STATE_CACHE_MAX_TEXTURE_UNITS) {
+		binding = &state->textures[state->activeTexture][i];
+	}
+
+	if (_update(self, binding, name)) {
+		glBindTexture(target, name);
+	}
+}
+
+/**
+ * @fn void StateCache::bindVertexArray(StateCache *self, GLuint name)
+ * @memberof StateCache
+ */
+static void bindVertexArray(StateCache *self, GLuint name) {
+
+	State *state = self->state;
+
+	if (_update(self, &state->vertexArray, name)) {
+		glBindVertexArray(name);
+
+		const ssize_t i = _indexOf(_bufferTargets, NUM_BUFFER_TARGETS, GL_ELEMENT_ARRAY_BUFFER);
+		state->buffers[i] = UNKNOWN;
+	}
+}
+
+/**
+ * @fn void StateCache::currentActiveTexture(GLenum unit)
+ * @memberof StateCache
+ */
+static void currentActiveTexture(GLenum unit) {
+
+	if (_current) {
+		$(_current, activeTexture, unit);
+	} else {
+		glActiveTexture(unit);
+	}
+}
+
+/**
+ * @fn void StateCache::currentBindBuffer(GLenum target, GLuint name)
+ * @memberof StateCache
+ */
+static void currentBindBuffer(GLenum target, GLuint name) {
+
+	if (_current) {
+		$(_current, bindBuffer, target, name);
+	} else {
+		glBindBuffer(target, name);
+	}
+}
+
+/**
+ * @fn void StateCache::currentBindBufferRange(GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size)
+ * @memberof StateCache
+ */
+static void currentBindBufferRange(GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size) {
+
+	if (_current) {
+		$(_current, bindBufferRange, target, index, name, offset, size);
+	} else if (size) {
+		glBindBufferRange(target, index, name, offset, size);
+	} else {
+		glBindBufferBase(target, index, name);
+	}
+}
+
+/**
+ * @fn void StateCache::currentBindTexture(GLenum target, GLuint name)
+ * @memberof StateCache
+ */
+static void currentBindTexture(GLenum target, GLuint name) {
+
+	if (_current) {
+		$(_current, bindTexture, target, name);
+	} else {
+		glBindTexture(target, name);
+	}
+}
+
+/**
+ * @fn void StateCache::currentBindVertexArray(GLuint name)
+ * @memberof StateCache
+ */
+static void currentBindVertexArray(GLuint name) {
+
+	if (_current) {
+		$(_current, bindVertexArray, name);
+	} else {
+		glBindVertexArray(name);
+	}
+}
+
+/**
+ * @fn StateCache *StateCache::currentCache(void)
+ * @memberof StateCache
+ */
+static StateCache *currentCache(void) {
+	return _current;
+}
+
+/**
+ * @fn void StateCache::currentDeleteBuffers(GLsizei count, const GLuint *names)
+ * @memberof StateCache
+ */
+static void currentDeleteBuffers(GLsizei count, const GLuint *names) {
+
+	if (_current) {
+		for (GLsizei i = 0; i < count; i++) {
+			$(_current, deleteBuffer, names[i]);
+		}
+	}
+
+	glDeleteBuffers(count, names);
+}
+
+/**
+ * @fn void StateCache::currentDeleteProgram(GLuint name)
+ * @memberof StateCache
+ */
+static void currentDeleteProgram(GLuint name) {
+
+	if (_current) {
+		$(_current, deleteProgram, name);
+	}
+
+	glDeleteProgram(name);
+}
+
+/**
+ * @fn void StateCache::currentDeleteTextures(GLsizei count, const GLuint *names)
+ * @memberof StateCache
+ */
+static void currentDeleteTextures(GLsizei count, const GLuint *names) {
+
+	if (_current) {
+		for (GLsizei i = 0; i < count; i++) {
+			$(_current, deleteTexture, names[i]);
+		}
+	}
+
+	glDeleteTextures(count, names);
+}
+
+/**
+ * @fn void StateCache::currentDeleteVertexArrays(GLsizei count, const GLuint *names)
+ * @memberof StateCache
+ */
+static void currentDeleteVertexArrays(GLsizei count, const GLuint *names) {
+
+	if (_current) {
+		for (GLsizei i = 0; i < count; i++) {
+			$(_current, deleteVertexArray, names[i]);
+		}
+	}
+
+	glDeleteVertexArrays(count, names);
+}
+
+/**
+ * @fn void StateCache::currentSetEnabled(GLenum capability, _Bool enabled)
+ * @memberof StateCache
+ */
+static void currentSetEnabled(GLenum capability, _Bool enabled) {
+
+	if (_current) {
+		if (enabled) {
+			$(_current, enable, capability);
+		} else {
+			$(_current, disable, capability);
+		}
+	} else if (enabled) {
+		glEnable(capability);
+	} else {
+		glDisable(capability);
+	}
+}
+
+/**
+ * @fn void StateCache::currentUseProgram(GLuint name)
+ * @memberof StateCache
+ */
+static void currentUseProgram(GLuint name) {
+
+	if (_current) {
+		$(_current, useProgram, name);
+	} else {
+		glUseProgram(name);
+	}
+}
+
+/**
+ * @fn void StateCache::deleteBuffer(StateCache *self, GLuint name)
+ * @memberof StateCache
+ */
+static void deleteBuffer(StateCache *self, GLuint name) {
+
+	State *state = self->state;
+
+	for (size_t i = 0; i < NUM_BUFFER_TARGETS; i++) {
+		if (state->buffers[i] == name) {
+			state->buffers[i] = 0;
+		}
+	}
+
+	for (size_t i = 0; i < STATE_CACHE_MAX_UNIFORM_BUFFERS; i++) {
+		if (state->uniformBuffers[i].name == name) {
+			state->uniformBuffers[i] = (IndexedBinding) { .name = UNKNOWN };
+		}
+	}
+}
+
+/**
+ * @fn void StateCache::deleteProgram(StateCache *self, GLuint name)
+ * @memberof StateCache
+ */
+static void deleteProgram(StateCache *self, GLuint name) {
+
+	State *state = self->state;
+
+	if (state->program == name) {
+		state->program = UNKNOWN;
+	}
+}
+
+/**
+ * @fn void StateCache::deleteTexture(StateCache *self, GLuint name)
+ * @memberof StateCache
+ */
+static void deleteTexture(StateCache *self, GLuint name) {
+
+	State *state = self->state;
+
+	for (size_t i = 0; i < STATE_CACHE_MAX_TEXTURE_UNITS; i++) {
+		for (size_t j = 0; j < NUM_TEXTURE_TARGETS; j++) {
+			if (state->textures[i][j] == name) {
+				state->textures[i][j] = 0;
+			}
+		}
+	}
+}
+
+/**
+ * @fn void StateCache::deleteVertexArray(StateCache *self, GLuint name)
+ * @memberof StateCache
+ */
+static void deleteVertexArray(StateCache *self, GLuint name) {
+
+	State *state = self->state;
+
+	if (state->vertexArray == name) {
+		state->vertexArray = 0;
+
+		const ssize_t i = _indexOf(_bufferTargets, NUM_BUFFER_TARGETS, GL_ELEMENT_ARRAY_BUFFER);
+		state->buffers[i] = UNKNOWN;
+	}
+}
+
+/**
+ * @brief Sets the shadowed capability to `enabled`.
+ * @return True if the call must be issued to OpenGL, false if it may be elided.
+ */
+static _Bool _capability(StateCache *self, GLenum capability, GLbyte enabled) {
+
+	State *state = self->state;
+
+	const ssize_t i = _indexOf(_capabilities, NUM_CAPABILITIES, capability);
+	if (i != -1) {
+		if (state->capabilities[i] == enabled) {
+			self->stats.elided++;
+			return false;
+		}
+
+		state->capabilities[i] = enabled;
+	}
+
+	self->stats.calls++;
+	return true;
+}
+
+/**
+ * @fn void StateCache::disable(StateCache *self, GLenum capability)
+ * @memberof StateCache
+ */
+static void disable(StateCache *self, GLenum capability) {
+
+	if (_capability(self, capability, 0)) {
+		glDisable(capability);
+	}
+}
+
+/**
+ * @fn void StateCache::enable(StateCache *self, GLenum capability)
+ * @memberof StateCache
+ */
+static void enable(StateCache *self, GLenum capability) {
+
+	if (_capability(self, capability, 1)) {
+		glEnable(capability);
+	}
+}
+
+/**
+ * @fn StateCache *StateCache::init(StateCache *self)
+ * @memberof StateCache
+ */
+static StateCache *init(StateCache *self) {
+
+	self = (StateCache *) super(Object, self, init);
+	if (self) {
+
+		self->state = calloc(1, sizeof(State));
+		assert(self->state);
+
+		$(self, invalidate);
+	}
+
+	return self;
+}
+
+/**
+ * @fn void StateCache::invalidate(StateCache *self)
+ * @memberof StateCache
+ */
+static void invalidate(StateCache *self) {
+
+	State *state = self->state;
+
+	state->program = UNKNOWN;
+	state->vertexArray = UNKNOWN;
+
+	for (size_t i = 0; i < NUM_BUFFER_TARGETS; i++) {
+		state->buffers[i] = UNKNOWN;
+	}
+
+	for (size_t i = 0; i < STATE_CACHE_MAX_UNIFORM_BUFFERS; i++) {
+		state->uniformBuffers[i] = (IndexedBinding) { .name = UNKNOWN };
+	}
+
+	state->activeTexture = UNKNOWN;
+
+	for (size_t i = 0; i < STATE_CACHE_MAX_TEXTURE_UNITS; i++) {
+		for (size_t j = 0; j < NUM_TEXTURE_TARGETS; j++) {
+			state->textures[i][j] = UNKNOWN;
+		}
+	}
+
+	for (size_t i = 0; i < NUM_CAPABILITIES; i++) {
+		state->capabilities[i] = -1;
+	}
+}
+
+/**
+ * @fn void StateCache::makeCurrent(StateCache *self)
+ * @memberof StateCache
+ */
+static void makeCurrent(StateCache *self) {
+	_current = self;
+}
+
+/**
+ * @fn void StateCache::useProgram(StateCache *self, GLuint name)
+ * @memberof StateCache
+ */
+static void useProgram(StateCache *self, GLuint name) {
+
+	State *state = self->state;
+
+	if (_update(self, &state->program, name)) {
+		glUseProgram(name);
+	}
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((StateCacheInterface *) clazz->interface)->activeTexture = activeTexture;
+	((StateCacheInterface *) clazz->interface)->bindBuffer = bindBuffer;
+	((StateCacheInterface *) clazz->interface)->bindBufferRange = bindBufferRange;
+	((StateCacheInterface *) clazz->interface)->bindTexture = bindTexture;
+	((StateCacheInterface *) clazz->interface)->bindVertexArray = bindVertexArray;
+	((StateCacheInterface *) clazz->interface)->currentActiveTexture = currentActiveTexture;
+	((StateCacheInterface *) clazz->interface)->currentBindBuffer = currentBindBuffer;
+	((StateCacheInterface *) clazz->interface)->currentBindBufferRange = currentBindBufferRange;
+	((StateCacheInterface *) clazz->interface)->currentBindTexture = currentBindTexture;
+	((StateCacheInterface *) clazz->interface)->currentBindVertexArray = currentBindVertexArray;
+	((StateCacheInterface *) clazz->interface)->currentCache = currentCache;
+	((StateCacheInterface *) clazz->interface)->currentDeleteBuffers = currentDeleteBuffers;
+	((StateCacheInterface *) clazz->interface)->currentDeleteProgram = currentDeleteProgram;
+	((StateCacheInterface *) clazz->interface)->currentDeleteTextures = currentDeleteTextures;
+	((StateCacheInterface *) clazz->interface)->currentDeleteVertexArrays = currentDeleteVertexArrays;
+	((StateCacheInterface *) clazz->interface)->currentSetEnabled = currentSetEnabled;
+	((StateCacheInterface *) clazz->interface)->currentUseProgram = currentUseProgram;
+	((StateCacheInterface *) clazz->interface)->deleteBuffer = deleteBuffer;
+	((StateCacheInterface *) clazz->interface)->deleteProgram = deleteProgram;
+	((StateCacheInterface *) clazz->interface)->deleteTexture = deleteTexture;
+	((StateCacheInterface *) clazz->interface)->deleteVertexArray = deleteVertexArray;
+	((StateCacheInterface *) clazz->interface)->disable = disable;
+	((StateCacheInterface *) clazz->interface)->enable = enable;
+	((StateCacheInterface *) clazz->interface)->init = init;
+	((StateCacheInterface *) clazz->interface)->invalidate = invalidate;
+	((StateCacheInterface *) clazz->interface)->makeCurrent = makeCurrent;
+	((StateCacheInterface *) clazz->interface)->useProgram = useProgram;
+}
+
+/**
+ * @fn Class *StateCache::_StateCache(void)
+ * @memberof StateCache
+ */
+Class *_StateCache(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "StateCache",
+			.superclass = _Object(),
+			.instanceSize = sizeof(StateCache),
+			.interfaceOffset = offsetof(StateCache, interface),
+			.interfaceSize = sizeof(StateCacheInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
@@ -0,0 +1,366 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Object.h>
+
+#include <ObjectivelyGL/Types.h>
+
+/**
+ * @file
+ * @brief StateCaches elide redundant OpenGL binds and enables.
+ * @details A StateCache shadows the program, VertexArray, Buffer and Texture bindings, and the
+ * capabilities, of a single GL context. Calls that would not change the shadowed state are skipped,
+ * and counted as elided.
+ *
+ * A StateCache is made current on the thread that owns its GL context with _makeCurrent_. The
+ * class methods prefixed `current`, through which Buffer, Texture, VertexArray and Program bind,
+ * then go through it, and otherwise call OpenGL directly. Code that changes the same state by
+ * calling OpenGL directly must _invalidate_ the StateCache afterwards.
+ */
+
+/**
+ * @brief The maximum count of texture units shadowed by a StateCache.
+ */
+#define STATE_CACHE_MAX_TEXTURE_UNITS 32
+
+/**
+ * @brief The maximum count of indexed uniform Buffer bindings shadowed by a StateCache.
+ */
+#define STATE_CACHE_MAX_UNIFORM_BUFFERS 32
+
+/**
+ * @brief StateCache statistics.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of calls issued to OpenGL.
+	 */
+	size_t calls;
+
+	/**
+	 * @brief The count of redundant calls elided.
+	 */
+	size_t elided;
+
+} StateCacheStats;
+
+typedef struct StateCache StateCache;
+typedef struct StateCacheInterface StateCacheInterface;
+
+/**
+ * @brief The StateCache type.
+ * @extends Object
+ */
+struct StateCache {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	StateCacheInterface *interface;
+
+	/**
+	 * @brief The shadowed state.
+	 * @private
+	 */
+	ident state;
+
+	/**
+	 * @brief The statistics.
+	 */
+	StateCacheStats stats;
+};
+
+/**
+ * @brief The StateCache interface.
+ */
+struct StateCacheInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn void StateCache::activeTexture(StateCache *self, GLenum unit)
+	 * @brief Selects the active texture unit.
+	 * @param self The StateCache.
+	 * @param unit The texture unit, e.g. `GL_TEXTURE0`.
+	 * @memberof StateCache
+	 */
+	void (*activeTexture)(StateCache *self, GLenum unit);
+
+	/**
+	 * @fn void StateCache::bindBuffer(StateCache *self, GLenum target, GLuint name)
+	 * @brief Binds the named Buffer to the given target.
+	 * @param self The StateCache.
+	 * @param target The target.
+	 * @param name The Buffer name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*bindBuffer)(StateCache *self, GLenum target, GLuint name);
+
+	/**
+	 * @fn void StateCache::bindBufferRange(StateCache *self, GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size)
+	 * @brief Binds a range of the named Buffer to the given indexed target.
+	 * @param self The StateCache.
+	 * @param target The target, e.g. `GL_UNIFORM_BUFFER`.
+	 * @param index The binding index.
+	 * @param name The Buffer name.
+	 * @param offset The offset of the range, in bytes.
+	 * @param size The size of the range, in bytes, or `0` to bind the whole Buffer.
+	 * @remarks The generic binding of `target` is also changed to `name`.
+	 * @memberof StateCache
+	 */
+	void (*bindBufferRange)(StateCache *self, GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size);
+
+	/**
+	 * @fn void StateCache::bindTexture(StateCache *self, GLenum target, GLuint name)
+	 * @brief Binds the named Texture to the given target of the active texture unit.
+	 * @param self The StateCache.
+	 * @param target The target.
+	 * @param name The Texture name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*bindTexture)(StateCache *self, GLenum target, GLuint name);
+
+	/**
+	 * @fn void StateCache::bindVertexArray(StateCache *self, GLuint name)
+	 * @brief Binds the named VertexArray.
+	 * @param self The StateCache.
+	 * @param name The VertexArray name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*bindVertexArray)(StateCache *self, GLuint name);
+
+	/**
+	 * @fn void StateCache::currentActiveTexture(GLenum unit)
+	 * @brief Selects the active texture unit through the current StateCache, or OpenGL.
+	 * @param unit The texture unit, e.g. `GL_TEXTURE0`.
+	 * @memberof StateCache
+	 */
+	void (*currentActiveTexture)(GLenum unit);
+
+	/**
+	 * @fn void StateCache::currentBindBuffer(GLenum target, GLuint name)
+	 * @brief Binds the named Buffer through the current StateCache, or OpenGL.
+	 * @param target The target.
+	 * @param name The Buffer name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*currentBindBuffer)(GLenum target, GLuint name);
+
+	/**
+	 * @fn void StateCache::currentBindBufferRange(GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size)
+	 * @brief Binds a range of the named Buffer through the current StateCache, or OpenGL.
+	 * @param target The target, e.g. `GL_UNIFORM_BUFFER`.
+	 * @param index The binding index.
+	 * @param name The Buffer name.
+	 * @param offset The offset of the range, in bytes.
+	 * @param size The size of the range, in bytes, or `0` to bind the whole Buffer.
+	 * @memberof StateCache
+	 */
+	void (*currentBindBufferRange)(GLenum target, GLuint index, GLuint name, GLintptr offset, GLsizeiptr size);
+
+	/**
+	 * @fn void StateCache::currentBindTexture(GLenum target, GLuint name)
+	 * @brief Binds the named Texture through the current StateCache, or OpenGL.
+	 * @param target The target.
+	 * @param name The Texture name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*currentBindTexture)(GLenum target, GLuint name);
+
+	/**
+	 * @fn void StateCache::currentBindVertexArray(GLuint name)
+	 * @brief Binds the named VertexArray through the current StateCache, or OpenGL.
+	 * @param name The VertexArray name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*currentBindVertexArray)(GLuint name);
+
+	/**
+	 * @fn StateCache *StateCache::currentCache(void)
+	 * @return The StateCache current on the calling thread, or `NULL`.
+	 * @memberof StateCache
+	 */
+	StateCache *(*currentCache)(void);
+
+	/**
+	 * @fn void StateCache::currentDeleteBuffers(GLsizei count, const GLuint *names)
+	 * @brief Deletes the named Buffers, resetting their bindings in the current StateCache.
+	 * @param count The count of names.
+	 * @param names The Buffer names.
+	 * @memberof StateCache
+	 */
+	void (*currentDeleteBuffers)(GLsizei count, const GLuint *names);
+
+	/**
+	 * @fn void StateCache::currentDeleteProgram(GLuint name)
+	 * @brief Deletes the named program, resetting its binding in the current StateCache.
+	 * @param name The program name.
+	 * @memberof StateCache
+	 */
+	void (*currentDeleteProgram)(GLuint name);
+
+	/**
+	 * @fn void StateCache::currentDeleteTextures(GLsizei count, const GLuint *names)
+	 * @brief Deletes the named Textures, resetting their bindings in the current StateCache.
+	 * @param count The count of names.
+	 * @param names The Texture names.
+	 * @memberof StateCache
+	 */
+	void (*currentDeleteTextures)(GLsizei count, const GLuint *names);
+
+	/**
+	 * @fn void StateCache::currentDeleteVertexArrays(GLsizei count, const GLuint *names)
+	 * @brief Deletes the named VertexArrays, resetting their bindings in the current StateCache.
+	 * @param count The count of names.
+	 * @param names The VertexArray names.
+	 * @memberof StateCache
+	 */
+	void (*currentDeleteVertexArrays)(GLsizei count, const GLuint *names);
+
+	/**
+	 * @fn void StateCache::currentSetEnabled(GLenum capability, _Bool enabled)
+	 * @brief Enables or disables the given capability through the current StateCache, or OpenGL.
+	 * @param capability The capability, e.g. `GL_BLEND`.
+	 * @param enabled True to enable the capability, false to disable it.
+	 * @memberof StateCache
+	 */
+	void (*currentSetEnabled)(GLenum capability, _Bool enabled);
+
+	/**
+	 * @fn void StateCache::currentUseProgram(GLuint name)
+	 * @brief Uses the named program through the current StateCache, or OpenGL.
+	 * @param name The program name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*currentUseProgram)(GLuint name);
+
+	/**
+	 * @fn void StateCache::deleteBuffer(StateCache *self, GLuint name)
+	 * @brief Resets the shadowed bindings of the named Buffer, which is being deleted.
+	 * @param self The StateCache.
+	 * @param name The Buffer name.
+	 * @memberof StateCache
+	 */
+	void (*deleteBuffer)(StateCache *self, GLuint name);
+
+	/**
+	 * @fn void StateCache::deleteProgram(StateCache *self, GLuint name)
+	 * @brief Resets the shadowed bindings of the named program, which is being deleted.
+	 * @param self The StateCache.
+	 * @param name The program name.
+	 * @memberof StateCache
+	 */
+	void (*deleteProgram)(StateCache *self, GLuint name);
+
+	/**
+	 * @fn void StateCache::deleteTexture(StateCache *self, GLuint name)
+	 * @brief Resets the shadowed bindings of the named Texture, which is being deleted.
+	 * @param self The StateCache.
+	 * @param name The Texture name.
+	 * @memberof StateCache
+	 */
+	void (*deleteTexture)(StateCache *self, GLuint name);
+
+	/**
+	 * @fn void StateCache::deleteVertexArray(StateCache *self, GLuint name)
+	 * @brief Resets the shadowed bindings of the named VertexArray, which is being deleted.
+	 * @param self The StateCache.
+	 * @param name The VertexArray name.
+	 * @memberof StateCache
+	 */
+	void (*deleteVertexArray)(StateCache *self, GLuint name);
+
+	/**
+	 * @fn void StateCache::disable(StateCache *self, GLenum capability)
+	 * @brief Disables the given capability.
+	 * @param self The StateCache.
+	 * @param capability The capability, e.g. `GL_BLEND`.
+	 * @memberof StateCache
+	 */
+	void (*disable)(StateCache *self, GLenum capability);
+
+	/**
+	 * @fn void StateCache::enable(StateCache *self, GLenum capability)
+	 * @brief Enables the given capability.
+	 * @param self The StateCache.
+	 * @param capability The capability, e.g. `GL_BLEND`.
+	 * @memberof StateCache
+	 */
+	void (*enable)(StateCache *self, GLenum capability);
+
+	/**
+	 * @fn StateCache *StateCache::init(StateCache *self)
+	 * @brief Initializes this StateCache, with all state unknown.
+	 * @param self The StateCache.
+	 * @return The initialized StateCache, or `NULL` on error.
+	 * @memberof StateCache
+	 */
+	StateCache *(*init)(StateCache *self);
+
+	/**
+	 * @fn void StateCache::invalidate(StateCache *self)
+	 * @brief Forgets all shadowed state, so that the next call of each kind is issued.
+	 * @param self The StateCache.
+	 * @memberof StateCache
+	 */
+	void (*invalidate)(StateCache *self);
+
+	/**
+	 * @fn void StateCache::makeCurrent(StateCache *self)
+	 * @brief Makes this StateCache current on the calling thread.
+	 * @param self The StateCache, or `NULL` to bind directly through OpenGL.
+	 * @remarks The current StateCache is not retained.
+	 * @memberof StateCache
+	 */
+	void (*makeCurrent)(StateCache *self);
+
+	/**
+	 * @fn void StateCache::useProgram(StateCache *self, GLuint name)
+	 * @brief Uses the named program.
+	 * @param self The StateCache.
+	 * @param name The program name, or `0`.
+	 * @memberof StateCache
+	 */
+	void (*useProgram)(StateCache *self, GLuint name);
+};
+
+/**
+ * @fn Class *StateCache::_StateCache(void)
+ * @brief The StateCache archetype.
+ * @return The StateCache Class.
+ * @memberof StateCache
+ */
+OBJECTIVELYGL_EXPORT Class *_StateCache(void);
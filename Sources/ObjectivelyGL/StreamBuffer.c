@@ -0,0 +1,193 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "StreamBuffer.h"
+
+#define _Class _StreamBuffer
+
+/**
+ * @brief The flags of the StreamBuffer storage and mapping.
+ */
+#define STREAM_BUFFER_FLAGS (GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	StreamBuffer *this = (StreamBuffer *) self;
+
+	if (this->fences) {
+		for (size_t i = 0; i < this->frames; i++) {
+			if (this->fences[i]) {
+				glDeleteSync(this->fences[i]);
+			}
+		}
+		free(this->fences);
+	}
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - StreamBuffer
+
+/**
+ * @fn StreamAllocation StreamBuffer::allocate(StreamBuffer *self, GLsizeiptr size, GLsizeiptr alignment)
+ * @memberof StreamBuffer
+ */
+static StreamAllocation allocate(StreamBuffer *self, GLsizeiptr size, GLsizeiptr alignment) {
+
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	StreamAllocation allocation = { .pointer = NULL, .offset = 0 };
+
+	const GLsizeiptr head = (self->head + alignment - 1) & ~(alignment - 1);
+	if (head + size <= self->regionSize) {
+
+		allocation.offset = (GLintptr) (self->frame * self->regionSize + head);
+		allocation.pointer = self->mapping + allocation.offset;
+
+		self->head = head + size;
+	}
+
+	return allocation;
+}
+
+/**
+ * @fn void StreamBuffer::beginFrame(StreamBuffer *self)
+ * @memberof StreamBuffer
+ */
+static void beginFrame(StreamBuffer *self) {
+
+	GLsync fence = self->fences[self->frame];
+	if (fence) {
+
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED) {
+			self->stalls++;
+
+			do {
+				status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (status == GL_TIMEOUT_EXPIRED);
+		}
+
+		assert(status != GL_WAIT_FAILED);
+
+		glDeleteSync(fence);
+		self->fences[self->frame] = NULL;
+	}
+
+	self->head = 0;
+}
+
+/**
+ * @fn void StreamBuffer::endFrame(StreamBuffer *self)
+ * @memberof StreamBuffer
+ */
+static void endFrame(StreamBuffer *self) {
+
+	assert(self->fences[self->frame] == NULL);
+
+	self->fences[self->frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	self->frame = (self->frame + 1) % self->frames;
+	self->head = 0;
+}
+
+/**
+ * @fn StreamBuffer *StreamBuffer::initWithSize(StreamBuffer *self, GLenum target, GLsizeiptr size, size_t frames)
+ * @memberof StreamBuffer
+ */
+static StreamBuffer *initWithSize(StreamBuffer *self, GLenum target, GLsizeiptr size, size_t frames) {
+
+	assert(size > 0);
+	assert(frames > 0);
+
+	const GLsizeiptr regionSize = (size + STREAM_BUFFER_REGION_ALIGNMENT - 1) & ~(STREAM_BUFFER_REGION_ALIGNMENT - 1);
+
+	const BufferStorage storage = MakeBufferStorage(target, regionSize * frames, NULL, STREAM_BUFFER_FLAGS);
+
+	self = (StreamBuffer *) super(Buffer, self, initWithStorage, &storage);
+	if (self) {
+		self->frames = frames;
+		self->regionSize = regionSize;
+
+		self->fences = calloc(frames, sizeof(GLsync));
+		assert(self->fences);
+
+		self->mapping = $((Buffer *) self, mapRange, target, 0, storage.size, STREAM_BUFFER_FLAGS);
+
+		$((Buffer *) self, unbind, target);
+
+		if (self->mapping == NULL) {
+			self = release(self);
+		}
+	}
+
+	return self;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((StreamBufferInterface *) clazz->interface)->allocate = allocate;
+	((StreamBufferInterface *) clazz->interface)->beginFrame = beginFrame;
+	((StreamBufferInterface *) clazz->interface)->endFrame = endFrame;
+	((StreamBufferInterface *) clazz->interface)->initWithSize = initWithSize;
+}
+
+/**
+ * @fn Class *StreamBuffer::_StreamBuffer(void)
+ * @memberof StreamBuffer
+ */
+Class *_StreamBuffer(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "StreamBuffer",
+			.superclass = _Buffer(),
+			.instanceSize = sizeof(StreamBuffer),
+			.interfaceOffset = offsetof(StreamBuffer, interface),
+			.interfaceSize = sizeof(StreamBufferInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
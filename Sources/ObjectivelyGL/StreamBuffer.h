@@ -0,0 +1,185 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <ObjectivelyGL/Buffer.h>
+
+/**
+ * @file
+ * @brief StreamBuffers are persistently mapped ring Buffers for data written once per frame.
+ * @details The data store of a StreamBuffer is split into one region per frame in flight. Each
+ * frame, data is bump allocated from the current region and written directly through the mapping,
+ * avoiding the copies and implicit synchronization of `glBufferData` and `glBufferSubData`. At the
+ * end of each frame, the region is guarded by a fence, which must be signaled before the region is
+ * reused.
+ *
+ * StreamBuffers require `glBufferStorage`, from OpenGL 4.4 or `ARB_buffer_storage`.
+ */
+
+/**
+ * @brief The default count of frame regions in a StreamBuffer.
+ */
+#define STREAM_BUFFER_DEFAULT_FRAMES 3
+
+/**
+ * @brief The alignment of StreamBuffer frame regions, sufficient for any Buffer binding.
+ */
+#define STREAM_BUFFER_REGION_ALIGNMENT 256
+
+/**
+ * @brief A StreamBuffer allocation.
+ */
+typedef struct {
+
+	/**
+	 * @brief The mapped address to write the allocation's data to, or `NULL` if the allocation
+	 * failed.
+	 */
+	ident pointer;
+
+	/**
+	 * @brief The offset of the allocation in the StreamBuffer, in bytes.
+	 */
+	GLintptr offset;
+
+} StreamAllocation;
+
+typedef struct StreamBuffer StreamBuffer;
+typedef struct StreamBufferInterface StreamBufferInterface;
+
+/**
+ * @brief The StreamBuffer type.
+ * @extends Buffer
+ */
+struct StreamBuffer {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Buffer buffer;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	StreamBufferInterface *interface;
+
+	/**
+	 * @brief The persistent mapping of the data store.
+	 * @private
+	 */
+	GLubyte *mapping;
+
+	/**
+	 * @brief The count of frame regions.
+	 */
+	size_t frames;
+
+	/**
+	 * @brief The size of each frame region, in bytes.
+	 */
+	GLsizeiptr regionSize;
+
+	/**
+	 * @brief The index of the current frame region.
+	 */
+	size_t frame;
+
+	/**
+	 * @brief The offset of the next allocation in the current frame region, in bytes.
+	 */
+	GLsizeiptr head;
+
+	/**
+	 * @brief The fences guarding each frame region.
+	 * @private
+	 */
+	GLsync *fences;
+
+	/**
+	 * @brief The count of times `beginFrame` waited for the GPU.
+	 */
+	size_t stalls;
+};
+
+/**
+ * @brief The StreamBuffer interface.
+ */
+struct StreamBufferInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	BufferInterface bufferInterface;
+
+	/**
+	 * @fn StreamAllocation StreamBuffer::allocate(StreamBuffer *self, GLsizeiptr size, GLsizeiptr alignment)
+	 * @brief Allocates space from the current frame region of this StreamBuffer.
+	 * @param self The StreamBuffer.
+	 * @param size The size of the allocation, in bytes.
+	 * @param alignment The alignment of the allocation's offset, which must be a power of two.
+	 * @return The StreamAllocation. Its pointer is `NULL` if the frame region is exhausted.
+	 * @remarks The allocation is valid until the end of the frame.
+	 * @memberof StreamBuffer
+	 */
+	StreamAllocation (*allocate)(StreamBuffer *self, GLsizeiptr size, GLsizeiptr alignment);
+
+	/**
+	 * @fn void StreamBuffer::beginFrame(StreamBuffer *self)
+	 * @brief Begins a frame, waiting for the GPU to release the current frame region if necessary.
+	 * @param self The StreamBuffer.
+	 * @memberof StreamBuffer
+	 */
+	void (*beginFrame)(StreamBuffer *self);
+
+	/**
+	 * @fn void StreamBuffer::endFrame(StreamBuffer *self)
+	 * @brief Ends a frame, fencing the current frame region and advancing to the next.
+	 * @param self The StreamBuffer.
+	 * @remarks Call this after the draw calls that source the frame's allocations are issued.
+	 * @memberof StreamBuffer
+	 */
+	void (*endFrame)(StreamBuffer *self);
+
+	/**
+	 * @fn StreamBuffer *StreamBuffer::initWithSize(StreamBuffer *self, GLenum target, GLsizeiptr size, size_t frames)
+	 * @brief Initializes this StreamBuffer.
+	 * @param self The StreamBuffer.
+	 * @param target The target to bind the StreamBuffer to while allocating its storage.
+	 * @param size The size of each frame region, in bytes.
+	 * @param frames The count of frame regions, typically the count of frames in flight plus one.
+	 * @return The initialized StreamBuffer, or `NULL` on error.
+	 * @memberof StreamBuffer
+	 */
+	StreamBuffer *(*initWithSize)(StreamBuffer *self, GLenum target, GLsizeiptr size, size_t frames);
+};
+
+/**
+ * @fn Class *StreamBuffer::_StreamBuffer(void)
+ * @brief The StreamBuffer archetype.
+ * @return The StreamBuffer Class.
+ * @memberof StreamBuffer
+ */
+OBJECTIVELYGL_EXPORT Class *_StreamBuffer(void);
@@ -22,11 +22,33 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 
 #include "Texture.h"
+#include "JobSystem.h"
+#include "StateCache.h"
 
 #define _Class _Texture
 
+/**
+ * @brief Resizes the estimated size of the given Texture, updating the shared MemoryTracker.
+ */
+static void _resize(Texture *self, GLint internalFormat, GLsizeiptr size) {
+
+	MemoryTracker *tracker = $$(MemoryTracker, sharedInstance);
+
+	if (self->size) {
+		$(tracker, deallocate, MemoryCategoryTexture, self->internalFormat, self->size);
+	}
+
+	self->internalFormat = internalFormat;
+	self->size = size;
+
+	if (self->size) {
+		$(tracker, allocate, MemoryCategoryTexture, self->internalFormat, self->size);
+	}
+}
+
 #pragma mark - Object
 
 /**
@@ -36,7 +58,9 @@ static void dealloc(Object *self) {
 
 	Texture *this = (Texture *) self;
 
-	glDeleteTextures(1, &this->name);
+	_resize(this, GL_NONE, 0);
+
+	$$(StateCache, currentDeleteTextures, 1, &this->name);
 
 	super(Object, self, dealloc);
 }
@@ -48,7 +72,7 @@ static void dealloc(Object *self) {
  * @memberof Texture
  */
 static void bind(const Texture *self, GLenum target) {
-	glBindTexture(target, self->name);
+	$$(StateCache, currentBindTexture, target, self->name);
 }
 
 /**
@@ -70,6 +94,105 @@ static Texture *init(Texture *self) {
 	return self;
 }
 
+/**
+ * @fn Texture *Texture::initWithStorage(Texture *self, const TextureStorage *storage)
+ * @memberof Texture
+ */
+static Texture *initWithStorage(Texture *self, const TextureStorage *storage) {
+
+	self = (Texture *) super(Object, self, init);
+	if (self) {
+
+		if (HasDirectStateAccess()) {
+			glCreateTextures(storage->target, 1, &self->name);
+		} else {
+			glGenTextures(1, &self->name);
+		}
+
+		if (self->name == 0 || glTexStorage2D == NULL) {
+			return release(self);
+		}
+
+		if (HasDirectStateAccess() == false) {
+			$(self, bind, storage->target);
+		}
+
+		switch (storage->target) {
+			case GL_TEXTURE_1D:
+				if (HasDirectStateAccess()) {
+					glTextureStorage1D(self->name, storage->levels, storage->internalFormat, storage->width);
+				} else {
+					glTexStorage1D(storage->target, storage->levels, storage->internalFormat, storage->width);
+				}
+				break;
+			case GL_TEXTURE_1D_ARRAY:
+			case GL_TEXTURE_2D:
+			case GL_TEXTURE_CUBE_MAP:
+				if (HasDirectStateAccess()) {
+					glTextureStorage2D(self->name,
+									   storage->levels,
+									   storage->internalFormat,
+									   storage->width,
+									   storage->height);
+				} else {
+					glTexStorage2D(storage->target,
+								   storage->levels,
+								   storage->internalFormat,
+								   storage->width,
+								   storage->height);
+				}
+				break;
+			case GL_TEXTURE_2D_ARRAY:
+			case GL_TEXTURE_3D:
+			case GL_TEXTURE_CUBE_MAP_ARRAY:
+				if (HasDirectStateAccess()) {
+					glTextureStorage3D(self->name,
+									   storage->levels,
+									   storage->internalFormat,
+									   storage->width,
+									   storage->height,
+									   storage->depth);
+				} else {
+					glTexStorage3D(storage->target,
+								   storage->levels,
+								   storage->internalFormat,
+								   storage->width,
+								   storage->height,
+								   storage->depth);
+				}
+				break;
+			default:
+				assert(0);
+				break;
+		}
+
+		self->levels = storage->levels;
+
+		GLsizeiptr size = 0;
+		GLsizei width = storage->width, height = max(storage->height, 1), depth = max(storage->depth, 1);
+
+		for (GLsizei i = 0; i < storage->levels; i++) {
+			size += $$(MemoryTracker, bytesForInternalFormat, storage->internalFormat) * width * height * depth;
+
+			width = max(width >> 1, 1);
+			if (storage->target != GL_TEXTURE_1D_ARRAY) {
+				height = max(height >> 1, 1);
+			}
+			if (storage->target == GL_TEXTURE_3D) {
+				depth = max(depth >> 1, 1);
+			}
+		}
+
+		if (storage->target == GL_TEXTURE_CUBE_MAP) {
+			size *= 6;
+		}
+
+		_resize(self, storage->internalFormat, size);
+	}
+
+	return self;
+}
+
 /**
  * @fn Texture *Texture::initWithTextureData(Texture *self, const TextureData *data)
  * @memberof Texture
@@ -89,7 +212,7 @@ static Texture *initWithTextureData(Texture *self, const TextureData *data) {
  * @memberof Texture
  */
 static void unbind(const Texture *self, GLenum target) {
-	glBindTexture(target, 0);
+	$$(StateCache, currentBindTexture, target, 0);
 }
 
 /**
@@ -98,6 +221,22 @@ static void unbind(const Texture *self, GLenum target) {
  */
 static void writeData(Texture *self, const TextureData *data) {
 
+	if (self->levels) {
+		assert(data->level < self->levels);
+
+		$(self, writeSubData, &(const TextureSubData) {
+			.target = data->target,
+			.level = data->level,
+			.width = data->width,
+			.height = data->height,
+			.depth = data->depth,
+			.format = data->format,
+			.type = data->type,
+			.data = data->data
+		});
+		return;
+	}
+
 	switch (data->target) {
 		case GL_TEXTURE_1D:
 			glTexImage1D(data->target,
@@ -111,6 +250,12 @@ static void writeData(Texture *self, const TextureData *data) {
 			break;
 		case GL_TEXTURE_1D_ARRAY:
 		case GL_TEXTURE_2D:
+		case GL_TEXTURE_CUBE_MAP_POSITIVE_X:
+		case GL_TEXTURE_CUBE_MAP_NEGATIVE_X:
+		case GL_TEXTURE_CUBE_MAP_POSITIVE_Y:
+		case GL_TEXTURE_CUBE_MAP_NEGATIVE_Y:
+		case GL_TEXTURE_CUBE_MAP_POSITIVE_Z:
+		case GL_TEXTURE_CUBE_MAP_NEGATIVE_Z:
 			glTexImage2D(data->target,
 						 data->level,
 						 data->internalFormat,
@@ -138,6 +283,156 @@ static void writeData(Texture *self, const TextureData *data) {
 			assert(0);
 			break;
 	}
+
+	const GLsizeiptr size = $$(MemoryTracker, bytesForInternalFormat, data->internalFormat)
+		* max(data->width, 1)
+		* max(data->height, 1)
+		* max(data->depth, 1);
+
+	if (data->level == 0) {
+		_resize(self, data->internalFormat, size);
+	} else {
+		_resize(self, self->internalFormat, self->size + size);
+	}
+}
+
+/**
+ * @brief The context of a parallel mipmap downsample.
+ */
+typedef struct {
+	const GLubyte *in;
+	GLubyte *out;
+	GLsizei width, height;
+	size_t components;
+	size_t stride;
+} MipmapLevel;
+
+/**
+ * @brief JobRangeFunction for box filtering rows of a mipmap from the level above it.
+ */
+static void downsampleRows(size_t begin, size_t end, ident data) {
+
+	const MipmapLevel *level = data;
+
+	const GLsizei width = max(level->width >> 1, 1);
+
+	for (size_t y = begin; y < end; y++) {
+
+		const GLubyte *row0 = level->in + min((GLsizei) y * 2, level->height - 1) * level->stride;
+		const GLubyte *row1 = level->in + min((GLsizei) y * 2 + 1, level->height - 1) * level->stride;
+
+		GLubyte *out = level->out + y * width * level->components;
+
+		for (GLsizei x = 0; x < width; x++) {
+
+			const size_t x0 = min(x * 2, level->width - 1) * level->components;
+			const size_t x1 = min(x * 2 + 1, level->width - 1) * level->components;
+
+			for (size_t c = 0; c < level->components; c++) {
+				*out++ = (GLubyte) ((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+			}
+		}
+	}
+}
+
+/**
+ * @return The count of components per texel of the given format, or `0` if it is not supported.
+ */
+static size_t componentsForFormat(GLenum format) {
+
+	switch (format) {
+		case GL_RED:
+			return 1;
+		case GL_RG:
+			return 2;
+		case GL_RGB:
+		case GL_BGR:
+			return 3;
+		case GL_RGBA:
+		case GL_BGRA:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @fn void Texture::writeMipmaps(Texture *self, const TextureData *data)
+ * @memberof Texture
+ */
+static void writeMipmaps(Texture *self, const TextureData *data) {
+
+	$(self, writeData, data);
+
+	const size_t components = componentsForFormat(data->format);
+
+	if (data->target != GL_TEXTURE_2D || data->type != GL_UNSIGNED_BYTE || components == 0 || data->data == NULL) {
+		if (HasDirectStateAccess()) {
+			glGenerateTextureMipmap(self->name);
+		} else {
+			glGenerateMipmap(data->target);
+		}
+
+		if (self->levels == 0) {
+			_resize(self, self->internalFormat, self->size + self->size / 3);
+		}
+		return;
+	}
+
+	JobSystem *jobs = $$(JobSystem, sharedInstance);
+
+	GLint alignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	MipmapLevel level = {
+		.in = data->data,
+		.width = data->width,
+		.height = data->height,
+		.components = components,
+		.stride = (data->width * components + alignment - 1) / alignment * alignment
+	};
+
+	GLubyte *buffers[2] = {
+		malloc(max(data->width >> 1, 1) * max(data->height >> 1, 1) * components),
+		malloc(max(data->width >> 2, 1) * max(data->height >> 2, 1) * components)
+	};
+
+	for (GLint i = 1; level.width > 1 || level.height > 1; i++) {
+
+		if (self->levels && data->level + i == self->levels) {
+			break;
+		}
+
+		level.out = buffers[(i - 1) & 1];
+
+		const GLsizei width = max(level.width >> 1, 1);
+		const GLsizei height = max(level.height >> 1, 1);
+
+		$(jobs, parallelFor, height, 0, downsampleRows, &level);
+
+		const TextureData mipmap = MakeTextureData(data->target,
+												   data->level + i,
+												   data->internalFormat,
+												   width,
+												   height,
+												   0,
+												   data->format,
+												   data->type,
+												   level.out);
+
+		$(self, writeData, &mipmap);
+
+		level.in = level.out;
+		level.width = width;
+		level.height = height;
+		level.stride = width * components;
+	}
+
+	free(buffers[0]);
+	free(buffers[1]);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
 }
 
 /**
@@ -146,6 +441,70 @@ static void writeData(Texture *self, const TextureData *data) {
  */
 static void writeSubData(Texture *self, const TextureSubData *data) {
 
+	if (HasDirectStateAccess()) {
+		switch (data->target) {
+			case GL_TEXTURE_1D:
+				glTextureSubImage1D(self->name,
+									data->level,
+									data->xOffset,
+									data->width,
+									data->format,
+									data->type,
+									data->data);
+				break;
+			case GL_TEXTURE_1D_ARRAY:
+			case GL_TEXTURE_2D:
+				glTextureSubImage2D(self->name,
+									data->level,
+									data->xOffset,
+									data->yOffset,
+									data->width,
+									data->height,
+									data->format,
+									data->type,
+									data->data);
+				break;
+			case GL_TEXTURE_2D_ARRAY:
+			case GL_TEXTURE_3D:
+			case GL_TEXTURE_CUBE_MAP_ARRAY:
+				glTextureSubImage3D(self->name,
+									data->level,
+									data->xOffset,
+									data->yOffset,
+									data->zOffset,
+									data->width,
+									data->height,
+									data->depth,
+									data->format,
+									data->type,
+									data->data);
+				break;
+			case GL_TEXTURE_CUBE_MAP_POSITIVE_X:
+			case GL_TEXTURE_CUBE_MAP_NEGATIVE_X:
+			case GL_TEXTURE_CUBE_MAP_POSITIVE_Y:
+			case GL_TEXTURE_CUBE_MAP_NEGATIVE_Y:
+			case GL_TEXTURE_CUBE_MAP_POSITIVE_Z:
+			case GL_TEXTURE_CUBE_MAP_NEGATIVE_Z:
+				// cube maps are addressed by name as arrays of six faces
+				glTextureSubImage3D(self->name,
+									data->level,
+									data->xOffset,
+									data->yOffset,
+									data->target - GL_TEXTURE_CUBE_MAP_POSITIVE_X,
+									data->width,
+									data->height,
+									1,
+									data->format,
+									data->type,
+									data->data);
+				break;
+			default:
+				assert(0);
+				break;
+		}
+		return;
+	}
+
 	switch (data->target) {
 		case GL_TEXTURE_1D:
 			glTexSubImage1D(data->target,
@@ -158,6 +517,12 @@ static void writeSubData(Texture *self, const TextureSubData *data) {
 			break;
 		case GL_TEXTURE_1D_ARRAY:
 		case GL_TEXTURE_2D:
+		case GL_TEXTURE_CUBE_MAP_POSITIVE_X:
+		case GL_TEXTURE_CUBE_MAP_NEGATIVE_X:
+		case GL_TEXTURE_CUBE_MAP_POSITIVE_Y:
+		case GL_TEXTURE_CUBE_MAP_NEGATIVE_Y:
+		case GL_TEXTURE_CUBE_MAP_POSITIVE_Z:
+		case GL_TEXTURE_CUBE_MAP_NEGATIVE_Z:
 			glTexSubImage2D(data->target,
 							data->level,
 							data->xOffset,
@@ -170,6 +535,7 @@ static void writeSubData(Texture *self, const TextureSubData *data) {
 			break;
 		case GL_TEXTURE_2D_ARRAY:
 		case GL_TEXTURE_3D:
+		case GL_TEXTURE_CUBE_MAP_ARRAY:
 			glTexSubImage3D(data->target,
 							data->level,
 							data->xOffset,
@@ -199,9 +565,11 @@ static void initialize(Class *clazz) {
 
 	((TextureInterface *) clazz->interface)->bind = bind;
 	((TextureInterface *) clazz->interface)->init = init;
+	((TextureInterface *) clazz->interface)->initWithStorage = initWithStorage;
 	((TextureInterface *) clazz->interface)->initWithTextureData = initWithTextureData;
 	((TextureInterface *) clazz->interface)->unbind = unbind;
 	((TextureInterface *) clazz->interface)->writeData = writeData;
+	((TextureInterface *) clazz->interface)->writeMipmaps = writeMipmaps;
 	((TextureInterface *) clazz->interface)->writeSubData = writeSubData;
 }
 
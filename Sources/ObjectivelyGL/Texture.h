@@ -25,6 +25,7 @@
 
 #include <Objectively/Object.h>
 
+#include <ObjectivelyGL/MemoryTracker.h>
 #include <ObjectivelyGL/Types.h>
 
 /**
@@ -78,7 +79,7 @@ typedef struct TextureData {
 } TextureData;
 
 #define MakeTextureData(target, level, internalFormat, width, height, depth, format, type, data) \
-	(TextureData) { (target), (level), (internalFormat), (width), (height), (format), (type), (data) }
+	(TextureData) { (target), (level), (internalFormat), (width), (height), (depth), (format), (type), (data) }
 
 #define MakeTextureData2D_RGB(width, height, data) \
 	MakeTextureData(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data)
@@ -99,7 +100,8 @@ typedef struct TextureData {
 typedef struct TextureSubData {
 
 	/**
-	 * @brief The target, e.g. `GL_TEXTURE_2D`, `GL_TEXTURE_3D`, etc.
+	 * @brief The target, e.g. `GL_TEXTURE_2D`, `GL_TEXTURE_3D`, or a cube map face such as
+	 * `GL_TEXTURE_CUBE_MAP_POSITIVE_X`.
 	 */
 	GLenum target;
 
@@ -134,6 +136,39 @@ typedef struct TextureSubData {
 	const ident data;
 } TextureSubData;
 
+/**
+ * @brief TextureStorage is used to allocate immutable storage for a Texture.
+ * @see glTexStorage1D, glTexStorage2D, glTexStorage3D
+ */
+typedef struct TextureStorage {
+
+	/**
+	 * @brief The target, e.g. `GL_TEXTURE_2D`, `GL_TEXTURE_3D`, etc.
+	 */
+	GLenum target;
+
+	/**
+	 * @brief The count of mipmap levels.
+	 */
+	GLsizei levels;
+
+	/**
+	 * @brief The sized internal format, e.g. `GL_RGBA8`.
+	 */
+	GLenum internalFormat;
+
+	/**
+	 * @brief The width, height and depth of the base level.
+	 */
+	GLsizei width, height, depth;
+} TextureStorage;
+
+#define MakeTextureStorage(target, levels, internalFormat, width, height, depth) \
+	(TextureStorage) { (target), (levels), (internalFormat), (width), (height), (depth) }
+
+#define MakeTextureStorage2D(levels, internalFormat, width, height) \
+	MakeTextureStorage(GL_TEXTURE_2D, levels, internalFormat, width, height, 0)
+
 /**
  * @brief The Texture type.
  * @extends Object
@@ -155,6 +190,21 @@ struct Texture {
 	 * @brief The name.
 	 */
 	GLuint name;
+
+	/**
+	 * @brief The internal format of the base level.
+	 */
+	GLint internalFormat;
+
+	/**
+	 * @brief The estimated size of all levels, in bytes.
+	 */
+	GLsizeiptr size;
+
+	/**
+	 * @brief The count of mipmap levels, if the Texture's storage is immutable.
+	 */
+	GLsizei levels;
 };
 
 /**
@@ -185,6 +235,19 @@ struct TextureInterface {
 	 */
 	Texture *(*init)(Texture *self);
 
+	/**
+	 * @fn Texture *Texture::initWithStorage(Texture *self, const TextureStorage *storage)
+	 * @brief Initializes this Texture with immutable storage.
+	 * @param self The Texture.
+	 * @param storage The TextureStorage.
+	 * @return The initialized Texture, or `NULL` on error.
+	 * @remarks Immutable storage requires OpenGL 4.2 or `ARB_texture_storage`. Where Direct State
+	 * Access is available, the Texture is created without binding it. Otherwise, it is left bound to
+	 * the storage's target. Subsequent writes must fit within the storage.
+	 * @memberof Texture
+	 */
+	Texture *(*initWithStorage)(Texture *self, const TextureStorage *storage);
+
 	/**
 	 * @fn Texture *Texture::initWithTextureData(Texture *self, const TextureData *data)
 	 * @brief Initializes this Texture with the specified data.
@@ -213,6 +276,17 @@ struct TextureInterface {
 	 */
 	void (*writeData)(Texture *self, const TextureData *data);
 
+	/**
+	 * @fn void Texture::writeMipmaps(Texture *self, const TextureData *data)
+	 * @brief Writes image data and its complete mipmap chain to this Texture.
+	 * @param self The Texture.
+	 * @param data The TextureData for the base level.
+	 * @remarks For 2D images of `GL_UNSIGNED_BYTE`, the mipmaps are box filtered on the CPU, in
+	 * parallel. Otherwise, they are generated with `glGenerateMipmap`.
+	 * @memberof Texture
+	 */
+	void (*writeMipmaps)(Texture *self, const TextureData *data);
+
 	/**
 	 * @fn void Texture::writeSubData(const Texture *self, const TextureSubData *data)
 	 * @brief Writes subimage data to this Texture.
@@ -51,6 +51,14 @@ typedef union {
 	};
 } vec4ubs;
 
+/**
+ * @brief True if Direct State Access is available, from OpenGL 4.5 or `ARB_direct_state_access`.
+ * @details Where available, Buffers, Textures and VertexArrays are created and modified by name,
+ * without binding them. The entry points of `ARB_direct_state_access` share the names of their
+ * core counterparts, and are loaded by `gladLoadGLLoader` for contexts advertising the extension.
+ */
+#define HasDirectStateAccess() (glad_glCreateBuffers != NULL)
+
 #ifndef OBJECTIVELYGL_EXPORT
 #define OBJECTIVELYGL_EXPORT extern
 #endif
@@ -24,6 +24,7 @@
 #include <assert.h>
 
 #include "UniformBuffer.h"
+#include "StateCache.h"
 
 #define _Class _UniformBuffer
 
@@ -34,7 +35,7 @@
  * @memberof UniformBuffer
  */
 static void bind(const UniformBuffer *self, GLuint index) {
-	glBindBufferBase(GL_UNIFORM_BUFFER, index, self->buffer.name);
+	$$(StateCache, currentBindBufferRange, GL_UNIFORM_BUFFER, index, self->buffer.name, 0, 0);
 }
 
 /**
@@ -42,7 +43,7 @@ static void bind(const UniformBuffer *self, GLuint index) {
  * @memberof UniformBuffer
  */
 static void bindRange(const UniformBuffer *self, GLuint index, GLintptr offset, GLsizeiptr size) {
-	glBindBufferRange(GL_UNIFORM_BUFFER, index, self->buffer.name, offset, size);
+	$$(StateCache, currentBindBufferRange, GL_UNIFORM_BUFFER, index, self->buffer.name, offset, size);
 }
 
 /**
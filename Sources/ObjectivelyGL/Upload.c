@@ -0,0 +1,129 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+
+#include "Upload.h"
+
+#define _Class _Upload
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	Upload *this = (Upload *) self;
+
+	if (this->sync) {
+		glDeleteSync(this->sync);
+	}
+
+	release(this->queue);
+	release(this->resource);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - Upload
+
+/**
+ * @fn Upload *Upload::init(Upload *self)
+ * @memberof Upload
+ */
+static Upload *init(Upload *self) {
+	return (Upload *) super(Object, self, init);
+}
+
+/**
+ * @fn _Bool Upload::isComplete(const Upload *self)
+ * @memberof Upload
+ */
+static _Bool isComplete(const Upload *self) {
+
+	const GLsync sync = __atomic_load_n(&self->sync, __ATOMIC_ACQUIRE);
+	if (sync) {
+		switch (glClientWaitSync(sync, 0, 0)) {
+			case GL_ALREADY_SIGNALED:
+			case GL_CONDITION_SATISFIED:
+				return true;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @fn void Upload::wait(const Upload *self)
+ * @memberof Upload
+ */
+static void wait(const Upload *self) {
+
+	assert(self->queue);
+
+	$(self->queue, waitForFence, self->fence);
+
+	glWaitSync(__atomic_load_n(&self->sync, __ATOMIC_ACQUIRE), 0, GL_TIMEOUT_IGNORED);
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((UploadInterface *) clazz->interface)->init = init;
+	((UploadInterface *) clazz->interface)->isComplete = isComplete;
+	((UploadInterface *) clazz->interface)->wait = wait;
+}
+
+/**
+ * @fn Class *Upload::_Upload(void)
+ * @memberof Upload
+ */
+Class *_Upload(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "Upload",
+			.superclass = _Object(),
+			.instanceSize = sizeof(Upload),
+			.interfaceOffset = offsetof(Upload, interface),
+			.interfaceSize = sizeof(UploadInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
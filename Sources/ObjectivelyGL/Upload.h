@@ -0,0 +1,157 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <ObjectivelyGL/Buffer.h>
+#include <ObjectivelyGL/CommandQueue.h>
+#include <ObjectivelyGL/Texture.h>
+
+/**
+ * @file
+ * @brief Uploads are handles to Buffer and Texture writes issued on an UploadQueue.
+ * @details An Upload is complete once its write has been issued on the UploadQueue's shared GL
+ * context, and a GL sync object inserted after it has been signaled. Rendering threads use the
+ * Upload to determine when the written resource is safe to use.
+ * @see UploadQueue
+ */
+
+typedef struct Upload Upload;
+typedef struct UploadInterface UploadInterface;
+
+/**
+ * @brief Upload types.
+ */
+typedef enum {
+	UploadTypeBufferData,
+	UploadTypeBufferSubData,
+	UploadTypeTextureData,
+	UploadTypeTextureSubData
+} UploadType;
+
+/**
+ * @brief The Upload type.
+ * @extends Object
+ */
+struct Upload {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	UploadInterface *interface;
+
+	/**
+	 * @brief The UploadQueue on which this Upload was issued.
+	 * @private
+	 */
+	CommandQueue *queue;
+
+	/**
+	 * @brief The CommandFence of this Upload on its UploadQueue.
+	 */
+	CommandFence fence;
+
+	/**
+	 * @brief The GL sync object, inserted once the write has been issued.
+	 * @private
+	 */
+	GLsync sync;
+
+	/**
+	 * @brief The UploadType.
+	 */
+	UploadType type;
+
+	/**
+	 * @brief The Buffer or Texture written to.
+	 */
+	ident resource;
+
+	/**
+	 * @brief The write, which is interpreted according to `type`.
+	 * @private
+	 */
+	union {
+		BufferData bufferData;
+		BufferSubData bufferSubData;
+		TextureData textureData;
+		TextureSubData textureSubData;
+	} data;
+};
+
+/**
+ * @brief The Upload interface.
+ */
+struct UploadInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn Upload *Upload::init(Upload *self)
+	 * @brief Initializes this Upload.
+	 * @param self The Upload.
+	 * @return The initialized Upload, or `NULL` on error.
+	 * @memberof Upload
+	 */
+	Upload *(*init)(Upload *self);
+
+	/**
+	 * @fn _Bool Upload::isComplete(const Upload *self)
+	 * @param self The Upload.
+	 * @return True if this Upload has completed on the GPU, false otherwise.
+	 * @remarks This method does not block, and is suitable for polling. A GL context that shares
+	 * with the UploadQueue's context must be current on the calling thread.
+	 * @memberof Upload
+	 */
+	_Bool (*isComplete)(const Upload *self);
+
+	/**
+	 * @fn void Upload::wait(const Upload *self)
+	 * @brief Orders subsequent GL commands on the calling thread's context after this Upload.
+	 * @details Blocks the calling thread until this Upload has been issued, and then instructs
+	 * the GL server to wait for it, without blocking the calling thread on the GPU.
+	 * @param self The Upload.
+	 * @remarks A GL context that shares with the UploadQueue's context must be current on the
+	 * calling thread.
+	 * @memberof Upload
+	 */
+	void (*wait)(const Upload *self);
+};
+
+/**
+ * @fn Class *Upload::_Upload(void)
+ * @brief The Upload archetype.
+ * @return The Upload Class.
+ * @memberof Upload
+ */
+OBJECTIVELYGL_EXPORT Class *_Upload(void);
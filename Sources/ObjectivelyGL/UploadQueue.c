@@ -0,0 +1,208 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <string.h>
+
+#include "UploadQueue.h"
+
+#define _Class _UploadQueue
+
+#define UPLOAD_QUEUE_DEFAULT_CAPACITY 64
+
+#pragma mark - UploadQueue
+
+/**
+ * @brief Consumer for Uploads, executed with the shared GL context current.
+ */
+static void _upload(ident data) {
+
+	Upload *upload = data;
+
+	switch (upload->type) {
+		case UploadTypeBufferData:
+			$((Buffer *) upload->resource, bind, upload->data.bufferData.target);
+			$((Buffer *) upload->resource, writeData, &upload->data.bufferData);
+			$((Buffer *) upload->resource, unbind, upload->data.bufferData.target);
+			break;
+		case UploadTypeBufferSubData:
+			$((Buffer *) upload->resource, bind, upload->data.bufferSubData.target);
+			$((Buffer *) upload->resource, writeSubData, &upload->data.bufferSubData);
+			$((Buffer *) upload->resource, unbind, upload->data.bufferSubData.target);
+			break;
+		case UploadTypeTextureData:
+			$((Texture *) upload->resource, bind, upload->data.textureData.target);
+			$((Texture *) upload->resource, writeData, &upload->data.textureData);
+			$((Texture *) upload->resource, unbind, upload->data.textureData.target);
+			break;
+		case UploadTypeTextureSubData:
+			$((Texture *) upload->resource, bind, upload->data.textureSubData.target);
+			$((Texture *) upload->resource, writeSubData, &upload->data.textureSubData);
+			$((Texture *) upload->resource, unbind, upload->data.textureSubData.target);
+			break;
+	}
+
+	const GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	glFlush();
+
+	__atomic_store_n(&upload->sync, sync, __ATOMIC_RELEASE);
+
+	release(upload);
+}
+
+/**
+ * @brief Enqueues the given Upload, returning it on success.
+ */
+static Upload *_enqueue(UploadQueue *self, Upload *upload) {
+
+	upload->queue = retain(self);
+
+	retain(upload);
+
+	if ($((CommandQueue *) self, enqueueWithFence, _upload, upload, &upload->fence)) {
+		return upload;
+	}
+
+	release(upload);
+	return release(upload);
+}
+
+/**
+ * @fn UploadQueue *UploadQueue::initWithContext(UploadQueue *self, Consumer makeCurrent, ident context)
+ * @memberof UploadQueue
+ */
+static UploadQueue *initWithContext(UploadQueue *self, Consumer makeCurrent, ident context) {
+
+	assert(makeCurrent);
+
+	self = (UploadQueue *) super(CommandQueue, self, initWithPolicy, CommandQueuePolicyBlock, UPLOAD_QUEUE_DEFAULT_CAPACITY);
+	if (self) {
+		$((CommandQueue *) self, enqueue, makeCurrent, context);
+	}
+
+	return self;
+}
+
+/**
+ * @fn Upload *UploadQueue::writeBufferData(UploadQueue *self, Buffer *buffer, const BufferData *data)
+ * @memberof UploadQueue
+ */
+static Upload *writeBufferData(UploadQueue *self, Buffer *buffer, const BufferData *data) {
+
+	Upload *upload = $(alloc(Upload), init);
+	assert(upload);
+
+	upload->type = UploadTypeBufferData;
+	upload->resource = retain(buffer);
+	upload->data.bufferData = *data;
+
+	return _enqueue(self, upload);
+}
+
+/**
+ * @fn Upload *UploadQueue::writeBufferSubData(UploadQueue *self, Buffer *buffer, const BufferSubData *data)
+ * @memberof UploadQueue
+ */
+static Upload *writeBufferSubData(UploadQueue *self, Buffer *buffer, const BufferSubData *data) {
+
+	Upload *upload = $(alloc(Upload), init);
+	assert(upload);
+
+	upload->type = UploadTypeBufferSubData;
+	upload->resource = retain(buffer);
+	upload->data.bufferSubData = *data;
+
+	return _enqueue(self, upload);
+}
+
+/**
+ * @fn Upload *UploadQueue::writeTextureData(UploadQueue *self, Texture *texture, const TextureData *data)
+ * @memberof UploadQueue
+ */
+static Upload *writeTextureData(UploadQueue *self, Texture *texture, const TextureData *data) {
+
+	Upload *upload = $(alloc(Upload), init);
+	assert(upload);
+
+	upload->type = UploadTypeTextureData;
+	upload->resource = retain(texture);
+	memcpy(&upload->data.textureData, data, sizeof(*data));
+
+	return _enqueue(self, upload);
+}
+
+/**
+ * @fn Upload *UploadQueue::writeTextureSubData(UploadQueue *self, Texture *texture, const TextureSubData *data)
+ * @memberof UploadQueue
+ */
+static Upload *writeTextureSubData(UploadQueue *self, Texture *texture, const TextureSubData *data) {
+
+	Upload *upload = $(alloc(Upload), init);
+	assert(upload);
+
+	upload->type = UploadTypeTextureSubData;
+	upload->resource = retain(texture);
+	memcpy(&upload->data.textureSubData, data, sizeof(*data));
+
+	return _enqueue(self, upload);
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((UploadQueueInterface *) clazz->interface)->initWithContext = initWithContext;
+	((UploadQueueInterface *) clazz->interface)->writeBufferData = writeBufferData;
+	((UploadQueueInterface *) clazz->interface)->writeBufferSubData = writeBufferSubData;
+	((UploadQueueInterface *) clazz->interface)->writeTextureData = writeTextureData;
+	((UploadQueueInterface *) clazz->interface)->writeTextureSubData = writeTextureSubData;
+}
+
+/**
+ * @fn Class *UploadQueue::_UploadQueue(void)
+ * @memberof UploadQueue
+ */
+Class *_UploadQueue(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "UploadQueue",
+			.superclass = _CommandQueue(),
+			.instanceSize = sizeof(UploadQueue),
+			.interfaceOffset = offsetof(UploadQueue, interface),
+			.interfaceSize = sizeof(UploadQueueInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
@@ -0,0 +1,144 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <ObjectivelyGL/CommandQueue.h>
+#include <ObjectivelyGL/Upload.h>
+
+/**
+ * @file
+ * @brief UploadQueues write Buffers and Textures on a dedicated thread and shared GL context.
+ * @details Large Buffer and Texture writes can stall the rendering thread for the duration of the
+ * copy. An UploadQueue instead issues them on its own Thread, with a second GL context that shares
+ * objects with the rendering context. Each write returns an Upload, which the rendering thread
+ * polls or waits on before using the resource.
+ *
+ * The shared GL context is created by the application, e.g. with SDL:
+ *
+ *     SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+ *     SDL_GLContext shared = SDL_GL_CreateContext(window);
+ *     SDL_GL_MakeCurrent(window, context);
+ *
+ * and is made current on the UploadQueue's Thread by the Consumer given to _initWithContext_.
+ *
+ * The data of each write must remain valid until its Upload's CommandFence has completed.
+ */
+
+typedef struct UploadQueue UploadQueue;
+typedef struct UploadQueueInterface UploadQueueInterface;
+
+/**
+ * @brief The UploadQueue type.
+ * @extends CommandQueue
+ */
+struct UploadQueue {
+
+	/**
+	 * @brief The superclass.
+	 */
+	CommandQueue commandQueue;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	UploadQueueInterface *interface;
+};
+
+/**
+ * @brief The UploadQueue interface.
+ */
+struct UploadQueueInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	CommandQueueInterface commandQueueInterface;
+
+	/**
+	 * @fn UploadQueue *UploadQueue::initWithContext(UploadQueue *self, Consumer makeCurrent, ident context)
+	 * @brief Initializes this UploadQueue with the given shared GL context.
+	 * @param self The UploadQueue.
+	 * @param makeCurrent A Consumer that makes the shared GL context current on the calling
+	 * thread. It is the first Command executed by this UploadQueue.
+	 * @param context The shared GL context, which is passed to `makeCurrent`.
+	 * @return The initialized UploadQueue, or `NULL` on error.
+	 * @remarks Designated initializer. This UploadQueue blocks when full.
+	 * @memberof UploadQueue
+	 */
+	UploadQueue *(*initWithContext)(UploadQueue *self, Consumer makeCurrent, ident context);
+
+	/**
+	 * @fn Upload *UploadQueue::writeBufferData(UploadQueue *self, Buffer *buffer, const BufferData *data)
+	 * @brief Writes the given BufferData to the given Buffer.
+	 * @param self The UploadQueue.
+	 * @param buffer The Buffer.
+	 * @param data The BufferData.
+	 * @return The Upload, which the caller must release, or `NULL` on error.
+	 * @memberof UploadQueue
+	 */
+	Upload *(*writeBufferData)(UploadQueue *self, Buffer *buffer, const BufferData *data);
+
+	/**
+	 * @fn Upload *UploadQueue::writeBufferSubData(UploadQueue *self, Buffer *buffer, const BufferSubData *data)
+	 * @brief Writes the given BufferSubData to the given Buffer.
+	 * @param self The UploadQueue.
+	 * @param buffer The Buffer.
+	 * @param data The BufferSubData.
+	 * @return The Upload, which the caller must release, or `NULL` on error.
+	 * @memberof UploadQueue
+	 */
+	Upload *(*writeBufferSubData)(UploadQueue *self, Buffer *buffer, const BufferSubData *data);
+
+	/**
+	 * @fn Upload *UploadQueue::writeTextureData(UploadQueue *self, Texture *texture, const TextureData *data)
+	 * @brief Writes the given TextureData to the given Texture.
+	 * @param self The UploadQueue.
+	 * @param texture The Texture.
+	 * @param data The TextureData.
+	 * @return The Upload, which the caller must release, or `NULL` on error.
+	 * @memberof UploadQueue
+	 */
+	Upload *(*writeTextureData)(UploadQueue *self, Texture *texture, const TextureData *data);
+
+	/**
+	 * @fn Upload *UploadQueue::writeTextureSubData(UploadQueue *self, Texture *texture, const TextureSubData *data)
+	 * @brief Writes the given TextureSubData to the given Texture.
+	 * @param self The UploadQueue.
+	 * @param texture The Texture.
+	 * @param data The TextureSubData.
+	 * @return The Upload, which the caller must release, or `NULL` on error.
+	 * @memberof UploadQueue
+	 */
+	Upload *(*writeTextureSubData)(UploadQueue *self, Texture *texture, const TextureSubData *data);
+};
+
+/**
+ * @fn Class *UploadQueue::_UploadQueue(void)
+ * @brief The UploadQueue archetype.
+ * @return The UploadQueue Class.
+ * @memberof UploadQueue
+ */
+OBJECTIVELYGL_EXPORT Class *_UploadQueue(void);
@@ -0,0 +1,293 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Validator.h"
+
+#define _Class _Validator
+
+/**
+ * @return The rank of the given debug severity, from `0` for notifications to `3` for high.
+ */
+static int _rank(GLenum severity) {
+
+	switch (severity) {
+		case GL_DEBUG_SEVERITY_HIGH:
+			return 3;
+		case GL_DEBUG_SEVERITY_MEDIUM:
+			return 2;
+		case GL_DEBUG_SEVERITY_LOW:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @return The name of the given `glGetError` error.
+ */
+static const GLchar *_errorName(GLenum error) {
+
+	switch (error) {
+		case GL_INVALID_ENUM:
+			return "GL_INVALID_ENUM";
+		case GL_INVALID_VALUE:
+			return "GL_INVALID_VALUE";
+		case GL_INVALID_OPERATION:
+			return "GL_INVALID_OPERATION";
+		case GL_INVALID_FRAMEBUFFER_OPERATION:
+			return "GL_INVALID_FRAMEBUFFER_OPERATION";
+		case GL_OUT_OF_MEMORY:
+			return "GL_OUT_OF_MEMORY";
+		default:
+			return "Unknown error";
+	}
+}
+
+/**
+ * @brief The default ValidatorFunction, which logs to the standard error.
+ */
+static void _log(const Validator *validator, const ValidatorMessage *message, ident data) {
+	fprintf(stderr, "GL type 0x%04x severity 0x%04x id %u: %s\n", message->type, message->severity, message->id, message->message);
+}
+
+/**
+ * @brief Reports the given ValidatorMessage.
+ */
+static void _report(Validator *self, const ValidatorMessage *message) {
+
+	if (_rank(message->severity) < _rank(self->minimumSeverity)) {
+		return;
+	}
+
+	self->stats.messages++;
+
+	if (message->type == GL_DEBUG_TYPE_ERROR) {
+		self->stats.errors++;
+	}
+
+	if (self->function) {
+		self->function(self, message, self->data);
+	}
+}
+
+/**
+ * @brief The `KHR_debug` message callback.
+ */
+static void APIENTRY _debugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam) {
+
+	_report((Validator *) userParam, &(const ValidatorMessage) {
+		.source = source,
+		.type = type,
+		.id = id,
+		.severity = severity,
+		.message = message
+	});
+}
+
+#pragma mark - Object
+
+/**
+ * @see Object::dealloc(Object *)
+ */
+static void dealloc(Object *self) {
+
+	Validator *this = (Validator *) self;
+
+	$(this, setEnabled, false);
+
+	super(Object, self, dealloc);
+}
+
+#pragma mark - Validator
+
+/**
+ * @fn size_t Validator::checkErrors(Validator *self)
+ * @memberof Validator
+ */
+static size_t checkErrors(Validator *self) {
+
+	size_t count = 0;
+
+	GLenum error;
+	while ((error = glGetError()) != GL_NO_ERROR) {
+
+		_report(self, &(const ValidatorMessage) {
+			.source = GL_DEBUG_SOURCE_API,
+			.type = GL_DEBUG_TYPE_ERROR,
+			.id = error,
+			.severity = GL_DEBUG_SEVERITY_HIGH,
+			.message = _errorName(error)
+		});
+
+		count++;
+	}
+
+	self->stats.checks++;
+
+	return count;
+}
+
+/**
+ * @fn void Validator::endFrame(Validator *self)
+ * @memberof Validator
+ */
+static void endFrame(Validator *self) {
+
+	if (self->enabled == false) {
+		return;
+	}
+
+	if (self->debugOutput) {
+		while (glGetError() != GL_NO_ERROR) {
+			;
+		}
+	} else {
+		$(self, checkErrors);
+	}
+}
+
+/**
+ * @fn Validator *Validator::init(Validator *self)
+ * @memberof Validator
+ */
+static Validator *init(Validator *self) {
+
+	self = (Validator *) super(Object, self, init);
+	if (self) {
+		self->minimumSeverity = GL_DEBUG_SEVERITY_LOW;
+		self->function = _log;
+	}
+
+	return self;
+}
+
+/**
+ * @fn void Validator::setEnabled(Validator *self, _Bool enabled)
+ * @memberof Validator
+ */
+static void setEnabled(Validator *self, _Bool enabled) {
+
+	if (enabled == self->enabled) {
+		return;
+	}
+
+	if (enabled) {
+		if (glDebugMessageCallback) {
+			glDebugMessageCallback(_debugMessageCallback, self);
+			glEnable(GL_DEBUG_OUTPUT);
+			glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+
+			self->debugOutput = true;
+		}
+	} else {
+		if (self->debugOutput) {
+			glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+			glDisable(GL_DEBUG_OUTPUT);
+			glDebugMessageCallback(NULL, NULL);
+
+			self->debugOutput = false;
+		}
+	}
+
+	self->enabled = enabled;
+}
+
+/**
+ * @brief The shared Validator.
+ */
+static Validator *_sharedInstance;
+
+/**
+ * @brief Releases the shared Validator when the process exits, without calling OpenGL.
+ */
+static void _releaseSharedInstance(void) {
+
+	// the GL context has been destroyed by now, so the shared Validator is not disabled
+
+	_sharedInstance->enabled = false;
+	_sharedInstance->debugOutput = false;
+
+	_sharedInstance = release(_sharedInstance);
+}
+
+/**
+ * @fn Validator *Validator::sharedInstance(void)
+ * @memberof Validator
+ */
+static Validator *sharedInstance(void) {
+	static Once once;
+
+	do_once(&once, {
+		_sharedInstance = $(alloc(Validator), init);
+		assert(_sharedInstance);
+
+		atexit(_releaseSharedInstance);
+	});
+
+	return _sharedInstance;
+}
+
+#pragma mark - Class lifecycle
+
+/**
+ * @see Class::initialize(Class *)
+ */
+static void initialize(Class *clazz) {
+
+	((ObjectInterface *) clazz->interface)->dealloc = dealloc;
+
+	((ValidatorInterface *) clazz->interface)->checkErrors = checkErrors;
+	((ValidatorInterface *) clazz->interface)->endFrame = endFrame;
+	((ValidatorInterface *) clazz->interface)->init = init;
+	((ValidatorInterface *) clazz->interface)->setEnabled = setEnabled;
+	((ValidatorInterface *) clazz->interface)->sharedInstance = sharedInstance;
+}
+
+/**
+ * @fn Class *Validator::_Validator(void)
+ * @memberof Validator
+ */
+Class *_Validator(void) {
+	static Class *clazz;
+	static Once once;
+
+	do_once(&once, {
+		clazz = _initialize(&(const ClassDef) {
+			.name = "Validator",
+			.superclass = _Object(),
+			.instanceSize = sizeof(Validator),
+			.interfaceOffset = offsetof(Validator, interface),
+			.interfaceSize = sizeof(ValidatorInterface),
+			.initialize = initialize,
+		});
+	});
+
+	return clazz;
+}
+
+#undef _Class
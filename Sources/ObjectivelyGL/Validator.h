@@ -0,0 +1,222 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#pragma once
+
+#include <Objectively/Object.h>
+
+#include <ObjectivelyGL/Types.h>
+
+/**
+ * @file
+ * @brief The Validator reports GL errors and debug messages, at no cost when disabled.
+ * @details Where `KHR_debug` (OpenGL 4.3) is available, the Validator installs a debug message
+ * callback, and messages are reported as they are generated. Otherwise, `glGetError` is checked in
+ * a batch at each frame boundary, with `endFrame`. Validation may be enabled and disabled at
+ * runtime, and must be toggled on the thread that owns the GL context.
+ *
+ * The debug message callback and `GL_DEBUG_OUTPUT` are state of a single GL context, and a
+ * Validator tracks only the context on which it was enabled. Use one Validator per context, and
+ * disable or release it while that context is current. Releasing a Validator disables it.
+ */
+
+typedef struct Validator Validator;
+typedef struct ValidatorInterface ValidatorInterface;
+
+/**
+ * @brief A message reported by the Validator.
+ */
+typedef struct {
+
+	/**
+	 * @brief The source, e.g. `GL_DEBUG_SOURCE_API`.
+	 */
+	GLenum source;
+
+	/**
+	 * @brief The type, e.g. `GL_DEBUG_TYPE_ERROR`.
+	 */
+	GLenum type;
+
+	/**
+	 * @brief The identifier, or the error code of `glGetError` errors.
+	 */
+	GLuint id;
+
+	/**
+	 * @brief The severity, e.g. `GL_DEBUG_SEVERITY_HIGH`.
+	 */
+	GLenum severity;
+
+	/**
+	 * @brief The message.
+	 */
+	const GLchar *message;
+
+} ValidatorMessage;
+
+/**
+ * @brief The function type for Validator messages.
+ * @param validator The Validator.
+ * @param message The ValidatorMessage.
+ * @param data The user data.
+ */
+typedef void (*ValidatorFunction)(const Validator *validator, const ValidatorMessage *message, ident data);
+
+/**
+ * @brief Validator statistics.
+ */
+typedef struct {
+
+	/**
+	 * @brief The count of messages reported.
+	 */
+	size_t messages;
+
+	/**
+	 * @brief The count of messages of type `GL_DEBUG_TYPE_ERROR`.
+	 */
+	size_t errors;
+
+	/**
+	 * @brief The count of batched `glGetError` checks.
+	 */
+	size_t checks;
+
+} ValidatorStats;
+
+/**
+ * @brief The Validator type.
+ * @extends Object
+ */
+struct Validator {
+
+	/**
+	 * @brief The superclass.
+	 */
+	Object object;
+
+	/**
+	 * @brief The interface.
+	 * @protected
+	 */
+	ValidatorInterface *interface;
+
+	/**
+	 * @brief True if validation is enabled.
+	 */
+	_Bool enabled;
+
+	/**
+	 * @brief True if messages are reported by `KHR_debug` callback, false if `glGetError` is used.
+	 */
+	_Bool debugOutput;
+
+	/**
+	 * @brief The minimum severity of debug messages reported, default `GL_DEBUG_SEVERITY_LOW`.
+	 */
+	GLenum minimumSeverity;
+
+	/**
+	 * @brief The ValidatorFunction, which logs messages to the standard error by default.
+	 */
+	ValidatorFunction function;
+
+	/**
+	 * @brief The user data.
+	 */
+	ident data;
+
+	/**
+	 * @brief The statistics.
+	 */
+	ValidatorStats stats;
+};
+
+/**
+ * @brief The Validator interface.
+ */
+struct ValidatorInterface {
+
+	/**
+	 * @brief The superclass interface.
+	 */
+	ObjectInterface objectInterface;
+
+	/**
+	 * @fn size_t Validator::checkErrors(Validator *self)
+	 * @brief Reports all pending `glGetError` errors, regardless of whether validation is enabled.
+	 * @param self The Validator.
+	 * @return The count of errors reported.
+	 * @memberof Validator
+	 */
+	size_t (*checkErrors)(Validator *self);
+
+	/**
+	 * @fn void Validator::endFrame(Validator *self)
+	 * @brief Marks a frame boundary, at which `glGetError` errors are checked, if enabled.
+	 * @param self The Validator.
+	 * @remarks With `KHR_debug`, errors have already been reported by callback, and pending errors
+	 * are only cleared.
+	 * @memberof Validator
+	 */
+	void (*endFrame)(Validator *self);
+
+	/**
+	 * @fn Validator *Validator::init(Validator *self)
+	 * @brief Initializes this Validator.
+	 * @param self The Validator.
+	 * @return The initialized Validator, or `NULL` on error.
+	 * @memberof Validator
+	 */
+	Validator *(*init)(Validator *self);
+
+	/**
+	 * @fn void Validator::setEnabled(Validator *self, _Bool enabled)
+	 * @brief Enables or disables validation for the current GL context.
+	 * @param self The Validator.
+	 * @param enabled True to enable validation, false to disable it.
+	 * @remarks Disabling validation unregisters the debug message callback. This Validator
+	 * supports only one context, and must be disabled on the context on which it was enabled.
+	 * @memberof Validator
+	 */
+	void (*setEnabled)(Validator *self, _Bool enabled);
+
+	/**
+	 * @fn Validator *Validator::sharedInstance(void)
+	 * @return The shared Validator.
+	 * @remarks The shared Validator is released at exit without calling OpenGL, and so must be
+	 * disabled before its GL context is destroyed.
+	 * @memberof Validator
+	 */
+	Validator *(*sharedInstance)(void);
+};
+
+/**
+ * @fn Class *Validator::_Validator(void)
+ * @brief The Validator archetype.
+ * @return The Validator Class.
+ * @memberof Validator
+ */
+OBJECTIVELYGL_EXPORT Class *_Validator(void);
@@ -26,6 +26,7 @@
 #include <string.h>
 
 #include "VertexArray.h"
+#include "StateCache.h"
 
 #define _Class _VertexArray
 
@@ -38,7 +39,7 @@ static void dealloc(Object *self) {
 
 	VertexArray *this = (VertexArray *) self;
 
-	glDeleteVertexArrays(1, &this->name);
+	$$(StateCache, currentDeleteVertexArrays, 1, &this->name);
 
 	free(this->attributes);
 
@@ -54,7 +55,7 @@ static void dealloc(Object *self) {
  * @memberof VertexArray
  */
 static void bind(const VertexArray *self) {
-	glBindVertexArray(self->name);
+	$$(StateCache, currentBindVertexArray, self->name);
 }
 
 /**
@@ -62,7 +63,12 @@ static void bind(const VertexArray *self) {
  * @memberof VertexArray
  */
 static void enableAttribute(VertexArray *self, GLuint index) {
-	glEnableVertexAttribArray(index);
+
+	if (HasDirectStateAccess()) {
+		glEnableVertexArrayAttrib(self->name, index);
+	} else {
+		glEnableVertexAttribArray(index);
+	}
 }
 
 /**
@@ -70,7 +76,40 @@ static void enableAttribute(VertexArray *self, GLuint index) {
  * @memberof VertexArray
  */
 static void disableAttribute(VertexArray *self, GLuint index) {
-	glDisableVertexAttribArray(index);
+
+	if (HasDirectStateAccess()) {
+		glDisableVertexArrayAttrib(self->name, index);
+	} else {
+		glDisableVertexAttribArray(index);
+	}
+}
+
+/**
+ * @return The stride of the given Attribute, resolving tightly packed (`0`) strides.
+ */
+static GLsizei strideForAttribute(const Attribute *attr) {
+
+	if (attr->stride) {
+		return attr->stride;
+	}
+
+	switch (attr->type) {
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			return attr->size;
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			return attr->size * 2;
+		case GL_DOUBLE:
+			return attr->size * 8;
+		case GL_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+			return 4;
+		default:
+			return attr->size * 4;
+	}
 }
 
 /**
@@ -83,11 +122,18 @@ static VertexArray *initWithAttributes(VertexArray *self, Buffer *buffer, const
 	if (self) {
 		self->buffer = retain(buffer);
 
-		glGenVertexArrays(1, &self->name);
+		if (HasDirectStateAccess()) {
+			glCreateVertexArrays(1, &self->name);
+		} else {
+			glGenVertexArrays(1, &self->name);
+		}
+
 		if (self->name) {
-			
-			$(self->buffer, bind, GL_ARRAY_BUFFER);
-			$(self, bind);
+
+			if (HasDirectStateAccess() == false) {
+				$(self->buffer, bind, GL_ARRAY_BUFFER);
+				$(self, bind);
+			}
 
 			const Attribute *attr = attributes;
 			while (attr->type != GL_NONE) {
@@ -99,17 +145,34 @@ static VertexArray *initWithAttributes(VertexArray *self, Buffer *buffer, const
 				self->attributes[count - 1] = *attr;
 				self->attributes[count - 0] = MakeAttribute(TagNone, 0, 0, GL_NONE, GL_FALSE, 0, NULL);
 
-				glVertexAttribPointer(attr->index,
-									  attr->size,
-									  attr->type,
-									  attr->normalized,
-									  attr->stride,
-									  attr->pointer);
+				if (HasDirectStateAccess()) {
+					glVertexArrayVertexBuffer(self->name,
+											  attr->index,
+											  self->buffer->name,
+											  (GLintptr) attr->pointer,
+											  strideForAttribute(attr));
+					glVertexArrayAttribFormat(self->name,
+											  attr->index,
+											  attr->size,
+											  attr->type,
+											  attr->normalized,
+											  0);
+					glVertexArrayAttribBinding(self->name, attr->index, attr->index);
+				} else {
+					glVertexAttribPointer(attr->index,
+										  attr->size,
+										  attr->type,
+										  attr->normalized,
+										  attr->stride,
+										  attr->pointer);
+				}
 				attr++;
 			}
 
-			$(self, unbind);
-			$(self->buffer, unbind, GL_ARRAY_BUFFER);
+			if (HasDirectStateAccess() == false) {
+				$(self, unbind);
+				$(self->buffer, unbind, GL_ARRAY_BUFFER);
+			}
 		} else {
 			self = release(self);
 		}
@@ -123,7 +186,7 @@ static VertexArray *initWithAttributes(VertexArray *self, Buffer *buffer, const
  * @memberof VertexArray
  */
 static void unbind(const VertexArray *self) {
-	glBindVertexArray(0);
+	$$(StateCache, currentBindVertexArray, 0);
 }
 
 #pragma mark - Class lifecycle
@@ -109,7 +109,8 @@ struct VertexArrayInterface {
 	 * @fn VertexArray *VertexArray::initWithAttributes(VertexArray *self, Buffer *buffer, const Attribute *attributes)
 	 * @brief Initializes this VertexArray with the backing Buffer and Attributes.
 	 * @param self The VertexArray.
-	 * @param buffer The backing Buffer, which will be bound to `GL_ARRAY_BUFFER`.
+	 * @param buffer The backing Buffer, which is attached by name where Direct State Access is
+	 * available, and otherwise bound to `GL_ARRAY_BUFFER`.
 	 * @param attributes The Attributes.
 	 * @return The initialized VertexArray, or `NULL` on error.
 	 * @memberof VertexArray
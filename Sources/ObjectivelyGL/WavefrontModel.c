@@ -35,6 +35,32 @@ typedef struct {
 	Vector *vn;
 } Wavefront;
 
+/**
+ * @brief Wavefront line types.
+ */
+typedef enum {
+	WavefrontLineOther,
+	WavefrontLineVertex,
+	WavefrontLineTexcoord,
+	WavefrontLineNormal,
+} WavefrontLineType;
+
+/**
+ * @brief A Wavefront line, and the vector parsed from it.
+ */
+typedef struct {
+	char *line;
+	WavefrontLineType type;
+	vec3s vec;
+} WavefrontLine;
+
+/**
+ * @brief A bounding box.
+ */
+typedef struct {
+	vec3s mins, maxs;
+} WavefrontBounds;
+
 #pragma mark - WavefrontModel
 
 /**
@@ -64,18 +90,60 @@ static GLuint findOrAddVertex(Model *self, const Wavefront *obj, const ivec3s in
 }
 
 /**
- * @brief Perform post processing on the given MeshVertex.
+ * @brief JobRangeFunction for parsing the vector lines of the given WavefrontLines.
  */
-static void postProcessVertex(const Vector *vector, ident obj, ident data) {
+static void parseLines(size_t begin, size_t end, ident data) {
+
+	WavefrontLine *line = (WavefrontLine *) data + begin;
+	for (size_t i = begin; i < end; i++, line++) {
 
-	ModelVertex *vertex = obj;
-	Model *model = data;
+		vec3s *vec = &line->vec;
+		if (strncmp("v ", line->line, strlen("v ")) == 0) {
+			if (sscanf(line->line, "v %f %f %f", &vec->x, &vec->y, &vec->z) == 3) {
+				line->type = WavefrontLineVertex;
+			}
+		} else if (strncmp("vt ", line->line, strlen("vt ")) == 0) {
+			if (sscanf(line->line, "vt %f %f", &vec->x, &vec->y) == 2) {
+				line->type = WavefrontLineTexcoord;
+			}
+		} else if (strncmp("vn ", line->line, strlen("vn ")) == 0) {
+			if (sscanf(line->line, "vn %f %f %f", &vec->x, &vec->y, &vec->z) == 3) {
+				line->type = WavefrontLineNormal;
+			}
+		}
+	}
+}
+
+/**
+ * @brief The context of parallel vertex post processing.
+ */
+typedef struct {
+	Model *model;
+	WavefrontBounds *bounds;
+} WavefrontPostProcess;
+
+/**
+ * @brief JobRangeFunction for post processing MeshVertices, accumulating their bounds.
+ */
+static void postProcessVertices(size_t begin, size_t end, ident data) {
 
-	model->mins = glms_vec3_minv(model->mins, vertex->position);
-	model->maxs = glms_vec3_maxv(model->maxs, vertex->position);
-	glms_vec3_normalize(vertex->normal);
+	const WavefrontPostProcess *post = data;
 
-	// TODO: Calculate tangents
+	WavefrontBounds bounds = {
+		.mins = glms_vec3_fill(FLT_MAX),
+		.maxs = glms_vec3_fill(-FLT_MAX)
+	};
+
+	ModelVertex *vertex = VectorElement(post->model->vertices, ModelVertex, begin);
+	for (size_t i = begin; i < end; i++, vertex++) {
+
+		bounds.mins = glms_vec3_minv(bounds.mins, vertex->position);
+		bounds.maxs = glms_vec3_maxv(bounds.maxs, vertex->position);
+
+		vertex->normal = glms_vec3_normalize(vertex->normal);
+	}
+
+	post->bounds[begin / MODEL_PARALLEL_GRAIN] = bounds;
 }
 
 /**
@@ -92,25 +160,31 @@ static void load(Model *self, const uint8_t *bytes, size_t length) {
 
 	memcpy(obj.file, bytes, length);
 
+	JobSystem *jobs = $$(JobSystem, sharedInstance);
+
+	Vector *lines = $(alloc(Vector), initWithSize, sizeof(WavefrontLine));
+
+	for (char *line = strtok(obj.file, "\r\n"); line; line = strtok(NULL, "\r\n")) {
+		$(lines, addElement, &(WavefrontLine) { .line = line });
+	}
+
+	$(jobs, parallelFor, lines->count, MODEL_PARALLEL_GRAIN, parseLines, lines->elements);
+
 	ModelMesh mesh = {
 		.type = GL_TRIANGLES
 	};
 
-	for (char *line = strtok(obj.file, "\r\n"); line; line = strtok(NULL, "\r\n")) {
+	const WavefrontLine *l = lines->elements;
+	for (size_t i = 0; i < lines->count; i++, l++) {
 
-		vec3s vec;
-		if (strncmp("v ", line, strlen("v ")) == 0) {
-			if (sscanf(line, "v %f %f %f", &vec.x, &vec.y, &vec.z) == 3) {
-				$(obj.v, addElement, &vec);
-			}
-		} else if (strncmp("vt ", line, strlen("vt ")) == 0) {
-			if (sscanf(line, "vt %f %f", &vec.x, &vec.y) == 2) {
-				$(obj.vt, addElement, &vec);
-			}
-		} else if (strncmp("vn ", line, strlen("vn ")) == 0) {
-			if (sscanf(line, "vn %f %f %f", &vec.x, &vec.y, &vec.z) == 3) {
-				$(obj.vn, addElement, &vec);
-			}
+		char *line = l->line;
+
+		if (l->type == WavefrontLineVertex) {
+			$(obj.v, addElement, (ident) &l->vec);
+		} else if (l->type == WavefrontLineTexcoord) {
+			$(obj.vt, addElement, (ident) &l->vec);
+		} else if (l->type == WavefrontLineNormal) {
+			$(obj.vn, addElement, (ident) &l->vec);
 		} else if (strncmp("g ", line, strlen("g ")) == 0) {
 			if (mesh.count) {
 				$(self->meshes, addElement, &mesh);
@@ -163,7 +237,23 @@ static void load(Model *self, const uint8_t *bytes, size_t length) {
 
 	$(self->meshes, addElement, &mesh);
 
-	$(self->vertices, enumerateElements, postProcessVertex, self);
+	const WavefrontPostProcess post = {
+		.model = self,
+		.bounds = calloc(self->vertices->count / MODEL_PARALLEL_GRAIN + 1, sizeof(WavefrontBounds))
+	};
+
+	$(jobs, parallelFor, self->vertices->count, MODEL_PARALLEL_GRAIN, postProcessVertices, (ident) &post);
+
+	for (size_t i = 0; i * MODEL_PARALLEL_GRAIN < self->vertices->count; i++) {
+		self->mins = glms_vec3_minv(self->mins, post.bounds[i].mins);
+		self->maxs = glms_vec3_maxv(self->maxs, post.bounds[i].maxs);
+	}
+
+	free(post.bounds);
+
+	$(self, calculateTangents);
+
+	release(lines);
 
 	free(obj.file);
 	release(obj.v);
@@ -82,6 +82,69 @@ START_TEST(initWithData) {
 
 } END_TEST
 
+START_TEST(initWithStorage) {
+
+	const GLfloat vertex[] = { 0.0, 0.0, 0.0, 0.0, 1.0, 0.0 };
+	const BufferStorage storage = MakeBufferStorage(GL_ARRAY_BUFFER, sizeof(vertex), vertex, GL_MAP_WRITE_BIT);
+
+	Buffer *buffer = $(alloc(Buffer), initWithStorage, &storage);
+	if (glBufferStorage == NULL) {
+		ck_assert_ptr_eq(NULL, buffer);
+		return;
+	}
+
+	ck_assert_ptr_ne(NULL, buffer);
+	ck_assert_int_ne(0, buffer->name);
+	ck_assert_int_eq(storage.size, buffer->size);
+	ck_assert_int_eq(GL_NONE, buffer->usage);
+	ck_assert_int_eq(storage.flags, buffer->flags);
+
+	$(buffer, bind, GL_ARRAY_BUFFER);
+
+	GLint immutable;
+	glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_IMMUTABLE_STORAGE, &immutable);
+	ck_assert_int_eq(GL_TRUE, immutable);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(mapRange) {
+
+	const GLfloat vertex[] = { 0.0, 0.0, 0.0, 0.0, 1.0, 0.0 };
+	const BufferData data = MakeBufferData(GL_ARRAY_BUFFER, sizeof(vertex), NULL, GL_STATIC_DRAW);
+
+	Buffer *buffer = $(alloc(Buffer), initWithData, &data);
+	ck_assert_ptr_ne(NULL, buffer);
+
+	GLfloat *mapping = $(buffer, mapRange, GL_ARRAY_BUFFER, 0, sizeof(vertex), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	ck_assert_ptr_ne(NULL, mapping);
+
+	memcpy(mapping, vertex, sizeof(vertex));
+
+	ck_assert_int_eq(true, $(buffer, unmap, GL_ARRAY_BUFFER));
+
+	mapping = $(buffer, mapRange, GL_ARRAY_BUFFER, sizeof(GLfloat) * 3, sizeof(GLfloat) * 3, GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+	ck_assert_ptr_ne(NULL, mapping);
+
+	mapping[1] = 2.0;
+
+	$(buffer, flushMappedRange, GL_ARRAY_BUFFER, sizeof(GLfloat), sizeof(GLfloat));
+
+	ck_assert_int_eq(true, $(buffer, unmap, GL_ARRAY_BUFFER));
+
+	$(buffer, bind, GL_ARRAY_BUFFER);
+
+	GLfloat readback[6];
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(readback), readback);
+
+	ck_assert(readback[1] == 0.0);
+	ck_assert(readback[4] == 2.0);
+
+	release(buffer);
+
+} END_TEST
+
 START_TEST(unbind) {
 
 	Buffer *buffer = $(alloc(Buffer), init);
@@ -130,6 +193,409 @@ START_TEST(writeSubData) {
 
 } END_TEST
 
+/**
+ * @brief The count of frames after which the mock GPU completes the commands issued in a frame.
+ */
+#define MOCK_LATENCY 2
+
+/**
+ * @brief A mock GPU command, which completes MOCK_LATENCY frames after it is issued, or once a
+ * fence issued after it has been waited on.
+ */
+typedef struct {
+	uint64_t time;
+	uint64_t sequence;
+} MockCommand;
+
+/**
+ * @brief A mock GPU read of a Buffer's data store.
+ */
+typedef struct {
+	GLuint name;
+	GLuint storage;
+	MockCommand command;
+} MockRead;
+
+/**
+ * @brief The mock GL layer, which tracks GPU reads and the CPU writes that may collide with them.
+ */
+static struct {
+	uint64_t time;
+	uint64_t sequence, signaled;
+	GLuint names;
+	GLuint storages;
+	GLuint storage[64];
+	GLuint uniformBuffer, copyReadBuffer, copyWriteBuffer;
+	MockRead reads[2048];
+	size_t count;
+	MockCommand fences[1024];
+	size_t numFences;
+	size_t writes, hazards;
+	GLintptr offset;
+	GLsizeiptr size, uploaded;
+	GLubyte mapping[256];
+} mock;
+
+static MockCommand mockCommand(void) {
+	return (MockCommand) {
+		.time = mock.time,
+		.sequence = ++mock.sequence
+	};
+}
+
+static _Bool mockIsComplete(const MockCommand *command) {
+	return mock.time >= command->time + MOCK_LATENCY || command->sequence <= mock.signaled;
+}
+
+static GLuint *mockBinding(GLenum target) {
+	switch (target) {
+		case GL_COPY_READ_BUFFER:
+			return &mock.copyReadBuffer;
+		case GL_COPY_WRITE_BUFFER:
+			return &mock.copyWriteBuffer;
+		default:
+			ck_assert_int_eq(GL_UNIFORM_BUFFER, target);
+			return &mock.uniformBuffer;
+	}
+}
+
+static void mockRead(GLuint name) {
+
+	ck_assert_int_lt(mock.count, lengthof(mock.reads));
+
+	mock.reads[mock.count++] = (MockRead) {
+		.name = name,
+		.storage = mock.storage[name],
+		.command = mockCommand()
+	};
+}
+
+static void mockWrite(GLenum target) {
+
+	const GLuint name = *mockBinding(target);
+
+	for (size_t i = 0; i < mock.count; i++) {
+		const MockRead *read = &mock.reads[i];
+		if (read->name == name && read->storage == mock.storage[name] && !mockIsComplete(&read->command)) {
+			mock.hazards++;
+		}
+	}
+
+	mock.writes++;
+}
+
+static void mockDraw(void) {
+	mockRead(mock.uniformBuffer);
+}
+
+static void mockGenBuffers(GLsizei n, GLuint *buffers) {
+	for (GLsizei i = 0; i < n; i++) {
+		buffers[i] = ++mock.names;
+		ck_assert_int_lt(buffers[i], lengthof(mock.storage));
+	}
+}
+
+static void mockDeleteBuffers(GLsizei n, const GLuint *buffers) {
+
+}
+
+static void mockBindBuffer(GLenum target, GLuint buffer) {
+	*mockBinding(target) = buffer;
+}
+
+static void mockBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+	mock.storage[*mockBinding(target)] = ++mock.storages;
+}
+
+static void mockBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+	mockWrite(target);
+
+	mock.offset = offset;
+	mock.size = size;
+	mock.uploaded += size;
+}
+
+static void mockCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+	ck_assert_int_ne(0, *mockBinding(readTarget));
+	ck_assert_int_ne(0, *mockBinding(writeTarget));
+
+	mockRead(*mockBinding(readTarget));
+}
+
+static void *mockMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+	mockWrite(target);
+	return mock.mapping;
+}
+
+static GLboolean mockUnmapBuffer(GLenum target) {
+	return GL_TRUE;
+}
+
+static GLsync mockFenceSync(GLenum condition, GLbitfield flags) {
+
+	ck_assert_int_lt(mock.numFences, lengthof(mock.fences));
+
+	mock.fences[mock.numFences++] = mockCommand();
+	return (GLsync) (uintptr_t) mock.numFences;
+}
+
+static GLenum mockClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+
+	const MockCommand *fence = &mock.fences[(uintptr_t) sync - 1];
+	if (mockIsComplete(fence)) {
+		return GL_ALREADY_SIGNALED;
+	} else if (timeout == 0) {
+		return GL_TIMEOUT_EXPIRED;
+	}
+
+	mock.signaled = max(mock.signaled, fence->sequence);
+	return GL_CONDITION_SATISFIED;
+}
+
+static void mockDeleteSync(GLsync sync) {
+
+}
+
+static struct {
+	PFNGLCREATEBUFFERSPROC createBuffers;
+	PFNGLGENBUFFERSPROC genBuffers;
+	PFNGLDELETEBUFFERSPROC deleteBuffers;
+	PFNGLBINDBUFFERPROC bindBuffer;
+	PFNGLBUFFERDATAPROC bufferData;
+	PFNGLBUFFERSUBDATAPROC bufferSubData;
+	PFNGLCOPYBUFFERSUBDATAPROC copyBufferSubData;
+	PFNGLMAPBUFFERRANGEPROC mapBufferRange;
+	PFNGLUNMAPBUFFERPROC unmapBuffer;
+	PFNGLFENCESYNCPROC fenceSync;
+	PFNGLCLIENTWAITSYNCPROC clientWaitSync;
+	PFNGLDELETESYNCPROC deleteSync;
+} gl;
+
+static void setupMock(void) {
+
+	memset(&mock, 0, sizeof(mock));
+
+	gl.createBuffers = glad_glCreateBuffers;
+	gl.genBuffers = glad_glGenBuffers;
+	gl.deleteBuffers = glad_glDeleteBuffers;
+	gl.bindBuffer = glad_glBindBuffer;
+	gl.bufferData = glad_glBufferData;
+	gl.bufferSubData = glad_glBufferSubData;
+	gl.copyBufferSubData = glad_glCopyBufferSubData;
+	gl.mapBufferRange = glad_glMapBufferRange;
+	gl.unmapBuffer = glad_glUnmapBuffer;
+	gl.fenceSync = glad_glFenceSync;
+	gl.clientWaitSync = glad_glClientWaitSync;
+	gl.deleteSync = glad_glDeleteSync;
+
+	// the mock layer models the bind-to-edit path
+	glad_glCreateBuffers = NULL;
+	glad_glGenBuffers = mockGenBuffers;
+	glad_glDeleteBuffers = mockDeleteBuffers;
+	glad_glBindBuffer = mockBindBuffer;
+	glad_glBufferData = mockBufferData;
+	glad_glBufferSubData = mockBufferSubData;
+	glad_glCopyBufferSubData = mockCopyBufferSubData;
+	glad_glMapBufferRange = mockMapBufferRange;
+	glad_glUnmapBuffer = mockUnmapBuffer;
+	glad_glFenceSync = mockFenceSync;
+	glad_glClientWaitSync = mockClientWaitSync;
+	glad_glDeleteSync = mockDeleteSync;
+}
+
+static void teardownMock(void) {
+
+	glad_glCreateBuffers = gl.createBuffers;
+	glad_glGenBuffers = gl.genBuffers;
+	glad_glDeleteBuffers = gl.deleteBuffers;
+	glad_glBindBuffer = gl.bindBuffer;
+	glad_glBufferData = gl.bufferData;
+	glad_glBufferSubData = gl.bufferSubData;
+	glad_glCopyBufferSubData = gl.copyBufferSubData;
+	glad_glMapBufferRange = gl.mapBufferRange;
+	glad_glUnmapBuffer = gl.unmapBuffer;
+	glad_glFenceSync = gl.fenceSync;
+	glad_glClientWaitSync = gl.clientWaitSync;
+	glad_glDeleteSync = gl.deleteSync;
+}
+
+/**
+ * @brief Writes to and draws with a Buffer using the given strategy for a number of frames.
+ * @return The Buffer.
+ */
+static Buffer *updateFrames(BufferUpdateStrategy strategy, size_t generations) {
+
+	const GLubyte data[16] = { 0 };
+
+	Buffer *buffer = $(alloc(Buffer), initWithData, &MakeBufferData(GL_UNIFORM_BUFFER, 256, NULL, GL_DYNAMIC_DRAW));
+	ck_assert_ptr_ne(NULL, buffer);
+
+	$(buffer, setUpdateStrategy, GL_UNIFORM_BUFFER, strategy, generations);
+
+	for (int frame = 0; frame < 100; frame++) {
+
+		for (int i = 0; i < 3; i++) {
+			$(buffer, writeSubData, &MakeBufferSubData(GL_UNIFORM_BUFFER, (frame * 16 + i * 64) % 256, sizeof(data), data));
+			ck_assert_int_eq(buffer->name, mock.uniformBuffer);
+
+			mockDraw();
+		}
+
+		mock.time++;
+	}
+
+	ck_assert_int_eq(300, mock.writes);
+
+	return buffer;
+}
+
+START_TEST(updateSubData) {
+
+	Buffer *buffer = updateFrames(BufferUpdateSubData, 0);
+
+	ck_assert_int_gt(mock.hazards, 0);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(updateOrphan) {
+
+	Buffer *buffer = updateFrames(BufferUpdateOrphan, 0);
+
+	ck_assert_int_eq(0, mock.hazards);
+	ck_assert_int_eq(1, mock.names);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(updateRoundRobin) {
+
+	Buffer *buffer = updateFrames(BufferUpdateRoundRobin, 9);
+
+	ck_assert_int_eq(0, mock.hazards);
+	ck_assert_int_eq(0, buffer->stalls);
+	ck_assert_int_eq(9, mock.names);
+
+	release(buffer);
+
+	memset(&mock, 0, sizeof(mock));
+
+	buffer = updateFrames(BufferUpdateRoundRobin, 2);
+
+	ck_assert_int_eq(0, mock.hazards);
+	ck_assert_int_gt(buffer->stalls, 0);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(updateUnsynchronized) {
+
+	Buffer *buffer = updateFrames(BufferUpdateUnsynchronized, BUFFER_DEFAULT_GENERATIONS);
+
+	ck_assert_int_eq(0, mock.hazards);
+	ck_assert_int_gt(buffer->stalls, 0);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(commit) {
+
+	Buffer *buffer = $(alloc(Buffer), initWithShadow, &(const BufferData) {
+		.target = GL_UNIFORM_BUFFER,
+		.size = 0x10000,
+		.usage = GL_DYNAMIC_DRAW
+	});
+
+	ck_assert_ptr_ne(NULL, buffer);
+	ck_assert_ptr_ne(NULL, buffer->shadow);
+	ck_assert_int_eq(0, $(buffer, commit, GL_UNIFORM_BUFFER));
+
+	const GLubyte data[32] = { 1, 2, 3, 4 };
+
+	$(buffer, writeShadow, 100, 4, data);
+	$(buffer, writeShadow, 104, 4, data);
+	$(buffer, writeShadow, 98, 4, data);
+	$(buffer, writeShadow, 0x8000, 8, data);
+	$(buffer, writeShadow, 0xc000, 16, data);
+	$(buffer, writeShadow, 0xc008, 16, data);
+
+	ck_assert_int_eq(3, buffer->dirty->count);
+	ck_assert_int_eq(98, VectorElement(buffer->dirty, BufferRange, 0)->offset);
+	ck_assert_int_eq(10, VectorElement(buffer->dirty, BufferRange, 0)->size);
+	ck_assert_int_eq(0xc000, VectorElement(buffer->dirty, BufferRange, 2)->offset);
+	ck_assert_int_eq(24, VectorElement(buffer->dirty, BufferRange, 2)->size);
+	ck_assert_int_eq(1, buffer->shadow[0xc008]);
+
+	ck_assert_int_eq(3, $(buffer, commit, GL_UNIFORM_BUFFER));
+	ck_assert_int_eq(3, mock.writes);
+	ck_assert_int_eq(42, mock.uploaded);
+	ck_assert_int_eq(0, buffer->dirty->count);
+
+	$(buffer, writeShadow, 0, 8, data);
+	$(buffer, writeShadow, 512, 8, data);
+
+	ck_assert_int_eq(1, $(buffer, commit, GL_UNIFORM_BUFFER));
+	ck_assert_int_eq(0, mock.offset);
+	ck_assert_int_eq(520, mock.size);
+
+	static GLubyte block[0x8000];
+
+	$(buffer, writeShadow, 0, 0x7c00, block);
+	$(buffer, writeShadow, 0x8000, 0x8000, block);
+
+	ck_assert_int_eq(2, buffer->dirty->count);
+	ck_assert_int_eq(1, $(buffer, commit, GL_UNIFORM_BUFFER));
+	ck_assert_int_eq(0, mock.offset);
+	ck_assert_int_eq(buffer->size, mock.size);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(commitStrategy) {
+
+	Buffer *buffer = $(alloc(Buffer), initWithShadow, &(const BufferData) {
+		.target = GL_UNIFORM_BUFFER,
+		.size = 0x10000,
+		.usage = GL_DYNAMIC_DRAW
+	});
+
+	ck_assert_ptr_ne(NULL, buffer);
+
+	const GLubyte data[8] = { 1, 2, 3, 4 };
+
+	$(buffer, setUpdateStrategy, GL_UNIFORM_BUFFER, BufferUpdateOrphan, 0);
+
+	$(buffer, writeShadow, 0x1000, 8, data);
+	$(buffer, writeShadow, 0x8000, 8, data);
+
+	ck_assert_int_eq(1, $(buffer, commit, GL_UNIFORM_BUFFER));
+	ck_assert_int_eq(1, mock.writes);
+	ck_assert_int_eq(0, mock.offset);
+	ck_assert_int_eq(buffer->size, mock.size);
+
+	$(buffer, setUpdateStrategy, GL_UNIFORM_BUFFER, BufferUpdateRoundRobin, BUFFER_DEFAULT_GENERATIONS);
+
+	$(buffer, writeShadow, 0x1000, 8, data);
+	$(buffer, writeShadow, 0x8000, 8, data);
+
+	const GLuint name = buffer->name;
+
+	ck_assert_int_eq(1, $(buffer, commit, GL_UNIFORM_BUFFER));
+	ck_assert_int_eq(2, mock.writes);
+	ck_assert_int_eq(0x1000, mock.offset);
+	ck_assert_int_eq(0x7008, mock.size);
+	ck_assert_int_ne(name, buffer->name);
+	ck_assert_int_eq(1, buffer->generation);
+
+	release(buffer);
+
+} END_TEST
+
 int main(int argc, char **argv) {
 
 	TCase *tcase = tcase_create("Buffer");
@@ -139,12 +605,25 @@ int main(int argc, char **argv) {
 	tcase_add_test(tcase, init);
 	tcase_add_test(tcase, initWithData0);
 	tcase_add_test(tcase, initWithData);
+	tcase_add_test(tcase, initWithStorage);
+	tcase_add_test(tcase, mapRange);
 	tcase_add_test(tcase, unbind);
 	tcase_add_test(tcase, writeData);
 	tcase_add_test(tcase, writeSubData);
 
+	TCase *mock = tcase_create("BufferUpdateStrategy");
+	tcase_add_checked_fixture(mock, setupMock, teardownMock);
+
+	tcase_add_test(mock, updateSubData);
+	tcase_add_test(mock, updateOrphan);
+	tcase_add_test(mock, updateRoundRobin);
+	tcase_add_test(mock, updateUnsynchronized);
+	tcase_add_test(mock, commit);
+	tcase_add_test(mock, commitStrategy);
+
 	Suite *suite = suite_create("Buffer");
 	suite_add_tcase(suite, tcase);
+	suite_add_tcase(suite, mock);
 
 	SRunner *runner = srunner_create(suite);
 
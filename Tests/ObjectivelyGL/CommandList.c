@@ -0,0 +1,123 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static int sum;
+
+static void setup(void) {
+	sum = 0;
+}
+
+static void teardown(void) {
+
+}
+
+static void command(ident data) {
+	sum += (int) (intptr_t) data;
+}
+
+static void commandWithData(ident data) {
+	sum += *(int *) data;
+}
+
+START_TEST(append) {
+
+	CommandList *list = $(alloc(CommandList), init);
+	ck_assert_ptr_ne(NULL, list);
+
+	for (int i = 1; i <= 10; i++) {
+		$(list, append, command, (ident) (intptr_t) i);
+	}
+
+	ck_assert_int_eq(10, $(list, count));
+
+	$(list, execute);
+	ck_assert_int_eq(55, sum);
+
+	$(list, execute);
+	ck_assert_int_eq(110, sum);
+
+	release(list);
+
+} END_TEST
+
+START_TEST(appendData) {
+
+	CommandList *list = $(alloc(CommandList), init);
+	ck_assert_ptr_ne(NULL, list);
+
+	for (int i = 1; i <= 10; i++) {
+		$(list, appendData, commandWithData, &i, sizeof(i));
+	}
+
+	ck_assert_int_eq(10, $(list, count));
+
+	$(list, execute);
+	ck_assert_int_eq(55, sum);
+	ck_assert_int_le(list->started, list->finished);
+
+	release(list);
+
+} END_TEST
+
+START_TEST(reset) {
+
+	CommandList *list = $(alloc(CommandList), init);
+	ck_assert_ptr_ne(NULL, list);
+
+	$(list, append, command, (ident) 1);
+	$(list, appendData, commandWithData, &(int) { 2 }, sizeof(int));
+
+	$(list, reset);
+	ck_assert_int_eq(0, $(list, count));
+
+	$(list, execute);
+	ck_assert_int_eq(0, sum);
+
+	release(list);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("CommandList");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, append);
+	tcase_add_test(tcase, appendData);
+	tcase_add_test(tcase, reset);
+
+	Suite *suite = suite_create("CommandList");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,216 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+
+#include <unistd.h>
+
+#include "Test.h"
+
+static int sum;
+
+static void setup(void) {
+	sum = 0;
+}
+
+static void teardown(void) {
+
+}
+
+static void command(ident data) {
+	sum++;
+}
+
+static void otherCommand(ident data) {
+	sum += 10;
+}
+
+START_TEST(record) {
+
+	CommandProfiler *profiler = $(alloc(CommandProfiler), initWithCapacity, 4);
+	ck_assert_ptr_ne(NULL, profiler);
+
+	$(profiler, label, command, "command");
+
+	for (uint64_t i = 1; i <= 100; i++) {
+		const CommandSample sample = {
+			.enqueued = i * 1000,
+			.dequeued = i * 1000 + i * 10,
+			.started = i * 1000 + i * 10,
+			.finished = i * 1000 + i * 10 + i * 100,
+			.depth = i
+		};
+		$(profiler, record, command, &sample);
+	}
+
+	$(profiler, record, otherCommand, &(CommandSample) { 0, 0, 0, 1, 0 });
+
+	CommandProfileStats stats = $(profiler, stats, "command");
+	ck_assert_int_eq(100, stats.count);
+	ck_assert_int_eq(1000, stats.waitMax);
+	ck_assert_int_eq(10000, stats.executeMax);
+	ck_assert_int_eq(505000, stats.executeTime);
+
+	ck_assert(stats.waitP50 >= 470 && stats.waitP50 <= 530);
+	ck_assert(stats.waitP99 >= 940 && stats.waitP99 <= 1000);
+	ck_assert(stats.executeP95 >= 9000 && stats.executeP95 <= 10000);
+	ck_assert(stats.waitP50 <= stats.waitP95 && stats.waitP95 <= stats.waitP99);
+	ck_assert(stats.throughput > 0.0);
+
+	stats = $(profiler, stats, "unlabeled");
+	ck_assert_int_eq(1, stats.count);
+
+	stats = $(profiler, stats, NULL);
+	ck_assert_int_eq(101, stats.count);
+
+	stats = $(profiler, stats, "missing");
+	ck_assert_int_eq(0, stats.count);
+
+	CommandDepthSample samples[8];
+	ck_assert_int_eq(4, $(profiler, depthSeries, samples, lengthof(samples)));
+	ck_assert_int_eq(98, samples[0].depth);
+	ck_assert_int_eq(100, samples[2].depth);
+	ck_assert_int_eq(0, samples[3].depth);
+
+	ck_assert_int_eq(2, $(profiler, depthSeries, samples, 2));
+	ck_assert_int_eq(100, samples[0].depth);
+	ck_assert_int_eq(0, samples[1].depth);
+
+	release(profiler);
+
+} END_TEST
+
+START_TEST(profile) {
+
+	CommandQueue *queue = $(alloc(CommandQueue), init);
+	ck_assert_ptr_ne(NULL, queue);
+
+	CommandProfiler *profiler = $(alloc(CommandProfiler), init);
+	ck_assert_ptr_ne(NULL, profiler);
+
+	$(profiler, label, command, "command");
+	$(queue, profile, profiler);
+
+	for (int i = 0; i < 10; i++) {
+		$(queue, enqueue, command, NULL);
+	}
+
+	$(queue, enqueue, otherCommand, NULL);
+
+	CommandList *frame = $(queue, beginFrame);
+	$(frame, append, command, NULL);
+	$(frame, append, command, NULL);
+	$(queue, endFrame);
+
+	$(queue, flush);
+	$(queue, profile, NULL);
+
+	$(queue, enqueue, command, NULL);
+	$(queue, flush);
+
+	ck_assert_int_eq(23, sum);
+
+	CommandProfileStats stats = $(profiler, stats, "command");
+	ck_assert_int_eq(10, stats.count);
+
+	stats = $(profiler, stats, "frame");
+	ck_assert_int_eq(1, stats.count);
+
+	stats = $(profiler, stats, "unlabeled");
+	ck_assert_int_eq(1, stats.count);
+
+	stats = $(profiler, stats, NULL);
+	ck_assert_int_eq(12, stats.count);
+	ck_assert(stats.executeTime > 0);
+
+	CommandDepthSample samples[12];
+	ck_assert_int_eq(12, $(profiler, depthSeries, samples, lengthof(samples)));
+	ck_assert_int_eq(12, samples[0].depth);
+	ck_assert_int_eq(1, samples[11].depth);
+
+	for (size_t i = 1; i < lengthof(samples); i++) {
+		ck_assert(samples[i].time >= samples[i - 1].time);
+	}
+
+	release(profiler);
+	release(queue);
+
+} END_TEST
+
+START_TEST(writeChromeTrace) {
+
+	CommandProfiler *profiler = $(alloc(CommandProfiler), init);
+	ck_assert_ptr_ne(NULL, profiler);
+
+	$(profiler, label, command, "\"quoted\"");
+
+	$(profiler, record, command, &(CommandSample) { 1000, 2000, 2000, 5000, 3 });
+	$(profiler, record, otherCommand, &(CommandSample) { 1000, 6000, 6000, 7000, 2 });
+
+	char path[] = "/tmp/CommandProfiler.XXXXXX";
+	const int fd = mkstemp(path);
+	ck_assert_int_ne(-1, fd);
+	close(fd);
+
+	ck_assert_int_eq(true, $(profiler, writeChromeTrace, path));
+
+	char json[1024] = "";
+
+	FILE *file = fopen(path, "r");
+	ck_assert_ptr_ne(NULL, file);
+	ck_assert(fread(json, 1, sizeof(json) - 1, file) > 0);
+	fclose(file);
+
+	unlink(path);
+
+	ck_assert(strstr(json, "\"traceEvents\""));
+	ck_assert(strstr(json, "\"name\":\"\\\"quoted\\\"\""));
+	ck_assert(strstr(json, "\"name\":\"unlabeled\""));
+	ck_assert(strstr(json, "\"ts\":2.000,\"dur\":3.000,\"args\":{\"wait\":1.000}"));
+	ck_assert(strstr(json, "\"args\":{\"depth\":2}"));
+
+	release(profiler);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("CommandProfiler");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, record);
+	tcase_add_test(tcase, profile);
+	tcase_add_test(tcase, writeChromeTrace);
+
+	Suite *suite = suite_create("CommandProfiler");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
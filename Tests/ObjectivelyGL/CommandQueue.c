@@ -21,6 +21,9 @@
  * 3. This notice may not be removed or altered from any source distribution.
  */
 
+#include <stdlib.h>
+#include <unistd.h>
+
 #include "Test.h"
 
 #include <Objectively/Thread.h>
@@ -43,9 +46,10 @@ static void command(ident data) {
 #if 0
 static void printq(const CommandQueue *q) {
 
-	const Command *cmd = q->commands;
+	const CommandLane *lane = &q->lanes[CommandPriorityNormal];
+	const Command *cmd = lane->commands;
 	for (size_t i = 0; i < q->capacity; i++, cmd++) {
-		printf("%d %s\n", (int) cmd->data, i == q->pending ? "P" : i == q->free ? "F" : "");
+		printf("%d %s\n", (int) cmd->data, i == lane->pending ? "P" : i == lane->free ? "F" : "");
 	}
 }
 #endif
@@ -84,6 +88,27 @@ START_TEST(dequeue) {
 	release(q);
 } END_TEST
 
+START_TEST(dequeueBatch) {
+
+	CommandQueue *q = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyGrow, 8);
+	ck_assert_ptr_ne(NULL, q);
+
+	for (size_t i = 0; i < 1000; i++) {
+		ck_assert_int_eq(true, $(q, enqueue, command, (ident) i));
+	}
+
+	ck_assert_int_eq(10, $(q, dequeueBatch, 10));
+	ck_assert_int_eq(990, q->count);
+
+	ck_assert_int_eq(990, $(q, dequeueBatch, SIZE_MAX));
+	ck_assert_int_eq(0, $(q, dequeueBatch, SIZE_MAX));
+
+	ck_assert_int_eq(1000, criticalSection);
+	ck_assert_int_eq(true, $(q, isEmpty));
+
+	release(q);
+} END_TEST
+
 START_TEST(flush) {
 
 	CommandQueue *q = $(alloc(CommandQueue), init);
@@ -110,10 +135,12 @@ START_TEST(resize) {
 		$(q, enqueue, command, (ident) i);
 	}
 
+	const CommandLane *lane = &q->lanes[CommandPriorityNormal];
+
 	$(q, resize, 16);
 
-	ck_assert_int_eq(0, q->pending);
-	ck_assert_int_eq(8, q->free);
+	ck_assert_int_eq(0, lane->pending);
+	ck_assert_int_eq(8, lane->free);
 	ck_assert_int_eq(8, q->count);
 
 	$(q, dequeue);
@@ -121,14 +148,378 @@ START_TEST(resize) {
 
 	$(q, resize, 8);
 
-	ck_assert_int_eq(0, q->pending);
-	ck_assert_int_eq(6, q->free);
+	ck_assert_int_eq(0, lane->pending);
+	ck_assert_int_eq(6, lane->free);
 	ck_assert_int_eq(6, q->count);
 
 	//printq(q);
 
 } END_TEST
 
+START_TEST(policyBlock) {
+
+	CommandQueue *q = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyBlock, 4);
+	ck_assert_ptr_ne(NULL, q);
+
+	$(q, start);
+
+	for (size_t i = 0; i < q->capacity * 4; i++) {
+		ck_assert_int_eq(true, $(q, enqueue, command, NULL));
+	}
+
+	$(q, waitUntilEmpty);
+	$(q, stop);
+
+	ck_assert_int_eq(16, criticalSection);
+	ck_assert_int_eq(4, q->capacity);
+
+	const CommandQueueStats stats = $(q, stats);
+	ck_assert_int_eq(16, stats.enqueued);
+	ck_assert_int_eq(16, stats.dequeued);
+	ck_assert_int_eq(0, stats.rejected);
+	ck_assert_int_le(stats.highWaterMark, 4);
+
+	release(q);
+
+} END_TEST
+
+static int produced;
+
+static ident producer(Thread *thread) {
+
+	CommandQueue *q = thread->data;
+
+	$(q, enqueue, command, NULL);
+	__atomic_store_n(&produced, 1, __ATOMIC_SEQ_CST);
+
+	return NULL;
+}
+
+static void awaitProducer(ident data) {
+
+	for (int i = 0; i < 1000 && __atomic_load_n(&produced, __ATOMIC_SEQ_CST) == 0; i++) {
+		usleep(1000);
+	}
+
+	*(int *) data = __atomic_load_n(&produced, __ATOMIC_SEQ_CST);
+}
+
+START_TEST(policyBlockBatch) {
+
+	CommandQueue *q = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyBlock, 4);
+	ck_assert_ptr_ne(NULL, q);
+
+	produced = 0;
+
+	int unblocked = 0;
+	$(q, enqueue, awaitProducer, &unblocked);
+
+	for (size_t i = 1; i < q->capacity; i++) {
+		$(q, enqueue, command, NULL);
+	}
+
+	Thread *thread = $(alloc(Thread), initWithFunction, producer, q);
+	$(thread, start);
+
+	usleep(10000);
+
+	ck_assert_int_eq(4, $(q, dequeueBatch, 4));
+	ck_assert_int_eq(1, unblocked);
+
+	$(thread, join, NULL);
+	release(thread);
+
+	ck_assert_int_eq(true, $(q, dequeue));
+	ck_assert_int_eq(4, criticalSection);
+
+	release(q);
+
+} END_TEST
+
+START_TEST(policyFail) {
+
+	CommandQueue *q = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyFail, 4);
+	ck_assert_ptr_ne(NULL, q);
+
+	for (size_t i = 0; i < 4; i++) {
+		ck_assert_int_eq(true, $(q, enqueue, command, NULL));
+	}
+
+	ck_assert_int_eq(false, $(q, enqueue, command, NULL));
+
+	const CommandQueueStats stats = $(q, stats);
+	ck_assert_int_eq(4, stats.enqueued);
+	ck_assert_int_eq(1, stats.rejected);
+	ck_assert_int_eq(4, stats.highWaterMark);
+
+	release(q);
+
+} END_TEST
+
+START_TEST(policyGrow) {
+
+	CommandQueue *q = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyGrow, 4);
+	ck_assert_ptr_ne(NULL, q);
+
+	$(q, enqueue, command, NULL);
+	$(q, dequeue);
+
+	for (size_t i = 0; i < 12; i++) {
+		ck_assert_int_eq(true, $(q, enqueue, command, NULL));
+	}
+
+	ck_assert_int_eq(16, q->capacity);
+	ck_assert_int_eq(12, q->count);
+
+	const CommandQueueStats stats = $(q, stats);
+	ck_assert_int_eq(2, stats.grown);
+	ck_assert_int_eq(12, stats.highWaterMark);
+
+	$(q, flush);
+
+	ck_assert_int_eq(13, criticalSection);
+	ck_assert_int_eq(true, $(q, isEmpty));
+
+	release(q);
+
+} END_TEST
+
+static void notification(ident data) {
+	*(int *) data = criticalSection;
+}
+
+START_TEST(fence) {
+
+	CommandQueue *q = $(alloc(CommandQueue), init);
+	ck_assert_ptr_ne(NULL, q);
+
+	CommandFence a, b;
+	ck_assert_int_eq(true, $(q, enqueueWithFence, command, NULL, &a));
+	ck_assert_int_eq(true, $(q, enqueueWithFence, command, NULL, &b));
+	ck_assert_int_lt(a.value, b.value);
+
+	ck_assert_int_eq(false, $(q, isFenceComplete, a));
+	ck_assert_int_eq(false, $(q, isFenceComplete, b));
+
+	int notified = -1;
+	$(q, notify, a, notification, &notified);
+
+	$(q, dequeue);
+
+	ck_assert_int_eq(true, $(q, isFenceComplete, a));
+	ck_assert_int_eq(false, $(q, isFenceComplete, b));
+	ck_assert_int_eq(1, notified);
+
+	$(q, start);
+	$(q, waitForFence, b);
+
+	ck_assert_int_eq(true, $(q, isFenceComplete, b));
+	ck_assert_int_eq(2, criticalSection);
+
+	notified = -1;
+	$(q, notify, b, notification, &notified);
+
+	$(q, waitUntilEmpty);
+	$(q, stop);
+
+	ck_assert_int_eq(2, notified);
+
+	release(q);
+
+} END_TEST
+
+static int order[12];
+
+static void priorityCommand(ident data) {
+	order[criticalSection++] = (int) (intptr_t) data;
+}
+
+static void escalate(ident data) {
+	priorityCommand((ident) CommandPriorityLow);
+	$((CommandQueue *) data, enqueueWithPriority, CommandPriorityHigh, priorityCommand, (ident) CommandPriorityHigh, NULL);
+}
+
+START_TEST(priority) {
+
+	CommandQueue *q = $(alloc(CommandQueue), initWithCapacity, 8);
+	ck_assert_ptr_ne(NULL, q);
+
+	q->budget = 2;
+
+	for (intptr_t i = 0; i < 4; i++) {
+		ck_assert_int_eq(true, $(q, enqueueWithPriority, CommandPriorityLow, priorityCommand, (ident) CommandPriorityLow, NULL));
+		ck_assert_int_eq(true, $(q, enqueueWithPriority, CommandPriorityNormal, priorityCommand, (ident) CommandPriorityNormal, NULL));
+		ck_assert_int_eq(true, $(q, enqueueWithPriority, CommandPriorityHigh, priorityCommand, (ident) CommandPriorityHigh, NULL));
+	}
+
+	CommandQueueStats stats = $(q, stats);
+	ck_assert_int_eq(12, stats.enqueued);
+	for (int i = 0; i < CommandPriorityCount; i++) {
+		ck_assert_int_eq(4, stats.lanes[i].depth);
+		ck_assert_int_eq(4, stats.lanes[i].enqueued);
+	}
+
+	CommandFence fence;
+	ck_assert_int_eq(true, $(q, enqueueWithPriority, CommandPriorityLow, command, NULL, &fence));
+	ck_assert_int_eq(CommandPriorityLow, fence.priority);
+	ck_assert_int_eq(5, fence.value);
+
+	ck_assert_int_eq(true, $(q, dequeue));
+	ck_assert_int_eq(CommandPriorityHigh, order[0]);
+	ck_assert_int_eq(false, $(q, isFenceComplete, fence));
+
+	ck_assert_int_eq(12, $(q, dequeueBatch, SIZE_MAX));
+	ck_assert_int_eq(true, $(q, isFenceComplete, fence));
+
+	for (int i = 0; i < 12; i++) {
+		ck_assert_int_eq(i / 4, order[i]);
+	}
+
+	stats = $(q, stats);
+	for (int i = 0; i < CommandPriorityCount; i++) {
+		ck_assert_int_eq(0, stats.lanes[i].depth);
+		ck_assert_int_eq(i == CommandPriorityLow ? 5 : 4, stats.lanes[i].highWaterMark);
+		ck_assert_int_le(stats.lanes[i].waitTime / stats.lanes[i].dequeued, stats.lanes[i].waitTimeMax);
+	}
+
+	ck_assert_int_eq(5, stats.lanes[CommandPriorityLow].dequeued);
+
+	criticalSection = 0;
+
+	ck_assert_int_eq(true, $(q, enqueueWithPriority, CommandPriorityLow, escalate, q, NULL));
+	for (int i = 0; i < 3; i++) {
+		ck_assert_int_eq(true, $(q, enqueueWithPriority, CommandPriorityLow, priorityCommand, (ident) CommandPriorityLow, NULL));
+	}
+
+	ck_assert_int_eq(5, $(q, dequeueBatch, SIZE_MAX));
+
+	ck_assert_int_eq(CommandPriorityLow, order[0]);
+	ck_assert_int_eq(CommandPriorityLow, order[1]);
+	ck_assert_int_eq(CommandPriorityHigh, order[2]);
+	ck_assert_int_eq(CommandPriorityLow, order[3]);
+	ck_assert_int_eq(CommandPriorityLow, order[4]);
+
+	release(q);
+
+} END_TEST
+
+static void frameCommand(ident data) {
+	criticalSection += *(int *) data;
+}
+
+START_TEST(frames) {
+
+	CommandQueue *q = $(alloc(CommandQueue), init);
+	ck_assert_ptr_ne(NULL, q);
+	ck_assert_int_eq(2, q->frameDepth);
+
+	$(q, start);
+
+	for (int i = 0; i < 100; i++) {
+
+		CommandList *frame = $(q, beginFrame);
+		ck_assert_ptr_ne(NULL, frame);
+		ck_assert_int_eq(i, frame->frame);
+		ck_assert_int_eq(0, $(frame, count));
+
+		ck_assert_int_le(q->framesInFlight, q->frameDepth - 1);
+
+		$(frame, appendData, frameCommand, &(int) { 1 }, sizeof(int));
+		$(frame, appendData, frameCommand, &(int) { 2 }, sizeof(int));
+
+		ck_assert_int_eq(true, $(q, endFrame));
+	}
+
+	$(q, waitForFrames);
+	$(q, stop);
+
+	ck_assert_int_eq(300, criticalSection);
+	ck_assert_int_eq(0, q->framesInFlight);
+
+	const CommandQueueStats stats = $(q, stats);
+	ck_assert_int_eq(100, stats.frames);
+	ck_assert_int_le(stats.frameLatency, stats.frameLatencyMax);
+
+	release(q);
+
+} END_TEST
+
+static uint64_t latencies[1000];
+
+static void latencyCommand(ident data) {
+	latencies[criticalSection++] = CommandTime() - (uint64_t) (uintptr_t) data;
+}
+
+static int compareLatencies(const void *a, const void *b) {
+	const uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+	return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/**
+ * @brief Measures enqueue-to-execute latency for Commands enqueued to an idle CommandQueue.
+ */
+static void benchmark(const char *name, size_t spinCount, size_t yieldCount) {
+
+	CommandQueue *q = $(alloc(CommandQueue), init);
+	ck_assert_ptr_ne(NULL, q);
+
+	q->spinCount = spinCount;
+	q->yieldCount = yieldCount;
+
+	$(q, start);
+
+	criticalSection = 0;
+
+	for (size_t i = 0; i < lengthof(latencies); i++) {
+
+		CommandFence fence;
+		ck_assert_int_eq(true, $(q, enqueueWithFence, latencyCommand, (ident) (uintptr_t) CommandTime(), &fence));
+
+		$(q, waitForFence, fence);
+
+		const uint64_t idle = CommandTime() + 10000;
+		while (CommandTime() < idle) {
+			;
+		}
+	}
+
+	$(q, stop);
+
+	ck_assert_int_eq(lengthof(latencies), criticalSection);
+
+	qsort(latencies, lengthof(latencies), sizeof(uint64_t), compareLatencies);
+
+	const uint64_t p50 = latencies[lengthof(latencies) * 50 / 100];
+	const uint64_t p99 = latencies[lengthof(latencies) * 99 / 100];
+
+	ck_assert_int_le(p50, p99);
+
+	const CommandQueueStats stats = $(q, stats);
+	const size_t wakeups = stats.spinWakeups + stats.yieldWakeups + stats.parkWakeups;
+
+	ck_assert_int_gt(wakeups, 0);
+	ck_assert_int_le(wakeups, lengthof(latencies));
+
+	if (spinCount == 0 && yieldCount == 0) {
+		ck_assert_int_eq(0, stats.spinWakeups);
+		ck_assert_int_eq(0, stats.yieldWakeups);
+	}
+
+	printf("%s: p50 %luns, p99 %luns, %zu spin, %zu yield, %zu park wakeups, mean %luns\n",
+		   name, (unsigned long) p50, (unsigned long) p99,
+		   stats.spinWakeups, stats.yieldWakeups, stats.parkWakeups,
+		   (unsigned long) (stats.wakeupLatency / wakeups));
+
+	release(q);
+}
+
+START_TEST(wakeup) {
+
+	benchmark("park", 0, 0);
+	benchmark("spin", COMMAND_QUEUE_DEFAULT_SPIN_COUNT, COMMAND_QUEUE_DEFAULT_YIELD_COUNT);
+
+} END_TEST
+
 START_TEST(start) {
 
 	CommandQueue *q = $(alloc(CommandQueue), init);
@@ -156,9 +547,18 @@ int main(int argc, char **argv) {
 
 	tcase_add_test(tcase, enqueue);
 	tcase_add_test(tcase, dequeue);
+	tcase_add_test(tcase, dequeueBatch);
+	tcase_add_test(tcase, fence);
 	tcase_add_test(tcase, flush);
+	tcase_add_test(tcase, frames);
 	tcase_add_test(tcase, resize);
+	tcase_add_test(tcase, policyBlock);
+	tcase_add_test(tcase, policyBlockBatch);
+	tcase_add_test(tcase, policyFail);
+	tcase_add_test(tcase, policyGrow);
+	tcase_add_test(tcase, priority);
 	tcase_add_test(tcase, start);
+	tcase_add_test(tcase, wakeup);
 
 	Suite *suite = suite_create("CommandQueue");
 	suite_add_tcase(suite, tcase);
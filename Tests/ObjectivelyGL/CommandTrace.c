@@ -0,0 +1,206 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <unistd.h>
+
+#include "Test.h"
+
+typedef struct {
+	int a, b;
+} Payload;
+
+static int sum;
+
+static void setup(void) {
+	sum = 0;
+}
+
+static void teardown(void) {
+
+}
+
+static void command(ident data) {
+	sum++;
+}
+
+static void commandWithPayload(ident data) {
+	const Payload *payload = data;
+	sum += payload->a * payload->b;
+}
+
+static void undefinedCommand(ident data) {
+	sum += 1000;
+}
+
+START_TEST(record) {
+
+	CommandTrace *trace = $(alloc(CommandTrace), init);
+	ck_assert_ptr_ne(NULL, trace);
+
+	$(trace, defineCommand, "command", command, 0);
+	$(trace, defineCommand, "commandWithPayload", commandWithPayload, sizeof(Payload));
+
+	$(trace, record, command, NULL);
+	$(trace, record, commandWithPayload, &(Payload) { 2, 3 });
+	$(trace, record, undefinedCommand, NULL);
+	$(trace, recordFrame, 1);
+	$(trace, record, commandWithPayload, &(Payload) { 4, 5 });
+
+	ck_assert_int_eq(3, trace->count);
+	ck_assert_int_eq(1, trace->skipped);
+
+	const size_t length = sizeof(CommandTraceHeader)
+		+ sizeof(CommandTraceRecord) + sizeof("command")
+		+ sizeof(CommandTraceRecord) + sizeof("commandWithPayload")
+		+ 3 * sizeof(CommandTraceRecord) + 2 * sizeof(Payload)
+		+ sizeof(CommandTraceRecord) + sizeof(uint64_t);
+
+	ck_assert_int_eq(length, ((Data *) trace->data)->length);
+
+	ck_assert_int_eq(3, $(trace, replay));
+	ck_assert_int_eq(27, sum);
+
+	release(trace);
+
+} END_TEST
+
+START_TEST(replay) {
+
+	CommandQueue *queue = $(alloc(CommandQueue), init);
+	ck_assert_ptr_ne(NULL, queue);
+
+	CommandTrace *trace = $(alloc(CommandTrace), init);
+	ck_assert_ptr_ne(NULL, trace);
+
+	$(trace, defineCommand, "command", command, 0);
+	$(trace, defineCommand, "commandWithPayload", commandWithPayload, sizeof(Payload));
+
+	$(queue, record, trace);
+
+	$(queue, enqueue, command, NULL);
+	$(queue, enqueue, undefinedCommand, NULL);
+
+	CommandList *frame = $(queue, beginFrame);
+	$(frame, appendData, commandWithPayload, &(Payload) { 2, 3 }, sizeof(Payload));
+	$(frame, append, command, NULL);
+	$(queue, endFrame);
+
+	$(queue, flush);
+	$(queue, record, NULL);
+
+	$(queue, enqueue, command, NULL);
+	$(queue, flush);
+
+	ck_assert_int_eq(3, trace->count);
+	ck_assert_int_eq(1, trace->skipped);
+	ck_assert_int_eq(1009, sum);
+
+	char path[] = "/tmp/CommandTrace.XXXXXX";
+	const int fd = mkstemp(path);
+	ck_assert_int_ne(-1, fd);
+	close(fd);
+
+	ck_assert_int_eq(true, $(trace, writeToFile, path));
+
+	release(trace);
+	release(queue);
+
+	Data *data = $$(Data, dataWithContentsOfFile, path);
+	ck_assert_ptr_ne(NULL, data);
+
+	unlink(path);
+
+	trace = $(alloc(CommandTrace), initWithData, data);
+	ck_assert_ptr_ne(NULL, trace);
+
+	$(trace, defineCommand, "commandWithPayload", commandWithPayload, sizeof(Payload));
+	$(trace, defineCommand, "command", command, 0);
+
+	sum = 0;
+
+	ck_assert_int_eq(3, $(trace, replay));
+	ck_assert_int_eq(8, sum);
+
+	release(trace);
+	release(data);
+
+	data = $(alloc(Data), initWithBytes, (const uint8_t *) "garbage!", 8);
+	ck_assert_ptr_eq(NULL, $(alloc(CommandTrace), initWithData, data));
+
+	release(data);
+
+} END_TEST
+
+START_TEST(sparse) {
+
+	MutableData *data = $(alloc(MutableData), init);
+	ck_assert_ptr_ne(NULL, data);
+
+	const CommandTraceHeader header = { COMMAND_TRACE_MAGIC, COMMAND_TRACE_VERSION };
+	$(data, appendBytes, (const uint8_t *) &header, sizeof(header));
+
+	const CommandTraceRecord define = { .type = CommandTraceRecordDefine, .id = 60000, .size = sizeof("command") };
+	$(data, appendBytes, (const uint8_t *) &define, sizeof(define));
+	$(data, appendBytes, (const uint8_t *) "command", sizeof("command"));
+
+	const CommandTraceRecord defined = { .type = CommandTraceRecordCommand, .id = 60000 };
+	$(data, appendBytes, (const uint8_t *) &defined, sizeof(defined));
+
+	const CommandTraceRecord undefined = { .type = CommandTraceRecordCommand, .id = 7 };
+	$(data, appendBytes, (const uint8_t *) &undefined, sizeof(undefined));
+
+	CommandTrace *trace = $(alloc(CommandTrace), initWithData, (Data *) data);
+	ck_assert_ptr_ne(NULL, trace);
+
+	$(trace, defineCommand, "command", command, 0);
+
+	ck_assert_int_eq(1, $(trace, replay));
+	ck_assert_int_eq(1, sum);
+
+	release(trace);
+	release(data);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("CommandTrace");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, record);
+	tcase_add_test(tcase, replay);
+	tcase_add_test(tcase, sparse);
+
+	Suite *suite = suite_create("CommandTrace");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,193 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static DrawList *list;
+
+static Program *programs[2];
+static Buffer *buffer;
+static VertexArray *vertexArrays[2];
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	list = $(alloc(DrawList), init);
+	ck_assert_ptr_ne(NULL, list);
+
+	for (size_t i = 0; i < 2; i++) {
+		ProgramDescriptor descriptor = MakeProgramDescriptor(
+			MakeShaderDescriptor(GL_VERTEX_SHADER, "gouraud.vs.glsl"),
+			MakeShaderDescriptor(GL_FRAGMENT_SHADER, "gouraud.fs.glsl")
+		);
+
+		programs[i] = $(alloc(Program), initWithDescriptor, &descriptor);
+		ck_assert_ptr_ne(NULL, programs[i]);
+
+		FreeProgramDescriptor(&descriptor);
+	}
+
+	buffer = $(alloc(Buffer), initWithData, &MakeBufferData(GL_ARRAY_BUFFER, 3 * sizeof(vec3s), NULL, GL_STATIC_DRAW));
+	ck_assert_ptr_ne(NULL, buffer);
+
+	typedef struct {
+		vec3s position;
+	} Vertex;
+
+	const Attribute attributes[] = MakeAttributes(
+		MakeVertexAttributeVec3f(TagNone, 0, Vertex, position)
+	);
+
+	for (size_t i = 0; i < 2; i++) {
+		vertexArrays[i] = $(alloc(VertexArray), initWithAttributes, buffer, attributes);
+		ck_assert_ptr_ne(NULL, vertexArrays[i]);
+	}
+}
+
+static void teardown(void) {
+
+	for (size_t i = 0; i < 2; i++) {
+		programs[i] = release(programs[i]);
+		vertexArrays[i] = release(vertexArrays[i]);
+	}
+
+	buffer = release(buffer);
+	list = release(list);
+
+	destroyContext();
+}
+
+/**
+ * @return A DrawItem for a triangle with the given state.
+ */
+static DrawItem item(GLuint pass, size_t program, size_t vertexArray, float depth) {
+	return (DrawItem) {
+		.pass = pass,
+		.program = programs[program],
+		.vertexArray = vertexArrays[vertexArray],
+		.mesh = {
+			.type = GL_TRIANGLES,
+			.count = 3
+		},
+		.depth = depth
+	};
+}
+
+START_TEST(keyForItem) {
+
+	const DrawItem items[] = {
+		item(0, 0, 0, 1.f),
+		item(0, 0, 0, 2.f),
+		item(0, 0, 1, 0.f),
+		item(1, 0, 0, 0.f),
+		item(0, 1, 0, 1.f),
+	};
+
+	uint64_t keys[lengthof(items)];
+	for (size_t i = 0; i < lengthof(items); i++) {
+		keys[i] = $$(DrawList, keyForItem, &items[i]);
+	}
+
+	ck_assert(keys[0] < keys[1]);
+	ck_assert(keys[1] < keys[2]);
+	ck_assert(keys[2] < keys[3]);
+
+	ck_assert(keys[0] != keys[4]);
+	ck_assert(keys[0] == $$(DrawList, keyForItem, &items[0]));
+
+} END_TEST
+
+START_TEST(sort) {
+
+	const DrawItem items[] = {
+		item(1, 0, 0, 1.f),
+		item(0, 1, 1, 2.f),
+		item(0, 0, 1, 3.f),
+		item(0, 1, 1, 1.f),
+		item(0, 0, 0, 4.f),
+		item(0, 0, 1, 3.f),
+	};
+
+	for (size_t i = 0; i < lengthof(items); i++) {
+		$(list, append, &items[i]);
+	}
+
+	$(list, sort);
+
+	ck_assert_int_eq(lengthof(items), list->items->count);
+
+	const DrawItem *sorted = list->items->elements;
+
+	for (size_t i = 1; i < list->items->count; i++) {
+		ck_assert($$(DrawList, keyForItem, &sorted[i - 1]) <= $$(DrawList, keyForItem, &sorted[i]));
+	}
+
+	ck_assert_int_eq(1, sorted[5].pass);
+	ck_assert(sorted[3].program == sorted[4].program);
+	ck_assert(sorted[3].vertexArray == sorted[4].vertexArray);
+
+} END_TEST
+
+START_TEST(draw) {
+
+	for (size_t i = 0; i < 8; i++) {
+		const DrawItem it = item(0, i & 1, (i >> 1) & 1, (float) i);
+		$(list, append, &it);
+	}
+
+	$(list, draw);
+
+	ck_assert_int_eq(8, list->stats.draws);
+	ck_assert_int_eq(2 + 4, list->stats.changes);
+	ck_assert_int_eq(16 - 6, list->stats.elided);
+
+	$(list, reset);
+
+	ck_assert_int_eq(0, list->items->count);
+	ck_assert_int_eq(0, list->stats.draws);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("DrawList");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, keyForItem);
+	tcase_add_test(tcase, sort);
+	tcase_add_test(tcase, draw);
+
+	Suite *suite = suite_create("DrawList");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,262 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static FrameGraph *graph;
+
+static size_t executed[8];
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	graph = $(alloc(FrameGraph), init);
+	ck_assert_ptr_ne(NULL, graph);
+
+	memset(executed, 0, sizeof(executed));
+}
+
+static void teardown(void) {
+
+	graph = release(graph);
+
+	destroyContext();
+}
+
+/**
+ * @brief A FrameGraphPassFunction that counts its executions.
+ */
+static void function(FrameGraph *graph, ident data) {
+	executed[(intptr_t) data]++;
+}
+
+START_TEST(culling) {
+
+	const FrameGraphTextureDescriptor descriptor = MakeFrameGraphTextureDescriptor(64, 64, GL_RGBA8);
+
+	const FrameGraphResource a = $(graph, createTexture, "a", &descriptor);
+	const FrameGraphResource b = $(graph, createTexture, "b", &descriptor);
+	const FrameGraphResource c = $(graph, createTexture, "c", &descriptor);
+
+	const FrameGraphPass p0 = $(graph, addPass, "p0", function, (ident) 0, FrameGraphPassNone);
+	$(graph, write, p0, a, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p1 = $(graph, addPass, "p1", function, (ident) 1, FrameGraphPassNone);
+	$(graph, read, p1, a, FrameGraphAccessSampled);
+	$(graph, write, p1, b, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p2 = $(graph, addPass, "p2", function, (ident) 2, FrameGraphPassNone);
+	$(graph, read, p2, b, FrameGraphAccessSampled);
+	$(graph, write, p2, c, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p3 = $(graph, addPass, "p3", function, (ident) 3, FrameGraphPassSideEffects);
+	$(graph, read, p3, a, FrameGraphAccessSampled);
+
+	$(graph, execute);
+
+	ck_assert_int_eq(2, graph->stats.passes);
+	ck_assert_int_eq(2, graph->stats.culled);
+
+	ck_assert_int_eq(1, executed[0]);
+	ck_assert_int_eq(0, executed[1]);
+	ck_assert_int_eq(0, executed[2]);
+	ck_assert_int_eq(1, executed[3]);
+
+	$(graph, reset);
+
+	ck_assert_int_eq(0, graph->passes->count);
+	ck_assert_int_eq(0, graph->resources->count);
+	ck_assert_int_eq(1, graph->pool->targets->count);
+
+} END_TEST
+
+START_TEST(aliasing) {
+
+	const FrameGraphTextureDescriptor descriptor = MakeFrameGraphTextureDescriptor(64, 64, GL_RGBA8);
+
+	const FrameGraphResource a = $(graph, createTexture, "a", &descriptor);
+	const FrameGraphResource b = $(graph, createTexture, "b", &descriptor);
+	const FrameGraphResource c = $(graph, createTexture, "c", &descriptor);
+
+	const FrameGraphPass p0 = $(graph, addPass, "p0", function, (ident) 0, FrameGraphPassNone);
+	$(graph, write, p0, a, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p1 = $(graph, addPass, "p1", function, (ident) 1, FrameGraphPassNone);
+	$(graph, read, p1, a, FrameGraphAccessSampled);
+	$(graph, write, p1, b, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p2 = $(graph, addPass, "p2", function, (ident) 2, FrameGraphPassNone);
+	$(graph, read, p2, b, FrameGraphAccessSampled);
+	$(graph, write, p2, c, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p3 = $(graph, addPass, "p3", function, (ident) 3, FrameGraphPassSideEffects);
+	$(graph, read, p3, c, FrameGraphAccessSampled);
+
+	$(graph, execute);
+
+	ck_assert_int_eq(4, graph->stats.passes);
+	ck_assert_int_eq(2, graph->pool->targets->count);
+	ck_assert_int_lt(graph->stats.peakBytes, graph->stats.transientBytes);
+
+	ck_assert_ptr_eq(NULL, $(graph, textureForResource, a));
+
+	$(graph, reset);
+
+	const FrameGraphResource d = $(graph, createTexture, "d", &descriptor);
+
+	const FrameGraphPass p4 = $(graph, addPass, "p4", function, (ident) 4, FrameGraphPassSideEffects);
+	$(graph, write, p4, d, FrameGraphAccessAttachment);
+
+	$(graph, execute);
+
+	ck_assert_int_eq(1, executed[4]);
+	ck_assert_int_eq(2, graph->pool->targets->count);
+	ck_assert_int_eq(2, graph->pool->stats.recycles);
+
+} END_TEST
+
+START_TEST(barriers) {
+
+	Texture *texture = $(alloc(Texture), initWithStorage, &MakeTextureStorage2D(1, GL_RGBA8, 64, 64));
+	ck_assert_ptr_ne(NULL, texture);
+
+	const FrameGraphTextureDescriptor descriptor = MakeFrameGraphTextureDescriptor(64, 64, GL_RGBA8);
+
+	const FrameGraphResource a = $(graph, createTexture, "a", &descriptor);
+	const FrameGraphResource b = $(graph, importTexture, "b", texture);
+
+	const FrameGraphPass p0 = $(graph, addPass, "p0", function, (ident) 0, FrameGraphPassNone);
+	$(graph, write, p0, a, FrameGraphAccessImage);
+
+	const FrameGraphPass p1 = $(graph, addPass, "p1", function, (ident) 1, FrameGraphPassNone);
+	$(graph, read, p1, a, FrameGraphAccessSampled);
+	$(graph, write, p1, b, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p2 = $(graph, addPass, "p2", function, (ident) 2, FrameGraphPassNone);
+	$(graph, read, p2, a, FrameGraphAccessSampled);
+
+	$(graph, execute);
+
+	ck_assert_int_eq(2, graph->stats.passes);
+	ck_assert_int_eq(1, graph->stats.culled);
+	ck_assert_int_eq(glMemoryBarrier ? 1 : 0, graph->stats.barriers);
+
+	ck_assert_ptr_eq(texture, $(graph, textureForResource, b));
+
+	$(graph, reset);
+
+	texture = release(texture);
+
+} END_TEST
+
+START_TEST(ordering) {
+
+	const FrameGraphTextureDescriptor descriptor = MakeFrameGraphTextureDescriptor(64, 64, GL_RGBA8);
+
+	const FrameGraphResource a = $(graph, createTexture, "a", &descriptor);
+	const FrameGraphResource b = $(graph, createTexture, "b", &descriptor);
+
+	const FrameGraphPass p0 = $(graph, addPass, "p0", function, (ident) 0, FrameGraphPassSideEffects);
+	$(graph, read, p0, b, FrameGraphAccessSampled);
+
+	const FrameGraphPass p1 = $(graph, addPass, "p1", function, (ident) 1, FrameGraphPassNone);
+	$(graph, read, p1, a, FrameGraphAccessSampled);
+	$(graph, write, p1, b, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p2 = $(graph, addPass, "p2", function, (ident) 2, FrameGraphPassNone);
+	$(graph, write, p2, a, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p3 = $(graph, addPass, "p3", function, (ident) 3, FrameGraphPassSideEffects);
+
+	$(graph, execute);
+
+	ck_assert_int_eq(4, graph->stats.passes);
+	ck_assert_int_eq(4, graph->order->count);
+
+	ck_assert_int_eq(p2, *VectorElement(graph->order, FrameGraphPass, 0));
+	ck_assert_int_eq(p1, *VectorElement(graph->order, FrameGraphPass, 1));
+	ck_assert_int_eq(p0, *VectorElement(graph->order, FrameGraphPass, 2));
+	ck_assert_int_eq(p3, *VectorElement(graph->order, FrameGraphPass, 3));
+
+	ck_assert_ptr_eq(NULL, $(graph, textureForResource, a));
+	ck_assert_ptr_eq(NULL, $(graph, textureForResource, b));
+
+	$(graph, reset);
+
+} END_TEST
+
+START_TEST(cycle) {
+
+	const FrameGraphTextureDescriptor descriptor = MakeFrameGraphTextureDescriptor(64, 64, GL_RGBA8);
+
+	const FrameGraphResource t = $(graph, createTexture, "t", &descriptor);
+	const FrameGraphResource u = $(graph, createTexture, "u", &descriptor);
+
+	const FrameGraphPass p0 = $(graph, addPass, "p0", function, (ident) 0, FrameGraphPassSideEffects);
+	$(graph, read, p0, t, FrameGraphAccessSampled);
+	$(graph, write, p0, u, FrameGraphAccessAttachment);
+
+	const FrameGraphPass p1 = $(graph, addPass, "p1", function, (ident) 1, FrameGraphPassNone);
+	$(graph, read, p1, u, FrameGraphAccessSampled);
+	$(graph, write, p1, t, FrameGraphAccessAttachment);
+
+	$(graph, addPass, "p2", function, (ident) 2, FrameGraphPassSideEffects);
+
+	$(graph, execute);
+
+	ck_assert_int_eq(1, graph->stats.passes);
+	ck_assert_int_eq(2, graph->stats.culled);
+
+	ck_assert_int_eq(0, executed[0]);
+	ck_assert_int_eq(0, executed[1]);
+	ck_assert_int_eq(1, executed[2]);
+
+	$(graph, reset);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("FrameGraph");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, culling);
+	tcase_add_test(tcase, aliasing);
+	tcase_add_test(tcase, barriers);
+	tcase_add_test(tcase, ordering);
+	tcase_add_test(tcase, cycle);
+
+	Suite *suite = suite_create("FrameGraph");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
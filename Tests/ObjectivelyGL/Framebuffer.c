@@ -0,0 +1,111 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static Framebuffer *framebuffer;
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	framebuffer = $(alloc(Framebuffer), init);
+	ck_assert_ptr_ne(NULL, framebuffer);
+}
+
+static void teardown(void) {
+
+	framebuffer = release(framebuffer);
+
+	destroyContext();
+}
+
+START_TEST(attachTexture) {
+
+	Texture *texture = $(alloc(Texture), initWithStorage, &MakeTextureStorage2D(1, GL_RGBA8, 64, 64));
+	ck_assert_ptr_ne(NULL, texture);
+
+	$(framebuffer, attachTexture, GL_COLOR_ATTACHMENT0, texture, 0);
+	ck_assert_ptr_eq(texture, framebuffer->attachments[0]);
+
+	$(framebuffer, drawBuffers, 1, (const GLenum []) { GL_COLOR_ATTACHMENT0 });
+	ck_assert_int_eq(GL_FRAMEBUFFER_COMPLETE, $(framebuffer, checkStatus));
+
+	$(framebuffer, unbind, GL_FRAMEBUFFER);
+
+	texture = release(texture);
+	ck_assert_ptr_ne(NULL, framebuffer->attachments[0]);
+
+	$(framebuffer, detachAll);
+	ck_assert_ptr_eq(NULL, framebuffer->attachments[0]);
+
+} END_TEST
+
+START_TEST(attachRenderbuffer) {
+
+	Texture *texture = $(alloc(Texture), initWithStorage, &MakeTextureStorage2D(1, GL_RGBA8, 64, 64));
+	ck_assert_ptr_ne(NULL, texture);
+
+	Renderbuffer *renderbuffer = $(alloc(Renderbuffer), initWithStorage, &MakeRenderbufferStorage(GL_DEPTH24_STENCIL8, 64, 64, 0));
+	ck_assert_ptr_ne(NULL, renderbuffer);
+	ck_assert_int_eq(64 * 64 * 4, renderbuffer->size);
+
+	const GLenum attachment = $$(Framebuffer, attachmentForInternalFormat, GL_DEPTH24_STENCIL8);
+	ck_assert_int_eq(GL_DEPTH_STENCIL_ATTACHMENT, attachment);
+
+	$(framebuffer, attachTexture, GL_COLOR_ATTACHMENT0, texture, 0);
+	$(framebuffer, attachRenderbuffer, attachment, renderbuffer);
+
+	ck_assert_int_eq(GL_FRAMEBUFFER_COMPLETE, $(framebuffer, checkStatus));
+
+	$(framebuffer, attachRenderbuffer, attachment, NULL);
+	ck_assert_ptr_eq(NULL, framebuffer->attachments[FRAMEBUFFER_MAX_COLOR_ATTACHMENTS + 2]);
+
+	$(framebuffer, unbind, GL_FRAMEBUFFER);
+
+	texture = release(texture);
+	renderbuffer = release(renderbuffer);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("Framebuffer");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, attachTexture);
+	tcase_add_test(tcase, attachRenderbuffer);
+
+	Suite *suite = suite_create("Framebuffer");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
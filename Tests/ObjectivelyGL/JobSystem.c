@@ -0,0 +1,209 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <unistd.h>
+
+#include "Test.h"
+
+#define COUNT 100000
+
+static JobSystem *jobs;
+
+static size_t sum;
+
+static void setup(void) {
+	jobs = $(alloc(JobSystem), initWithThreads, 4);
+	sum = 0;
+}
+
+static void teardown(void) {
+	jobs = release(jobs);
+}
+
+static void increment(ident data) {
+	__atomic_add_fetch(&sum, 1, __ATOMIC_SEQ_CST);
+}
+
+static void square(size_t begin, size_t end, ident data) {
+
+	size_t *values = data;
+
+	for (size_t i = begin; i < end; i++) {
+		values[i] = i * i;
+	}
+}
+
+static void accumulate(size_t begin, size_t end, ident data) {
+
+	size_t total = 0;
+	for (size_t i = begin; i < end; i++) {
+		total += i;
+	}
+
+	__atomic_add_fetch(&sum, total, __ATOMIC_SEQ_CST);
+}
+
+static void nested(size_t begin, size_t end, ident data) {
+
+	for (size_t i = begin; i < end; i++) {
+		$(jobs, parallelFor, 1000, 10, accumulate, NULL);
+	}
+}
+
+START_TEST(parallelFor) {
+
+	size_t *values = calloc(COUNT, sizeof(size_t));
+
+	$(jobs, parallelFor, COUNT, 0, square, values);
+
+	for (size_t i = 0; i < COUNT; i++) {
+		ck_assert_int_eq(i * i, values[i]);
+	}
+
+	free(values);
+
+	$(jobs, parallelFor, COUNT, 1, accumulate, NULL);
+	ck_assert_int_eq((size_t) COUNT * (COUNT - 1) / 2, sum);
+
+	sum = 0;
+
+	$(jobs, parallelFor, 64, 1, nested, NULL);
+	ck_assert_int_eq(64 * 1000 * 999 / 2, sum);
+
+} END_TEST
+
+START_TEST(submit) {
+
+	JobCounter counter = { .value = 0 };
+
+	for (int i = 0; i < 1000; i++) {
+		$(jobs, submit, increment, NULL, &counter);
+	}
+
+	$(jobs, wait, &counter);
+
+	ck_assert_int_eq(0, counter.value);
+	ck_assert_int_eq(1000, sum);
+
+	$(jobs, wait, &counter);
+
+	release(jobs);
+
+	jobs = $(alloc(JobSystem), initWithThreads, 0);
+	ck_assert_ptr_ne(NULL, jobs);
+
+	$(jobs, submit, increment, NULL, &counter);
+	ck_assert_int_eq(1, counter.value);
+
+	$(jobs, wait, &counter);
+	ck_assert_int_eq(1001, sum);
+
+} END_TEST
+
+static JobCounter first, second;
+
+static void firstJob(ident data) {
+	__atomic_add_fetch(&sum, 1, __ATOMIC_SEQ_CST);
+}
+
+static void secondJob(ident data) {
+	ck_assert_int_eq(100, __atomic_load_n(&sum, __ATOMIC_SEQ_CST));
+	__atomic_add_fetch(&sum, 1000, __ATOMIC_SEQ_CST);
+}
+
+START_TEST(submitAfter) {
+
+	memset(&first, 0, sizeof(first));
+	memset(&second, 0, sizeof(second));
+
+	for (int i = 0; i < 100; i++) {
+		$(jobs, submit, firstJob, NULL, &first);
+	}
+
+	$(jobs, submitAfter, &first, secondJob, NULL, &second);
+
+	$(jobs, wait, &second);
+	ck_assert_int_eq(0, first.value);
+	ck_assert_int_eq(1100, sum);
+
+	$(jobs, submitAfter, &first, increment, NULL, &second);
+
+	$(jobs, wait, &second);
+	ck_assert_int_eq(1101, sum);
+
+} END_TEST
+
+static void slowJob(ident data) {
+	usleep(50000);
+	__atomic_add_fetch(&sum, 1, __ATOMIC_SEQ_CST);
+}
+
+START_TEST(wait) {
+
+	JobCounter counter = { .value = 0 };
+
+	for (int i = 0; i < 4; i++) {
+		$(jobs, submit, slowJob, NULL, &counter);
+	}
+
+	$(jobs, wait, &counter);
+
+	ck_assert_int_eq(0, counter.value);
+	ck_assert_int_eq(4, sum);
+	ck_assert_int_eq(0, jobs->waiting);
+
+} END_TEST
+
+START_TEST(sharedInstance) {
+
+	JobSystem *shared = $$(JobSystem, sharedInstance);
+	ck_assert_ptr_ne(NULL, shared);
+	ck_assert_ptr_eq(shared, $$(JobSystem, sharedInstance));
+	ck_assert(shared->threads > 0);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("JobSystem");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, parallelFor);
+	tcase_add_test(tcase, submit);
+	tcase_add_test(tcase, submitAfter);
+	tcase_add_test(tcase, wait);
+	tcase_add_test(tcase, sharedInstance);
+
+	Suite *suite = suite_create("JobSystem");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,184 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <unistd.h>
+
+#include "Test.h"
+
+static MemoryTracker *tracker;
+
+/**
+ * @brief The most recent budget notification.
+ */
+static struct {
+	size_t count;
+	MemoryCategory category;
+	GLsizeiptr bytes;
+	ident data;
+} notification;
+
+static void setup(void) {
+
+	tracker = $(alloc(MemoryTracker), init);
+	ck_assert_ptr_ne(NULL, tracker);
+
+	memset(&notification, 0, sizeof(notification));
+}
+
+static void teardown(void) {
+	tracker = release(tracker);
+}
+
+static void budgetExceeded(MemoryTracker *tracker, MemoryCategory category, GLsizeiptr bytes, ident data) {
+
+	notification.count++;
+	notification.category = category;
+	notification.bytes = bytes;
+	notification.data = data;
+}
+
+START_TEST(allocate) {
+
+	$(tracker, allocate, MemoryCategoryVertex, GL_NONE, 1024);
+	$(tracker, allocate, MemoryCategoryVertex, GL_NONE, 2048);
+	$(tracker, allocate, MemoryCategoryTexture, GL_RGBA8, 4096);
+	$(tracker, allocate, MemoryCategoryTexture, GL_R8, 256);
+
+	$(tracker, deallocate, MemoryCategoryVertex, GL_NONE, 2048);
+	$(tracker, deallocate, MemoryCategoryTexture, GL_RGBA8, 4096);
+
+	const MemorySnapshot snapshot = $(tracker, snapshot);
+
+	ck_assert_int_eq(1, snapshot.categories[MemoryCategoryVertex].count);
+	ck_assert_int_eq(1024, snapshot.categories[MemoryCategoryVertex].bytes);
+	ck_assert_int_eq(3072, snapshot.categories[MemoryCategoryVertex].peak);
+
+	ck_assert_int_eq(0, snapshot.categories[MemoryCategoryIndex].count);
+	ck_assert_int_eq(0, snapshot.categories[MemoryCategoryIndex].peak);
+
+	ck_assert_int_eq(1, snapshot.categories[MemoryCategoryTexture].count);
+	ck_assert_int_eq(256, snapshot.categories[MemoryCategoryTexture].bytes);
+	ck_assert_int_eq(4352, snapshot.categories[MemoryCategoryTexture].peak);
+
+	ck_assert_int_eq(2, snapshot.categories[MemoryCategoryAll].count);
+	ck_assert_int_eq(1280, snapshot.categories[MemoryCategoryAll].bytes);
+	ck_assert_int_eq(7424, snapshot.categories[MemoryCategoryAll].peak);
+
+	ck_assert_int_eq(2, snapshot.numFormats);
+	ck_assert_int_eq(GL_RGBA8, snapshot.formats[0].format);
+	ck_assert_int_eq(0, snapshot.formats[0].stats.bytes);
+	ck_assert_int_eq(4096, snapshot.formats[0].stats.peak);
+	ck_assert_int_eq(GL_R8, snapshot.formats[1].format);
+	ck_assert_int_eq(256, snapshot.formats[1].stats.bytes);
+
+} END_TEST
+
+START_TEST(setBudget) {
+
+	$(tracker, setBudget, MemoryCategoryTexture, 4096, budgetExceeded, tracker);
+
+	$(tracker, allocate, MemoryCategoryTexture, GL_RGBA8, 4096);
+	ck_assert_int_eq(0, notification.count);
+
+	$(tracker, allocate, MemoryCategoryVertex, GL_NONE, 4096);
+	ck_assert_int_eq(0, notification.count);
+
+	$(tracker, allocate, MemoryCategoryTexture, GL_RGBA8, 1);
+	ck_assert_int_eq(1, notification.count);
+	ck_assert_int_eq(MemoryCategoryTexture, notification.category);
+	ck_assert_int_eq(4097, notification.bytes);
+	ck_assert_ptr_eq(tracker, notification.data);
+
+	$(tracker, allocate, MemoryCategoryTexture, GL_RGBA8, 1);
+	ck_assert_int_eq(1, notification.count);
+
+	$(tracker, deallocate, MemoryCategoryTexture, GL_RGBA8, 1);
+	$(tracker, deallocate, MemoryCategoryTexture, GL_RGBA8, 1);
+	$(tracker, allocate, MemoryCategoryTexture, GL_RGBA8, 1);
+	ck_assert_int_eq(2, notification.count);
+
+	$(tracker, setBudget, MemoryCategoryAll, 10000, budgetExceeded, NULL);
+
+	$(tracker, allocate, MemoryCategoryIndex, GL_NONE, 2000);
+	ck_assert_int_eq(3, notification.count);
+	ck_assert_int_eq(MemoryCategoryAll, notification.category);
+	ck_assert_int_eq(10193, notification.bytes);
+
+	$(tracker, setBudget, MemoryCategoryAll, 0, NULL, NULL);
+
+	$(tracker, deallocate, MemoryCategoryIndex, GL_NONE, 2000);
+	$(tracker, allocate, MemoryCategoryIndex, GL_NONE, 2000);
+	ck_assert_int_eq(3, notification.count);
+
+} END_TEST
+
+START_TEST(writeReport) {
+
+	$(tracker, allocate, MemoryCategoryUniform, GL_NONE, 65536);
+	$(tracker, allocate, MemoryCategoryTexture, GL_RGBA8, 1024);
+
+	char path[] = "/tmp/MemoryTracker.XXXXXX";
+	const int fd = mkstemp(path);
+	ck_assert_int_ne(-1, fd);
+	close(fd);
+
+	ck_assert_int_eq(true, $(tracker, writeReport, path));
+
+	char report[2048] = "";
+
+	FILE *file = fopen(path, "r");
+	ck_assert_ptr_ne(NULL, file);
+	ck_assert(fread(report, 1, sizeof(report) - 1, file) > 0);
+	fclose(file);
+
+	unlink(path);
+
+	ck_assert(strstr(report, "uniform"));
+	ck_assert(strstr(report, "65536"));
+	ck_assert(strstr(report, "texture 0x8058"));
+	ck_assert(strstr(report, "66560"));
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("MemoryTracker");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, allocate);
+	tcase_add_test(tcase, setBudget);
+	tcase_add_test(tcase, writeReport);
+
+	Suite *suite = suite_create("MemoryTracker");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,156 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static Program *program;
+static StateCache *cache;
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	cache = $(alloc(StateCache), init);
+	ck_assert_ptr_ne(NULL, cache);
+
+	$(cache, makeCurrent);
+
+	ProgramDescriptor descriptor = MakeProgramDescriptor(
+		MakeShaderDescriptor(GL_VERTEX_SHADER, "gouraud.vs.glsl"),
+		MakeShaderDescriptor(GL_FRAGMENT_SHADER, "gouraud.fs.glsl")
+	);
+
+	program = $(alloc(Program), initWithDescriptor, &descriptor);
+	ck_assert_ptr_ne(NULL, program);
+
+	FreeProgramDescriptor(&descriptor);
+
+	$$(PipelineState, invalidate);
+}
+
+static void teardown(void) {
+
+	program = release(program);
+	cache = release(cache);
+
+	destroyContext();
+}
+
+START_TEST(pipelineStateWithDescriptor) {
+
+	PipelineDescriptor descriptor = MakePipelineDescriptor(program, NULL);
+	descriptor.depth.test = true;
+
+	PipelineState *a = $$(PipelineState, pipelineStateWithDescriptor, &descriptor);
+	ck_assert_ptr_ne(NULL, a);
+
+	PipelineState *b = $$(PipelineState, pipelineStateWithDescriptor, &descriptor);
+	ck_assert_ptr_eq(a, b);
+
+	descriptor.depth.func = GL_LEQUAL;
+
+	PipelineState *c = $$(PipelineState, pipelineStateWithDescriptor, &descriptor);
+	ck_assert_ptr_ne(a, c);
+	ck_assert(!$((Object *) a, isEqual, (Object *) c));
+
+	release(a);
+	release(b);
+	release(c);
+
+	PipelineState *d = $$(PipelineState, pipelineStateWithDescriptor, &descriptor);
+	ck_assert_ptr_ne(NULL, d);
+	ck_assert_int_eq(GL_LEQUAL, d->descriptor.depth.func);
+
+	release(d);
+
+} END_TEST
+
+START_TEST(apply) {
+
+	PipelineDescriptor descriptor = MakePipelineDescriptor(program, NULL);
+	descriptor.depth.test = true;
+
+	PipelineState *opaque = $$(PipelineState, pipelineStateWithDescriptor, &descriptor);
+
+	descriptor.depth.write = false;
+	descriptor.blend = MakeBlendStateAlpha(GL_SRC_ALPHA);
+
+	PipelineState *blended = $$(PipelineState, pipelineStateWithDescriptor, &descriptor);
+
+	ck_assert_int_lt(0, $(opaque, apply));
+	ck_assert_int_eq(GL_TRUE, glIsEnabled(GL_DEPTH_TEST));
+	ck_assert_int_eq(GL_FALSE, glIsEnabled(GL_BLEND));
+
+	ck_assert_int_eq(0, $(opaque, apply));
+
+	ck_assert_int_eq(3, $(blended, apply));
+	ck_assert_int_eq(GL_TRUE, glIsEnabled(GL_BLEND));
+
+	GLboolean depthWrite;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWrite);
+	ck_assert_int_eq(GL_FALSE, depthWrite);
+
+	ck_assert_int_eq(3, $(opaque, apply));
+	ck_assert_int_eq(GL_FALSE, glIsEnabled(GL_BLEND));
+
+	glEnable(GL_BLEND);
+	$(cache, invalidate);
+	$$(PipelineState, invalidate);
+
+	ck_assert_int_lt(3, $(opaque, apply));
+	ck_assert_int_eq(GL_FALSE, glIsEnabled(GL_BLEND));
+
+	$$(StateCache, currentUseProgram, 0);
+
+	ck_assert_int_eq(1, $(opaque, apply));
+
+	GLint name;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &name);
+	ck_assert_int_eq(program->name, name);
+
+	release(opaque);
+	release(blended);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("PipelineState");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, pipelineStateWithDescriptor);
+	tcase_add_test(tcase, apply);
+
+	Suite *suite = suite_create("PipelineState");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
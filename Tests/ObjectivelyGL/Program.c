@@ -231,6 +231,160 @@ START_TEST(link) {
 
 } END_TEST
 
+START_TEST(uniformHandleForName) {
+
+	ProgramDescriptor descriptor = MakeProgramDescriptor(
+		MakeShaderDescriptor(GL_VERTEX_SHADER, "gouraud.vs.glsl"),
+		MakeShaderDescriptor(GL_FRAGMENT_SHADER, "gouraud.fs.glsl")
+	);
+
+	Program *program = $(alloc(Program), initWithDescriptor, &descriptor);
+	ck_assert_ptr_ne(NULL, program);
+
+	FreeProgramDescriptor(&descriptor);
+
+	$(program, use);
+
+	const Variable *uniform = program->uniforms->elements;
+	for (size_t i = 0; i < program->uniforms->count; i++, uniform++) {
+		ck_assert_ptr_eq(uniform, $(program, uniformForName, uniform->name));
+
+		const UniformHandle handle = $(program, uniformHandleForName, uniform->name);
+		ck_assert_int_eq(i, handle.index);
+	}
+
+	const Variable *attribute = program->attributes->elements;
+	for (size_t i = 0; i < program->attributes->count; i++, attribute++) {
+		ck_assert_ptr_eq(attribute, $(program, attributeForName, attribute->name));
+	}
+
+	ck_assert_ptr_eq(NULL, $(program, uniformForName, "missing"));
+	ck_assert_int_eq(-1, $(program, uniformHandleForName, "missing").index);
+
+	const UniformHandle view = $(program, uniformHandleForName, "view");
+	ck_assert_int_ne(-1, view.index);
+
+	$(program, setUniformForHandle, view, &(vec3s) { 1, 2, 3 });
+
+	release(program);
+
+} END_TEST
+
+/**
+ * @return The uniform Variable for the given name, by linear search.
+ */
+static const Variable *linearUniformForName(const Program *program, const GLchar *name) {
+
+	const Variable *var = program->uniforms->elements;
+	for (size_t i = 0; i < program->uniforms->count; i++, var++) {
+		if (!strcmp(name, var->name)) {
+			return var;
+		}
+	}
+
+	return NULL;
+}
+
+START_TEST(setUniform) {
+
+	ProgramDescriptor descriptor = MakeProgramDescriptor(
+		MakeShaderDescriptor(GL_VERTEX_SHADER, "gouraud.vs.glsl"),
+		MakeShaderDescriptor(GL_FRAGMENT_SHADER, "gouraud.fs.glsl")
+	);
+
+	Program *program = $(alloc(Program), initWithDescriptor, &descriptor);
+	ck_assert_ptr_ne(NULL, program);
+
+	FreeProgramDescriptor(&descriptor);
+
+	$(program, use);
+
+	const Variable *view = $(program, uniformForName, "view");
+	ck_assert_ptr_ne(NULL, view);
+
+	$(program, setUniform, view, &(vec3s) { 1, 2, 3 });
+	$(program, setUniform, view, &(vec3s) { 1, 2, 3 });
+
+	ck_assert_int_eq(1, program->stats.uniformUpdates);
+	ck_assert_int_eq(1, program->stats.uniformsElided);
+
+	$(program, setUniform, view, &(vec3s) { 1, 2, 4 });
+
+	ck_assert_int_eq(2, program->stats.uniformUpdates);
+	ck_assert_int_eq(1, program->stats.uniformsElided);
+
+	glUniform3f(view->location, 0, 0, 0);
+	$(program, invalidateUniforms);
+
+	$(program, setUniform, view, &(vec3s) { 1, 2, 4 });
+
+	ck_assert_int_eq(3, program->stats.uniformUpdates);
+	ck_assert_int_eq(1, program->stats.uniformsElided);
+
+	release(program);
+
+} END_TEST
+
+START_TEST(benchmark) {
+
+	ProgramDescriptor descriptor = MakeProgramDescriptor(
+		MakeShaderDescriptor(GL_VERTEX_SHADER, "gouraud.vs.glsl"),
+		MakeShaderDescriptor(GL_FRAGMENT_SHADER, "gouraud.fs.glsl")
+	);
+
+	Program *program = $(alloc(Program), initWithDescriptor, &descriptor);
+	ck_assert_ptr_ne(NULL, program);
+
+	FreeProgramDescriptor(&descriptor);
+
+	$(program, use);
+
+	const GLchar *names[] = {
+		"light.position",
+		"light.ambient",
+		"light.diffuse",
+		"light.specular",
+		"view"
+	};
+
+	UniformHandle handles[lengthof(names)];
+	for (size_t i = 0; i < lengthof(names); i++) {
+		handles[i] = $(program, uniformHandleForName, names[i]);
+		ck_assert_int_ne(-1, handles[i].index);
+	}
+
+	const size_t count = 10000;
+
+	vec3s value = { { 1, 2, 3 } };
+
+	uint64_t start = CommandTime();
+	for (size_t i = 0; i < count; i++) {
+		value.x = i;
+		$(program, setUniform, linearUniformForName(program, names[i % lengthof(names)]), &value);
+	}
+	const uint64_t linear = CommandTime() - start;
+
+	start = CommandTime();
+	for (size_t i = 0; i < count; i++) {
+		value.x = i;
+		$(program, setUniformForName, names[i % lengthof(names)], &value);
+	}
+	const uint64_t hashed = CommandTime() - start;
+
+	start = CommandTime();
+	for (size_t i = 0; i < count; i++) {
+		value.x = i;
+		$(program, setUniformForHandle, handles[i % lengthof(names)], &value);
+	}
+	const uint64_t handle = CommandTime() - start;
+
+	printf("%zu uniforms: linear %luns, hashed %luns, handle %luns\n", count,
+		   (unsigned long) linear, (unsigned long) hashed, (unsigned long) handle);
+
+	release(program);
+
+} END_TEST
+
 int main(int argc, char **argv) {
 
 	TCase *tcase = tcase_create("Program");
@@ -245,6 +399,9 @@ int main(int argc, char **argv) {
 	tcase_add_test(tcase, initWithDescriptor_missing);
 	tcase_add_test(tcase, initWithDescriptor_syntaxError);
 	tcase_add_test(tcase, link);
+	tcase_add_test(tcase, uniformHandleForName);
+	tcase_add_test(tcase, setUniform);
+	tcase_add_test(tcase, benchmark);
 
 	Suite *suite = suite_create("Program");
 	suite_add_tcase(suite, tcase);
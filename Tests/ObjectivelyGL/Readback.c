@@ -0,0 +1,186 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Test.h"
+
+static void setup(void) {
+	createContext(3, 3);
+}
+
+static void teardown(void) {
+	destroyContext();
+}
+
+/**
+ * @brief The most recently delivered read.
+ */
+static struct {
+	size_t count;
+	GLubyte pixels[16];
+	ident data;
+} result;
+
+static void function(const ReadbackResult *read) {
+
+	ck_assert_int_eq(sizeof(result.pixels), read->size);
+
+	memcpy(result.pixels, read->pixels, read->size);
+	result.data = read->data;
+	result.count++;
+}
+
+static void clear(void) {
+
+	memset(&result, 0, sizeof(result));
+
+	glClearColor(1.0, 0.0, 0.0, 1.0);
+	glClear(GL_COLOR_BUFFER_BIT);
+}
+
+START_TEST(sizeOfRegion) {
+
+	ck_assert_int_eq(16, $$(Readback, sizeOfRegion, &MakeReadbackRegion(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE)));
+	ck_assert_int_eq(12, $$(Readback, sizeOfRegion, &MakeReadbackRegion(0, 0, 2, 2, GL_RGB, GL_UNSIGNED_BYTE)));
+	ck_assert_int_eq(16, $$(Readback, sizeOfRegion, &MakeReadbackRegion(0, 0, 2, 2, GL_DEPTH_COMPONENT, GL_FLOAT)));
+	ck_assert_int_eq(0, $$(Readback, sizeOfRegion, &MakeReadbackRegion(0, 0, 2, 2, GL_NONE, GL_FLOAT)));
+
+} END_TEST
+
+START_TEST(readPixels) {
+
+	Readback *readback = $(alloc(Readback), initWithSize, 16, 2, NULL);
+	ck_assert_ptr_ne(NULL, readback);
+
+	clear();
+
+	const ReadbackRegion region = MakeReadbackRegion(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE);
+
+	ck_assert($(readback, readPixels, &region, function, readback));
+	ck_assert($(readback, readPixels, &region, function, readback));
+	ck_assert(!$(readback, readPixels, &region, function, readback));
+
+	ck_assert_int_eq(2, readback->pending);
+	ck_assert_int_eq(1, readback->overruns);
+
+	ck_assert_int_eq(2, $(readback, wait));
+	ck_assert_int_eq(0, $(readback, poll));
+
+	ck_assert_int_eq(2, result.count);
+	ck_assert_ptr_eq(readback, result.data);
+
+	for (size_t i = 0; i < lengthof(result.pixels); i += 4) {
+		ck_assert_int_eq(0xff, result.pixels[i + 0]);
+		ck_assert_int_eq(0x00, result.pixels[i + 1]);
+		ck_assert_int_eq(0x00, result.pixels[i + 2]);
+		ck_assert_int_eq(0xff, result.pixels[i + 3]);
+	}
+
+	release(readback);
+
+} END_TEST
+
+START_TEST(queue) {
+
+	CommandQueue *queue = $(alloc(CommandQueue), init);
+	ck_assert_ptr_ne(NULL, queue);
+
+	$(queue, start);
+
+	Readback *readback = $(alloc(Readback), initWithSize, 16, READBACK_DEFAULT_BUFFERS, queue);
+	ck_assert_ptr_ne(NULL, readback);
+
+	clear();
+
+	for (size_t frame = 0; frame < 8; frame++) {
+
+		const ReadbackRegion region = MakeReadbackRegion(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE);
+		ck_assert($(readback, readPixels, &region, function, queue));
+
+		glFinish();
+
+		ck_assert_int_eq(1, $(readback, poll));
+	}
+
+	$(queue, waitUntilEmpty);
+
+	ck_assert_int_eq(8, result.count);
+	ck_assert_ptr_eq(queue, result.data);
+	ck_assert_int_eq(0xff, result.pixels[0]);
+
+	$(queue, stop);
+
+	release(readback);
+	release(queue);
+
+} END_TEST
+
+START_TEST(dropped) {
+
+	CommandQueue *queue = $(alloc(CommandQueue), initWithPolicy, CommandQueuePolicyFail, 4);
+	ck_assert_ptr_ne(NULL, queue);
+
+	Readback *readback = $(alloc(Readback), initWithSize, 16, 5, queue);
+	ck_assert_ptr_ne(NULL, readback);
+
+	clear();
+
+	const ReadbackRegion region = MakeReadbackRegion(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE);
+
+	for (size_t i = 0; i < 5; i++) {
+		ck_assert($(readback, readPixels, &region, function, queue));
+	}
+
+	ck_assert_int_eq(5, $(readback, wait));
+	ck_assert_int_eq(1, readback->overruns);
+
+	$(queue, flush);
+
+	ck_assert_int_eq(4, result.count);
+
+	release(readback);
+	release(queue);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("Readback");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, sizeOfRegion);
+	tcase_add_test(tcase, readPixels);
+	tcase_add_test(tcase, queue);
+	tcase_add_test(tcase, dropped);
+
+	Suite *suite = suite_create("Readback");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,156 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static RenderTargetPool *pool;
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	pool = $(alloc(RenderTargetPool), init);
+	ck_assert_ptr_ne(NULL, pool);
+}
+
+static void teardown(void) {
+
+	pool = release(pool);
+
+	destroyContext();
+}
+
+START_TEST(acquireTexture) {
+
+	const RenderTargetDescriptor color = MakeRenderTargetDescriptor(64, 64, GL_RGBA8, 0);
+	const RenderTargetDescriptor depth = MakeRenderTargetDescriptor(64, 64, GL_DEPTH_COMPONENT24, 0);
+
+	Texture *a = $(pool, acquireTexture, &color);
+	ck_assert_ptr_ne(NULL, a);
+
+	Texture *b = $(pool, acquireTexture, &color);
+	ck_assert_ptr_ne(NULL, b);
+	ck_assert_ptr_ne(a, b);
+
+	$(pool, relinquish, a);
+
+	Texture *c = $(pool, acquireTexture, &depth);
+	ck_assert_ptr_ne(a, c);
+
+	Texture *d = $(pool, acquireTexture, &color);
+	ck_assert_ptr_eq(a, d);
+
+	ck_assert_int_eq(3, pool->stats.allocations);
+	ck_assert_int_eq(1, pool->stats.recycles);
+	ck_assert_int_eq(3, pool->stats.acquired);
+	ck_assert_int_eq(a->size + b->size + c->size, pool->stats.bytes);
+
+	$(pool, relinquish, b);
+	$(pool, relinquish, c);
+	$(pool, relinquish, d);
+
+	ck_assert_int_eq(0, pool->stats.acquired);
+
+} END_TEST
+
+START_TEST(acquireRenderbuffer) {
+
+	const RenderTargetDescriptor single = MakeRenderTargetDescriptor(64, 64, GL_RGBA8, 0);
+	const RenderTargetDescriptor multi = MakeRenderTargetDescriptor(64, 64, GL_RGBA8, 4);
+
+	Renderbuffer *a = $(pool, acquireRenderbuffer, &multi);
+	ck_assert_ptr_ne(NULL, a);
+	ck_assert_int_eq(4, a->storage.samples);
+
+	$(pool, relinquish, a);
+
+	Renderbuffer *b = $(pool, acquireRenderbuffer, &single);
+	ck_assert_ptr_ne(a, b);
+
+	Texture *texture = $(pool, acquireTexture, &single);
+	ck_assert_ptr_ne(NULL, texture);
+
+	Renderbuffer *c = $(pool, acquireRenderbuffer, &multi);
+	ck_assert_ptr_eq(a, c);
+
+	ck_assert_int_eq(3, pool->stats.allocations);
+	ck_assert_int_eq(1, pool->stats.recycles);
+
+	$(pool, relinquish, b);
+	$(pool, relinquish, c);
+	$(pool, relinquish, texture);
+
+} END_TEST
+
+START_TEST(nextFrame) {
+
+	const RenderTargetDescriptor color = MakeRenderTargetDescriptor(64, 64, GL_RGBA8, 0);
+	const RenderTargetDescriptor depth = MakeRenderTargetDescriptor(64, 64, GL_DEPTH24_STENCIL8, 0);
+
+	Texture *texture = $(pool, acquireTexture, &color);
+	Renderbuffer *renderbuffer = $(pool, acquireRenderbuffer, &depth);
+
+	$(pool, relinquish, texture);
+
+	for (uint64_t i = 0; i < pool->maxIdleFrames; i++) {
+		$(pool, nextFrame);
+	}
+
+	ck_assert_int_eq(2, pool->targets->count);
+
+	$(pool, nextFrame);
+
+	ck_assert_int_eq(1, pool->targets->count);
+	ck_assert_int_eq(1, pool->stats.purges);
+	ck_assert_int_eq(renderbuffer->size, pool->stats.bytes);
+
+	$(pool, relinquish, renderbuffer);
+	$(pool, purge);
+
+	ck_assert_int_eq(0, pool->targets->count);
+	ck_assert_int_eq(0, pool->stats.bytes);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("RenderTargetPool");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, acquireTexture);
+	tcase_add_test(tcase, acquireRenderbuffer);
+	tcase_add_test(tcase, nextFrame);
+
+	Suite *suite = suite_create("RenderTargetPool");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
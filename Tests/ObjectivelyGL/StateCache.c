@@ -0,0 +1,211 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static StateCache *cache;
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	cache = $(alloc(StateCache), init);
+	ck_assert_ptr_ne(NULL, cache);
+
+	$(cache, makeCurrent);
+	ck_assert_ptr_eq(cache, $$(StateCache, currentCache));
+}
+
+static void teardown(void) {
+
+	cache = release(cache);
+	ck_assert_ptr_eq(NULL, $$(StateCache, currentCache));
+
+	destroyContext();
+}
+
+START_TEST(bindBuffer) {
+
+	Buffer *buffer = $(alloc(Buffer), init);
+	ck_assert_ptr_ne(NULL, buffer);
+
+	const StateCacheStats stats = cache->stats;
+
+	$(buffer, bind, GL_ARRAY_BUFFER);
+	$(buffer, bind, GL_ARRAY_BUFFER);
+	$(buffer, bind, GL_ARRAY_BUFFER);
+
+	ck_assert_int_eq(stats.calls + 1, cache->stats.calls);
+	ck_assert_int_eq(stats.elided + 2, cache->stats.elided);
+
+	GLint name;
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &name);
+	ck_assert_int_eq(buffer->name, name);
+
+	$(buffer, bind, GL_COPY_READ_BUFFER);
+	ck_assert_int_eq(stats.calls + 2, cache->stats.calls);
+
+	const GLuint released = buffer->name;
+	release(buffer);
+
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &name);
+	ck_assert_int_eq(0, name);
+
+	$(cache, bindBuffer, GL_ARRAY_BUFFER, 0);
+	ck_assert_int_eq(stats.elided + 3, cache->stats.elided);
+
+	$(cache, bindBuffer, GL_ARRAY_BUFFER, released);
+	ck_assert_int_eq(stats.calls + 3, cache->stats.calls);
+
+	$(cache, bindBuffer, GL_ARRAY_BUFFER, 0);
+
+} END_TEST
+
+START_TEST(bindTexture) {
+
+	const StateCacheStats stats = cache->stats;
+
+	$(cache, activeTexture, GL_TEXTURE0);
+	$(cache, bindTexture, GL_TEXTURE_2D, 0);
+
+	$(cache, activeTexture, GL_TEXTURE1);
+	$(cache, bindTexture, GL_TEXTURE_2D, 0);
+
+	$(cache, activeTexture, GL_TEXTURE0);
+	$(cache, bindTexture, GL_TEXTURE_2D, 0);
+
+	ck_assert_int_eq(stats.calls + 5, cache->stats.calls);
+	ck_assert_int_eq(stats.elided + 1, cache->stats.elided);
+
+} END_TEST
+
+START_TEST(bindVertexArray) {
+
+	Buffer *buffer = $(alloc(Buffer), init);
+	ck_assert_ptr_ne(NULL, buffer);
+
+	typedef struct {
+		vec3s position;
+	} Vertex;
+
+	const Attribute attributes[] = MakeAttributes(
+		MakeVertexAttributeVec3f(TagNone, 0, Vertex, position)
+	);
+
+	VertexArray *array = $(alloc(VertexArray), initWithAttributes, buffer, attributes);
+	ck_assert_ptr_ne(NULL, array);
+
+	$(array, bind);
+	$(buffer, bind, GL_ELEMENT_ARRAY_BUFFER);
+
+	$(array, unbind);
+
+	const StateCacheStats stats = cache->stats;
+
+	$(array, bind);
+	$(buffer, bind, GL_ELEMENT_ARRAY_BUFFER);
+
+	ck_assert_int_eq(stats.calls + 2, cache->stats.calls);
+	ck_assert_int_eq(stats.elided, cache->stats.elided);
+
+	GLint name;
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &name);
+	ck_assert_int_eq(buffer->name, name);
+
+	$(array, unbind);
+
+	release(array);
+	release(buffer);
+
+} END_TEST
+
+START_TEST(enable) {
+
+	const StateCacheStats stats = cache->stats;
+
+	$(cache, enable, GL_DEPTH_TEST);
+	$(cache, enable, GL_DEPTH_TEST);
+	ck_assert_int_eq(GL_TRUE, glIsEnabled(GL_DEPTH_TEST));
+
+	$(cache, disable, GL_DEPTH_TEST);
+	$(cache, disable, GL_DEPTH_TEST);
+	ck_assert_int_eq(GL_FALSE, glIsEnabled(GL_DEPTH_TEST));
+
+	ck_assert_int_eq(stats.calls + 2, cache->stats.calls);
+	ck_assert_int_eq(stats.elided + 2, cache->stats.elided);
+
+	glEnable(GL_DEPTH_TEST);
+	$(cache, invalidate);
+
+	$(cache, disable, GL_DEPTH_TEST);
+	ck_assert_int_eq(GL_FALSE, glIsEnabled(GL_DEPTH_TEST));
+	ck_assert_int_eq(stats.calls + 3, cache->stats.calls);
+
+} END_TEST
+
+START_TEST(currentSetEnabled) {
+
+	const StateCacheStats stats = cache->stats;
+
+	$$(StateCache, currentSetEnabled, GL_BLEND, true);
+	$$(StateCache, currentSetEnabled, GL_BLEND, true);
+	ck_assert_int_eq(GL_TRUE, glIsEnabled(GL_BLEND));
+
+	ck_assert_int_eq(stats.calls + 1, cache->stats.calls);
+	ck_assert_int_eq(stats.elided + 1, cache->stats.elided);
+
+	$$(StateCache, makeCurrent, NULL);
+
+	$$(StateCache, currentSetEnabled, GL_BLEND, false);
+	ck_assert_int_eq(GL_FALSE, glIsEnabled(GL_BLEND));
+	ck_assert_int_eq(stats.calls + 1, cache->stats.calls);
+
+	$(cache, makeCurrent);
+	$(cache, invalidate);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("StateCache");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, bindBuffer);
+	tcase_add_test(tcase, bindTexture);
+	tcase_add_test(tcase, bindVertexArray);
+	tcase_add_test(tcase, enable);
+	tcase_add_test(tcase, currentSetEnabled);
+
+	Suite *suite = suite_create("StateCache");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
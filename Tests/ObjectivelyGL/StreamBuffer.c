@@ -0,0 +1,151 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Test.h"
+
+static void setup(void) {
+	createContext(3, 3);
+}
+
+static void teardown(void) {
+	destroyContext();
+}
+
+START_TEST(initWithSize) {
+
+	StreamBuffer *buffer = $(alloc(StreamBuffer), initWithSize, GL_ARRAY_BUFFER, 1000, 3);
+	if (glBufferStorage == NULL) {
+		ck_assert_ptr_eq(NULL, buffer);
+		return;
+	}
+
+	ck_assert_ptr_ne(NULL, buffer);
+	ck_assert_int_ne(0, buffer->buffer.name);
+	ck_assert_int_eq(1024, buffer->regionSize);
+	ck_assert_int_eq(3 * 1024, buffer->buffer.size);
+	ck_assert_ptr_ne(NULL, buffer->mapping);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(allocate) {
+
+	StreamBuffer *buffer = $(alloc(StreamBuffer), initWithSize, GL_ARRAY_BUFFER, 1024, 2);
+	if (buffer == NULL) {
+		return;
+	}
+
+	$(buffer, beginFrame);
+
+	StreamAllocation a = $(buffer, allocate, 10, 4);
+	ck_assert_ptr_ne(NULL, a.pointer);
+	ck_assert_int_eq(0, a.offset);
+
+	StreamAllocation b = $(buffer, allocate, 100, 64);
+	ck_assert_ptr_ne(NULL, b.pointer);
+	ck_assert_int_eq(64, b.offset);
+	ck_assert_ptr_eq((GLubyte *) a.pointer + 64, b.pointer);
+
+	StreamAllocation c = $(buffer, allocate, 1024, 4);
+	ck_assert_ptr_eq(NULL, c.pointer);
+
+	$(buffer, endFrame);
+	ck_assert_int_eq(1, buffer->frame);
+
+	$(buffer, beginFrame);
+
+	a = $(buffer, allocate, 1024, 4);
+	ck_assert_ptr_ne(NULL, a.pointer);
+	ck_assert_int_eq(1024, a.offset);
+
+	$(buffer, endFrame);
+	ck_assert_int_eq(0, buffer->frame);
+
+	$(buffer, beginFrame);
+
+	a = $(buffer, allocate, 16, 16);
+	ck_assert_int_eq(0, a.offset);
+
+	$(buffer, endFrame);
+
+	release(buffer);
+
+} END_TEST
+
+START_TEST(draw) {
+
+	StreamBuffer *buffer = $(alloc(StreamBuffer), initWithSize, GL_ARRAY_BUFFER, 1024, 3);
+	if (buffer == NULL) {
+		return;
+	}
+
+	const GLfloat vertex[] = { 0.0, 0.0, 0.0, 0.0, 1.0, 0.0 };
+
+	for (int i = 0; i < 10; i++) {
+
+		$(buffer, beginFrame);
+
+		StreamAllocation allocation = $(buffer, allocate, sizeof(vertex), sizeof(GLfloat));
+		ck_assert_ptr_ne(NULL, allocation.pointer);
+
+		memcpy(allocation.pointer, vertex, sizeof(vertex));
+
+		$((Buffer *) buffer, bind, GL_COPY_READ_BUFFER);
+
+		GLfloat readback[6];
+		glGetBufferSubData(GL_COPY_READ_BUFFER, allocation.offset, sizeof(readback), readback);
+		ck_assert(memcmp(vertex, readback, sizeof(vertex)) == 0);
+
+		$((Buffer *) buffer, unbind, GL_COPY_READ_BUFFER);
+
+		$(buffer, endFrame);
+	}
+
+	glFinish();
+
+	release(buffer);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("StreamBuffer");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, initWithSize);
+	tcase_add_test(tcase, allocate);
+	tcase_add_test(tcase, draw);
+
+	Suite *suite = suite_create("StreamBuffer");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,149 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static SDL_GLContext shared;
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+	shared = SDL_GL_CreateContext(window);
+	ck_assert_ptr_ne(NULL, shared);
+
+	SDL_GL_MakeCurrent(window, context);
+}
+
+static void teardown(void) {
+
+	SDL_GL_DeleteContext(shared);
+
+	destroyContext();
+}
+
+static void makeCurrent(ident data) {
+	SDL_GL_MakeCurrent(window, data);
+}
+
+START_TEST(writeBufferData) {
+
+	UploadQueue *queue = $(alloc(UploadQueue), initWithContext, makeCurrent, shared);
+	ck_assert_ptr_ne(NULL, queue);
+
+	$((CommandQueue *) queue, start);
+
+	Buffer *buffer = $(alloc(Buffer), init);
+	ck_assert_ptr_ne(NULL, buffer);
+
+	const GLfloat vertex[] = { 0.0, 0.0, 0.0, 0.0, 1.0, 0.0 };
+	const BufferData data = MakeBufferData(GL_ARRAY_BUFFER, sizeof(vertex), vertex, GL_STATIC_DRAW);
+
+	Upload *upload = $(queue, writeBufferData, buffer, &data);
+	ck_assert_ptr_ne(NULL, upload);
+	ck_assert_ptr_eq(buffer, upload->resource);
+
+	$(upload, wait);
+	glFinish();
+
+	ck_assert_int_eq(true, $(upload, isComplete));
+	ck_assert_int_eq(sizeof(vertex), buffer->size);
+
+	GLfloat result[lengthof(vertex)];
+
+	$(buffer, bind, GL_ARRAY_BUFFER);
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(result), result);
+	$(buffer, unbind, GL_ARRAY_BUFFER);
+
+	ck_assert_int_eq(0, memcmp(vertex, result, sizeof(vertex)));
+
+	$((CommandQueue *) queue, stop);
+
+	release(upload);
+	release(buffer);
+	release(queue);
+
+} END_TEST
+
+START_TEST(writeTextureData) {
+
+	UploadQueue *queue = $(alloc(UploadQueue), initWithContext, makeCurrent, shared);
+	ck_assert_ptr_ne(NULL, queue);
+
+	$((CommandQueue *) queue, start);
+
+	Texture *texture = $(alloc(Texture), init);
+	ck_assert_ptr_ne(NULL, texture);
+
+	const GLubyte pixels[] = {
+		0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff,
+		0x00, 0xff, 0x00, 0xff, 0x00, 0x00, 0xff, 0xff
+	};
+	const TextureData data = MakeTextureData2D_RGBA(2, 2, (ident) pixels);
+
+	Upload *upload = $(queue, writeTextureData, texture, &data);
+	ck_assert_ptr_ne(NULL, upload);
+
+	$(upload, wait);
+	glFinish();
+
+	ck_assert_int_eq(true, $(upload, isComplete));
+
+	GLubyte result[lengthof(pixels)];
+
+	$(texture, bind, GL_TEXTURE_2D);
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, result);
+	$(texture, unbind, GL_TEXTURE_2D);
+
+	ck_assert_int_eq(0, memcmp(pixels, result, sizeof(pixels)));
+
+	$((CommandQueue *) queue, stop);
+
+	release(upload);
+	release(texture);
+	release(queue);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("UploadQueue");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, writeBufferData);
+	tcase_add_test(tcase, writeTextureData);
+
+	Suite *suite = suite_create("UploadQueue");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}
@@ -0,0 +1,157 @@
+/*
+ * ObjectivelyGL: Object oriented OpenGL framework for GNU C.
+ * Copyright (C) 2014 Jay Dolan <jay@jaydolan.com>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "Test.h"
+
+static Validator *validator;
+
+/**
+ * @brief The messages received by the ValidatorFunction.
+ */
+static struct {
+	size_t count;
+	GLenum type;
+	ident data;
+} messages;
+
+static void setup(void) {
+
+	createContext(3, 3);
+
+	validator = $(alloc(Validator), init);
+	ck_assert_ptr_ne(NULL, validator);
+
+	memset(&messages, 0, sizeof(messages));
+}
+
+static void teardown(void) {
+
+	$(validator, setEnabled, false);
+	validator = release(validator);
+
+	destroyContext();
+}
+
+static void function(const Validator *validator, const ValidatorMessage *message, ident data) {
+
+	messages.count++;
+	messages.type = message->type;
+	messages.data = data;
+}
+
+START_TEST(checkErrors) {
+
+	validator->function = function;
+	validator->data = validator;
+
+	ck_assert_int_eq(0, $(validator, checkErrors));
+
+	glBindBuffer(GL_NONE, 0);
+
+	ck_assert_int_eq(1, $(validator, checkErrors));
+	ck_assert_int_eq(1, validator->stats.errors);
+	ck_assert_int_eq(2, validator->stats.checks);
+
+	ck_assert_int_eq(1, messages.count);
+	ck_assert_int_eq(GL_DEBUG_TYPE_ERROR, messages.type);
+	ck_assert_ptr_eq(validator, messages.data);
+
+} END_TEST
+
+START_TEST(endFrame) {
+
+	validator->function = function;
+
+	glBindBuffer(GL_NONE, 0);
+	$(validator, endFrame);
+
+	ck_assert_int_eq(0, messages.count);
+	ck_assert_int_eq(0, validator->stats.checks);
+	ck_assert_int_ne(GL_NO_ERROR, glGetError());
+
+	$(validator, setEnabled, true);
+	ck_assert(validator->enabled);
+
+	glBindBuffer(GL_NONE, 0);
+	$(validator, endFrame);
+
+	ck_assert_int_le(1, messages.count);
+	ck_assert_int_le(1, validator->stats.errors);
+	ck_assert_int_eq(GL_NO_ERROR, glGetError());
+
+	$(validator, setEnabled, false);
+	ck_assert(!validator->enabled);
+	ck_assert(!validator->debugOutput);
+
+	const size_t count = messages.count;
+
+	glBindBuffer(GL_NONE, 0);
+	$(validator, endFrame);
+
+	ck_assert_int_eq(count, messages.count);
+	ck_assert_int_ne(GL_NO_ERROR, glGetError());
+
+} END_TEST
+
+START_TEST(dealloc) {
+
+	$(validator, setEnabled, true);
+	ck_assert(validator->enabled);
+
+	validator = release(validator);
+
+	if (glDebugMessageCallback) {
+		ck_assert_int_eq(GL_FALSE, glIsEnabled(GL_DEBUG_OUTPUT));
+
+		ident callback;
+		glGetPointerv(GL_DEBUG_CALLBACK_FUNCTION, &callback);
+		ck_assert_ptr_eq(NULL, callback);
+	}
+
+	validator = $(alloc(Validator), init);
+	ck_assert_ptr_ne(NULL, validator);
+
+} END_TEST
+
+int main(int argc, char **argv) {
+
+	TCase *tcase = tcase_create("Validator");
+	tcase_add_checked_fixture(tcase, setup, teardown);
+
+	tcase_add_test(tcase, checkErrors);
+	tcase_add_test(tcase, endFrame);
+	tcase_add_test(tcase, dealloc);
+
+	Suite *suite = suite_create("Validator");
+	suite_add_tcase(suite, tcase);
+
+	SRunner *runner = srunner_create(suite);
+
+	srunner_run_all(runner, CK_VERBOSE);
+	int failed = srunner_ntests_failed(runner);
+
+	srunner_free(runner);
+
+	return failed;
+}